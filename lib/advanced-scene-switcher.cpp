@@ -231,6 +231,12 @@ void SwitcherData::Thread()
 	auto endTime = std::chrono::high_resolution_clock::now();
 	switcher->firstIntervalAfterStop = true;
 
+	{
+		// Further updates are triggered by scene changes
+		std::lock_guard<std::mutex> lock(m);
+		writeSceneInfoToFile();
+	}
+
 	while (true) {
 		std::unique_lock<std::mutex> lock(m);
 		mainLoopLock = &lock;
@@ -262,13 +268,15 @@ void SwitcherData::Thread()
 		vblog(LOG_INFO, "try to sleep for %ld",
 		      (long int)duration.count());
 		SetWaitScene();
-		cv.wait_for(lock, duration);
+		cv.wait_for(lock, duration,
+			    [this]() { return stop || checkRequested; });
+		checkRequested = false;
 
 		startTime = std::chrono::high_resolution_clock::now();
 		sleep = 0;
 		linger = 0;
 
-		Prune();
+		PruneIfRequired();
 		if (stop) {
 			break;
 		}
@@ -290,7 +298,12 @@ void SwitcherData::Thread()
 			      (long int)duration.count());
 
 			SetWaitScene();
-			cv.wait_for(lock, duration);
+			// Only stop lingering if the scene was changed, as the
+			// main loop might also be woken up to check the macro
+			// conditions early
+			cv.wait_for(lock, duration, [this]() {
+				return stop || SceneChangedDuringWait();
+			});
 
 			if (stop) {
 				break;
@@ -317,7 +330,6 @@ void SwitcherData::Thread()
 			}
 		}
 
-		writeSceneInfoToFile();
 		switcher->firstInterval = false;
 		switcher->firstIntervalAfterStop = false;
 	}
@@ -449,12 +461,13 @@ void SwitcherData::Start()
 		ResetMacros();
 		AutoStartActionQueues();
 
+		// Will be overwritten quickly but might be useful
+		writeToStatusFile("Advanced Scene Switcher running");
+
 		stop = false;
 		th = new SwitcherThread();
 		th->start((QThread::Priority)threadPriority);
 
-		// Will be overwritten quickly but might be useful
-		writeToStatusFile("Advanced Scene Switcher running");
 		SendWebsocketVendorEvent("AdvancedSceneSwitcherStarted",
 					 nullptr);
 	}
@@ -541,7 +554,7 @@ static void handleSceneChange()
 {
 	// Stop waiting if scene was changed
 	if (switcher->SceneChangedDuringWait()) {
-		switcher->cv.notify_one();
+		RequestMacroCheck();
 	}
 
 	// Set current and previous scene
@@ -558,6 +571,10 @@ static void handleSceneChange()
 	}
 
 	switcher->checkDefaultSceneTransitions();
+
+	if (switcher->th && switcher->th->isRunning()) {
+		switcher->writeSceneInfoToFile();
+	}
 }
 
 static void setLiveTime()
@@ -678,6 +695,11 @@ static void OBSEvent(enum obs_frontend_event event, void *switcher)
 	case OBS_FRONTEND_EVENT_TRANSITION_STOPPED:
 		handleTransitionEnd();
 		break;
+	case OBS_FRONTEND_EVENT_TRANSITION_LIST_CHANGED:
+		// Transitions are private sources, so their removal will not be
+		// reported by the "source_remove" signal
+		static_cast<SwitcherData *>(switcher)->RequestPrune();
+		break;
 #if LIBOBS_API_VER >= MAKE_SEMANTIC_VERSION(27, 2, 0)
 	case OBS_FRONTEND_EVENT_SCENE_COLLECTION_CHANGING:
 		handleSceneCollectionChanging();
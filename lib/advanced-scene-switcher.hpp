@@ -319,6 +319,8 @@ public slots:
 	void on_readFileCheckBox_stateChanged(int state);
 	void on_readPathLineEdit_textChanged(const QString &text);
 	void on_writePathLineEdit_textChanged(const QString &text);
+	void on_writePathLineEdit_editingFinished();
+	void on_writeFormat_currentIndexChanged(int index);
 	void on_browseButton_2_clicked();
 
 	// Media tab
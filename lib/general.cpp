@@ -13,6 +13,7 @@
 #include "ui-helpers.hpp"
 #include "utility.hpp"
 #include "variable.hpp"
+#include "variable-journal.hpp"
 #include "version.h"
 
 #include <obs-frontend-api.h>
@@ -345,7 +346,7 @@ void AdvSceneSwitcher::on_importSettings_clicked()
 	}
 
 	std::lock_guard<std::mutex> lock(switcher->m);
-	switcher->LoadSettings(obj);
+	switcher->LoadSettings(obj, true);
 	switcher->lastImportPath = path.toStdString();
 
 	(void)DisplayMessage(obs_module_text(
@@ -426,7 +427,7 @@ void AdvSceneSwitcher::on_adjustActiveTransitionType_stateChanged(int state)
 	switcher->adjustActiveTransitionType = state;
 }
 
-void SwitcherData::LoadSettings(obs_data_t *obj)
+void SwitcherData::LoadSettings(obs_data_t *obj, bool isImport)
 {
 	if (!obj) {
 		return;
@@ -434,11 +435,13 @@ void SwitcherData::LoadSettings(obs_data_t *obj)
 
 	// New post load steps to be declared during load
 	postLoadSteps.clear();
+	RequestPrune();
 
 	// Needs to be loaded before any entries which might rely on scene group
 	// selections to be available.
 	loadSceneGroups(obj);
 	LoadVariables(obj);
+	VariableJournal::Instance().Load(obj, isImport);
 
 	for (const auto &func : loadSteps) {
 		func(obj);
@@ -479,6 +482,7 @@ void SwitcherData::SaveSettings(obs_data_t *obj)
 	saveSceneGroups(obj);
 	SaveMacros(obj);
 	SaveGlobalMacroSettings(obj);
+	VariableJournal::Instance().Save(obj);
 	SaveVariables(obj);
 	saveWindowTitleSwitches(obj);
 	saveScreenRegionSwitches(obj);
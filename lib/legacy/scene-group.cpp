@@ -193,6 +193,7 @@ void AdvSceneSwitcher::on_sceneGroupRemove_clicked()
 		auto &sg = switcher->sceneGroups;
 		name = QString::fromStdString(sg[idx].name);
 		sg.erase(sg.begin() + idx);
+		switcher->RequestPrune();
 	}
 
 	delete item;
@@ -1,5 +1,6 @@
 #include "advanced-scene-switcher.hpp"
 #include "curl-helper.hpp"
+#include "frontend-state.hpp"
 #include "layout-helpers.hpp"
 #include "source-helpers.hpp"
 #include "switcher-data.hpp"
@@ -9,6 +10,7 @@
 #include <obs-frontend-api.h>
 #include <QtGlobal>
 #include <QFileDialog>
+#include <QSaveFile>
 #include <QTextStream>
 #include <QDateTime>
 #include <functional>
@@ -21,6 +23,16 @@ bool FileSwitch::pause = false;
 static QObject *addPulse = nullptr;
 static std::hash<std::string> strHash;
 
+// Otherwise the status file would only be written to the new path or in the
+// new format once the scene changes the next time
+static void writeSceneInfoToNewStatusFile()
+{
+	std::lock_guard<std::mutex> lock(switcher->m);
+	if (switcher->th && switcher->th->isRunning()) {
+		switcher->writeSceneInfoToFile();
+	}
+}
+
 void AdvSceneSwitcher::on_browseButton_clicked()
 {
 	QString path = QFileDialog::getOpenFileName(
@@ -30,6 +42,7 @@ void AdvSceneSwitcher::on_browseButton_clicked()
 		tr(obs_module_text("AdvSceneSwitcher.fileTab.textFileType")));
 	if (!path.isEmpty()) {
 		ui->writePathLineEdit->setText(path);
+		writeSceneInfoToNewStatusFile();
 	}
 }
 
@@ -83,6 +96,31 @@ void AdvSceneSwitcher::on_writePathLineEdit_textChanged(const QString &text)
 	switcher->fileIO.writePath = text.toUtf8().constData();
 }
 
+void AdvSceneSwitcher::on_writePathLineEdit_editingFinished()
+{
+	if (loading) {
+		return;
+	}
+
+	// The file is not written while the path is still being typed to
+	// avoid creating files for each incomplete path
+	writeSceneInfoToNewStatusFile();
+}
+
+void AdvSceneSwitcher::on_writeFormat_currentIndexChanged(int index)
+{
+	if (loading) {
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(switcher->m);
+		switcher->fileIO.writeFormat =
+			static_cast<StatusFileWriter::Format>(index);
+	}
+	writeSceneInfoToNewStatusFile();
+}
+
 void AdvSceneSwitcher::on_browseButton_2_clicked()
 {
 	QString path = QFileDialog::getOpenFileName(
@@ -95,22 +133,138 @@ void AdvSceneSwitcher::on_browseButton_2_clicked()
 	}
 }
 
+StatusFileWriter::~StatusFileWriter()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop = true;
+	}
+	_cv.notify_all();
+	if (_thread.joinable()) {
+		_thread.join();
+	}
+}
+
+static std::string currentTimestamp()
+{
+	return QDateTime::currentDateTime()
+		.toString(Qt::ISODateWithMs)
+		.toStdString();
+}
+
+void StatusFileWriter::WriteScene(const std::string &path, Format format,
+				  const std::string &scene,
+				  const std::string &previousScene,
+				  const std::string &transition)
+{
+	if (!SceneChanged(path, format, scene)) {
+		return;
+	}
+
+	if (format == Format::PLAIN) {
+		Queue(path, scene);
+		return;
+	}
+
+	OBSDataAutoRelease data = obs_data_create();
+	obs_data_set_string(data, "scene", scene.c_str());
+	obs_data_set_string(data, "previousScene", previousScene.c_str());
+	obs_data_set_string(data, "transition", transition.c_str());
+	obs_data_set_string(data, "timestamp", currentTimestamp().c_str());
+	Queue(path, obs_data_get_json(data));
+}
+
+void StatusFileWriter::WriteStatus(const std::string &path, Format format,
+				   const std::string &status)
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_sceneWritten = false;
+	}
+
+	if (format == Format::PLAIN) {
+		Queue(path, status + "\n");
+		return;
+	}
+
+	OBSDataAutoRelease data = obs_data_create();
+	obs_data_set_string(data, "status", status.c_str());
+	obs_data_set_string(data, "timestamp", currentTimestamp().c_str());
+	Queue(path, obs_data_get_json(data));
+}
+
+bool StatusFileWriter::SceneChanged(const std::string &path, Format format,
+				    const std::string &scene)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (_sceneWritten && path == _lastPath && format == _lastFormat &&
+	    scene == _lastScene) {
+		return false;
+	}
+	_sceneWritten = true;
+	_lastPath = path;
+	_lastFormat = format;
+	_lastScene = scene;
+	return true;
+}
+
+void StatusFileWriter::Queue(const std::string &path,
+			     const std::string &content)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_pending = Request{path, content};
+	if (!_thread.joinable()) {
+		_thread = std::thread(&StatusFileWriter::Thread, this);
+	}
+	_cv.notify_one();
+}
+
+void StatusFileWriter::Thread()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (true) {
+		_cv.wait(lock, [this]() { return _stop || _pending; });
+		// Finish the last pending write to not lose the final status
+		if (!_pending) {
+			return;
+		}
+
+		auto request = std::move(*_pending);
+		_pending.reset();
+		lock.unlock();
+
+		// QSaveFile writes to a temporary file first, which is then
+		// renamed to the target path on commit
+		QSaveFile file(QString::fromStdString(request.path));
+		if (!file.open(QIODevice::WriteOnly) ||
+		    file.write(request.content.c_str(),
+			       request.content.size()) < 0 ||
+		    !file.commit()) {
+			blog(LOG_WARNING, "failed to write status file \"%s\"",
+			     request.path.c_str());
+		}
+
+		lock.lock();
+	}
+}
+
 void SwitcherData::writeSceneInfoToFile()
 {
 	if (!fileIO.writeEnabled || fileIO.writePath.empty()) {
 		return;
 	}
 
-	QFile file(QString::fromStdString(fileIO.writePath));
-	if (file.open(QIODevice::WriteOnly)) {
-		// switcher->currentScene cannot be used here as scene might
-		// have changed already
-		obs_source_t *source = obs_frontend_get_current_scene();
-		auto msg = obs_source_get_name(source);
-		obs_source_release(source);
-		file.write(msg, qstrlen(msg));
-		file.close();
+	// switcher->currentScene cannot be used here as scene might
+	// have changed already
+	OBSSourceAutoRelease source = obs_frontend_get_current_scene();
+	if (!source) {
+		return;
 	}
+	fileIO.writer.WriteScene(
+		fileIO.writePath, fileIO.writeFormat,
+		obs_source_get_name(source),
+		GetWeakSourceName(previousScene),
+		GetWeakSourceName(FrontendCurrentTransition()));
 }
 
 void SwitcherData::writeToStatusFile(const QString &msg)
@@ -119,16 +273,8 @@ void SwitcherData::writeToStatusFile(const QString &msg)
 		return;
 	}
 
-	QFile file(QString::fromStdString(fileIO.writePath));
-	if (file.open(QIODevice::ReadWrite)) {
-		QTextStream stream(&file);
-#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-		stream << msg << "\n";
-#else
-		stream << msg << Qt::endl;
-#endif
-	}
-	file.close();
+	fileIO.writer.WriteStatus(fileIO.writePath, fileIO.writeFormat,
+				  msg.toStdString());
 }
 
 bool SwitcherData::checkSwitchInfoFromFile(OBSWeakSource &scene,
@@ -392,6 +538,8 @@ void SwitcherData::saveFileSwitches(obs_data_t *obj)
 	obs_data_set_string(obj, "readPath", fileIO.readPath.c_str());
 	obs_data_set_bool(obj, "writeEnabled", fileIO.writeEnabled);
 	obs_data_set_string(obj, "writePath", fileIO.writePath.c_str());
+	obs_data_set_int(obj, "writeFormat",
+			 static_cast<int>(fileIO.writeFormat));
 }
 
 void SwitcherData::loadFileSwitches(obs_data_t *obj)
@@ -416,6 +564,14 @@ void SwitcherData::loadFileSwitches(obs_data_t *obj)
 	obs_data_set_default_bool(obj, "writeEnabled", false);
 	fileIO.writeEnabled = obs_data_get_bool(obj, "writeEnabled");
 	fileIO.writePath = obs_data_get_string(obj, "writePath");
+	const auto writeFormat = obs_data_get_int(obj, "writeFormat");
+	if (writeFormat < static_cast<int>(StatusFileWriter::Format::PLAIN) ||
+	    writeFormat > static_cast<int>(StatusFileWriter::Format::JSON)) {
+		fileIO.writeFormat = StatusFileWriter::Format::PLAIN;
+	} else {
+		fileIO.writeFormat =
+			static_cast<StatusFileWriter::Format>(writeFormat);
+	}
 }
 
 void AdvSceneSwitcher::SetupFileTab()
@@ -454,6 +610,12 @@ void AdvSceneSwitcher::SetupFileTab()
 	ui->readFileCheckBox->setChecked(switcher->fileIO.readEnabled);
 	ui->writePathLineEdit->setText(
 		QString::fromStdString(switcher->fileIO.writePath.c_str()));
+	ui->writeFormat->addItem(
+		obs_module_text("AdvSceneSwitcher.fileTab.writeFormat.plain"));
+	ui->writeFormat->addItem(
+		obs_module_text("AdvSceneSwitcher.fileTab.writeFormat.json"));
+	ui->writeFormat->setCurrentIndex(
+		static_cast<int>(switcher->fileIO.writeFormat));
 
 	if (ui->readFileCheckBox->checkState()) {
 		ui->browseButton_2->setDisabled(false);
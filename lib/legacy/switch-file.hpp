@@ -11,6 +11,10 @@
 
 #include <QPlainTextEdit>
 #include <QDateTime>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <thread>
 
 namespace advss {
 
@@ -69,11 +73,59 @@ private:
 	FileSwitch *switchData;
 };
 
+// Writes the status of the scene switcher to a file on a separate thread, so
+// the caller never has to wait for the file system.
+//
+// The file is replaced atomically, so external tools reading it will never
+// see a partially written file.
+// Only the most recent pending write is kept if writes are requested faster
+// than they can be completed.
+class StatusFileWriter {
+public:
+	enum class Format {
+		PLAIN,
+		JSON,
+	};
+
+	~StatusFileWriter();
+	void WriteScene(const std::string &path, Format format,
+			const std::string &scene,
+			const std::string &previousScene,
+			const std::string &transition);
+	void WriteStatus(const std::string &path, Format format,
+			 const std::string &status);
+
+private:
+	struct Request {
+		std::string path;
+		std::string content;
+	};
+
+	bool SceneChanged(const std::string &path, Format format,
+			  const std::string &scene);
+	void Queue(const std::string &path, const std::string &content);
+	void Thread();
+
+	std::mutex _mutex;
+	std::condition_variable _cv;
+	std::thread _thread;
+	bool _stop = false;
+	std::optional<Request> _pending;
+
+	// Used to skip writes if the scene did not change
+	bool _sceneWritten = false;
+	std::string _lastPath;
+	Format _lastFormat = Format::PLAIN;
+	std::string _lastScene;
+};
+
 struct FileIOData {
 	bool readEnabled = false;
 	std::string readPath;
 	bool writeEnabled = false;
 	std::string writePath;
+	StatusFileWriter::Format writeFormat = StatusFileWriter::Format::PLAIN;
+	StatusFileWriter writer;
 };
 
 } // namespace advss
@@ -102,12 +102,18 @@ void MacroActionEdit::UpdateEntryData(const std::string &id)
 	const bool enabled = (*_entryData)->Enabled();
 	_enable->setChecked(enabled);
 	SetDisableEffect(!enabled);
-	auto widget = MacroActionFactory::CreateWidget(id, this, *_entryData);
-	QWidget::connect(widget, SIGNAL(HeaderInfoChanged(const QString &)),
-			 this, SLOT(HeaderInfoChanged(const QString &)));
 	HeaderInfoChanged(
 		QString::fromStdString((*_entryData)->GetShortDesc()));
-	_section->SetContent(widget, (*_entryData)->GetCollapsed());
+	auto createWidget = [this, id]() {
+		auto widget = MacroActionFactory::CreateWidget(id, this,
+							       *_entryData);
+		QWidget::connect(
+			widget, SIGNAL(HeaderInfoChanged(const QString &)),
+			this, SLOT(HeaderInfoChanged(const QString &)));
+		SetFocusPolicyOfWidgets();
+		return widget;
+	};
+	_section->SetLazyContent(createWidget, (*_entryData)->GetCollapsed());
 	SetFocusPolicyOfWidgets();
 }
 
@@ -245,8 +251,7 @@ void AdvSceneSwitcher::RemoveMacroAction(int idx)
 		auto lock = LockContext();
 		ui->actionsList->Remove(idx);
 		macro->Actions().erase(macro->Actions().begin() + idx);
-		SetMacroAbortWait(true);
-		GetMacroWaitCV().notify_all();
+		SetMacroAbortWait(macro.get(), true);
 		macro->UpdateActionIndices();
 		SetActionData(*macro);
 	}
@@ -532,8 +537,7 @@ void AdvSceneSwitcher::RemoveMacroElseAction(int idx)
 		auto lock = LockContext();
 		ui->elseActionsList->Remove(idx);
 		macro->ElseActions().erase(macro->ElseActions().begin() + idx);
-		SetMacroAbortWait(true);
-		GetMacroWaitCV().notify_all();
+		SetMacroAbortWait(macro.get(), true);
 		macro->UpdateElseActionIndices();
 		SetElseActionData(*macro);
 	}
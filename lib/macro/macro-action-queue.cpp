@@ -32,7 +32,7 @@ void MacroActionQueue::AddActions(ActionQueue *queue)
 	auto actions = *GetMacroActions(macro.get());
 	for (const auto &action : actions) {
 		if (action->Enabled()) {
-			queue->Add(action);
+			queue->Add(action, _highPriority);
 		}
 	}
 }
@@ -98,6 +98,7 @@ bool MacroActionQueue::Save(obs_data_t *obj) const
 	_macro.Save(obj);
 	obs_data_set_int(obj, "action", static_cast<int>(_action));
 	obs_data_set_string(obj, "queue", GetActionQueueName(_queue).c_str());
+	obs_data_set_bool(obj, "highPriority", _highPriority);
 	return true;
 }
 
@@ -108,6 +109,7 @@ bool MacroActionQueue::Load(obs_data_t *obj)
 	_action = static_cast<MacroActionQueue::Action>(
 		obs_data_get_int(obj, "action"));
 	_queue = GetWeakActionQueueByName(obs_data_get_string(obj, "queue"));
+	_highPriority = obs_data_get_bool(obj, "highPriority");
 	return true;
 }
 
@@ -139,6 +141,8 @@ MacroActionQueueEdit::MacroActionQueueEdit(
 	  _macros(new MacroSelection(parent)),
 	  _queues(new ActionQueueSelection()),
 	  _actions(new QComboBox()),
+	  _highPriority(new QCheckBox(obs_module_text(
+		  "AdvSceneSwitcher.action.queue.highPriority"))),
 	  _layout(new QHBoxLayout())
 {
 	populateActionSelection(_actions);
@@ -149,6 +153,8 @@ MacroActionQueueEdit::MacroActionQueueEdit(
 			 this, SLOT(QueueChanged(const QString &)));
 	QWidget::connect(_actions, SIGNAL(currentIndexChanged(int)), this,
 			 SLOT(ActionChanged(int)));
+	QWidget::connect(_highPriority, SIGNAL(stateChanged(int)), this,
+			 SLOT(HighPriorityChanged(int)));
 
 	setLayout(_layout);
 
@@ -165,6 +171,7 @@ void MacroActionQueueEdit::UpdateEntryData()
 	_actions->setCurrentIndex(static_cast<int>(_entryData->_action));
 	_macros->SetCurrentMacro(_entryData->_macro);
 	_queues->SetActionQueue(_entryData->_queue);
+	_highPriority->setChecked(_entryData->_highPriority);
 	SetWidgetVisibility();
 }
 
@@ -205,11 +212,22 @@ void MacroActionQueueEdit::ActionChanged(int value)
 		QString::fromStdString(_entryData->GetShortDesc()));
 }
 
+void MacroActionQueueEdit::HighPriorityChanged(int state)
+{
+	if (_loading || !_entryData) {
+		return;
+	}
+
+	auto lock = LockContext();
+	_entryData->_highPriority = state;
+}
+
 void MacroActionQueueEdit::SetWidgetVisibility()
 {
 	_layout->removeWidget(_actions);
 	_layout->removeWidget(_queues);
 	_layout->removeWidget(_macros);
+	_layout->removeWidget(_highPriority);
 
 	ClearLayout(_layout);
 
@@ -222,10 +240,15 @@ void MacroActionQueueEdit::SetWidgetVisibility()
 		_layout,
 		{{"{{actions}}", _actions},
 		 {"{{queues}}", _queues},
-		 {"{{macros}}", _macros}});
+		 {"{{macros}}", _macros}},
+		false);
+	_layout->addWidget(_highPriority);
+	_layout->addStretch();
 
 	_macros->setVisible(_entryData->_action ==
 			    MacroActionQueue::Action::ADD_TO_QUEUE);
+	_highPriority->setVisible(_entryData->_action ==
+				  MacroActionQueue::Action::ADD_TO_QUEUE);
 	_macros->HideSelectedMacro();
 }
 
@@ -27,6 +27,7 @@ public:
 	};
 	Action _action = Action::ADD_TO_QUEUE;
 	std::weak_ptr<ActionQueue> _queue;
+	bool _highPriority = false;
 
 private:
 	void AddActions(ActionQueue *);
@@ -55,6 +56,7 @@ private slots:
 	void MacroChanged(const QString &text);
 	void QueueChanged(const QString &);
 	void ActionChanged(int value);
+	void HighPriorityChanged(int state);
 signals:
 	void HeaderInfoChanged(const QString &);
 
@@ -64,6 +66,7 @@ private:
 	MacroSelection *_macros;
 	ActionQueueSelection *_queues;
 	QComboBox *_actions;
+	QCheckBox *_highPriority;
 	QHBoxLayout *_layout;
 
 	std::shared_ptr<MacroActionQueue> _entryData;
@@ -72,9 +72,11 @@ void MacroActionScript::WaitForCompletion() const
 		start - start);
 	const auto timeoutMs = GetTimeoutSeconds() * 1000.0;
 
+	SetMacroAbortWait(GetMacro(), false);
 	std::unique_lock<std::mutex> lock(*GetMutex());
 	while (!TriggerIsCompleted()) {
-		if (MacroWaitShouldAbort() || MacroIsStopped(GetMacro())) {
+		if (MacroWaitShouldAbort(GetMacro()) ||
+		    MacroIsStopped(GetMacro())) {
 			break;
 		}
 
@@ -84,7 +86,7 @@ void MacroActionScript::WaitForCompletion() const
 			break;
 		}
 
-		GetMacroWaitCV().wait_for(lock, 10ms);
+		GetMacroWaitCV(GetMacro()).wait_for(lock, 10ms);
 		const auto now = std::chrono::high_resolution_clock::now();
 		timePassed =
 			std::chrono::duration_cast<std::chrono::milliseconds>(
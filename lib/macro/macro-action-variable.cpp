@@ -163,8 +163,28 @@ void MacroActionVariable::HandleFindAndReplace(Variable *var)
 	var->SetValue(result.toStdString());
 }
 
+static std::optional<double> getVariableDoubleValue(const std::string &name)
+{
+	auto variable = GetVariableByName(name);
+	if (!variable) {
+		return {};
+	}
+	return variable->DoubleValue();
+}
+
 void MacroActionVariable::HandleMathExpression(Variable *var)
 {
+	// Variables are bound to the compiled expression, so it only has to be
+	// compiled again if the expression itself changes.
+	// If any of the variables does not hold a numeric value the variables
+	// are substituted as text instead.
+	auto value = _compiledMathExpression.Evaluate(
+		_mathExpression.UnresolvedValue(), getVariableDoubleValue);
+	if (value) {
+		var->SetValue(*value);
+		return;
+	}
+
 	auto result = EvalMathExpression(_mathExpression);
 	if (std::holds_alternative<std::string>(result)) {
 		blog(LOG_WARNING, "%s", std::get<std::string>(result).c_str());
@@ -1,6 +1,7 @@
 #pragma once
 #include "macro-action-edit.hpp"
 #include "help-icon.hpp"
+#include "math-helpers.hpp"
 #include "macro-segment-selection.hpp"
 #include "regex-config.hpp"
 #include "resizing-text-edit.hpp"
@@ -110,6 +111,7 @@ private:
 	void SetToSceneItemName(Variable *);
 
 	std::weak_ptr<MacroSegment> _macroSegment;
+	MathExpression _compiledMathExpression;
 	int _segmentIdxLoadValue = -1;
 	static bool _registered;
 	static const std::string id;
@@ -40,6 +40,22 @@ bool MacroAction::Enabled() const
 
 void MacroAction::ResolveVariablesToFixedValues() {}
 
+std::shared_ptr<MacroAction> MacroAction::CopyWithResolvedVariables() const
+{
+	auto copy = Copy();
+	OBSDataAutoRelease data = obs_data_create();
+	Save(data);
+	copy->Load(data);
+	copy->PostLoad();
+	copy->ResolveVariablesToFixedValues();
+	return copy;
+}
+
+std::string MacroAction::GetQueueCoalescingKey() const
+{
+	return "";
+}
+
 std::string_view MacroAction::GetDefaultID()
 {
 	return "scene_switch";
@@ -18,6 +18,16 @@ public:
 
 	// Used to resolve variables before actions are added to action queues
 	virtual void ResolveVariablesToFixedValues();
+	// Returns an independent copy of the action with all variables resolved
+	// to fixed values.
+	// The default implementation copies the action by serializing it, which
+	// can be avoided by actions whose copy constructor already creates an
+	// independent copy.
+	virtual std::shared_ptr<MacroAction> CopyWithResolvedVariables() const;
+	// Pending actions of an action queue with the same non-empty key are
+	// replaced when a new action with that key is added to the queue, as
+	// performing them would have no effect
+	virtual std::string GetQueueCoalescingKey() const;
 
 	void SetEnabled(bool);
 	bool Enabled() const;
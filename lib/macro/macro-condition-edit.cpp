@@ -179,14 +179,19 @@ void MacroConditionEdit::UpdateEntryData(const std::string &id)
 {
 	_conditionSelection->setCurrentText(obs_module_text(
 		MacroConditionFactory::GetConditionName(id).c_str()));
-	auto widget =
-		MacroConditionFactory::CreateWidget(id, this, *_entryData);
-	QWidget::connect(widget, SIGNAL(HeaderInfoChanged(const QString &)),
-			 this, SLOT(HeaderInfoChanged(const QString &)));
 	HeaderInfoChanged(
 		QString::fromStdString((*_entryData)->GetShortDesc()));
 	SetLogicSelection();
-	_section->SetContent(widget, (*_entryData)->GetCollapsed());
+	auto createWidget = [this, id]() {
+		auto widget = MacroConditionFactory::CreateWidget(id, this,
+								  *_entryData);
+		QWidget::connect(
+			widget, SIGNAL(HeaderInfoChanged(const QString &)),
+			this, SLOT(HeaderInfoChanged(const QString &)));
+		SetFocusPolicyOfWidgets();
+		return widget;
+	};
+	_section->SetLazyContent(createWidget, (*_entryData)->GetCollapsed());
 
 	_dur->setVisible(MacroConditionFactory::UsesDurationModifier(id));
 	auto modifier = (*_entryData)->GetDurationModifier();
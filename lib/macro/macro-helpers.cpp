@@ -17,6 +17,15 @@ GetMacroActions(Macro *macro)
 	return macro->Actions();
 }
 
+std::optional<std::deque<std::shared_ptr<MacroAction>>>
+GetMacroElseActions(Macro *macro)
+{
+	if (!macro) {
+		return {};
+	}
+	return macro->ElseActions();
+}
+
 std::optional<std::deque<std::shared_ptr<MacroCondition>>>
 GetMacroConditions(Macro *macro)
 {
@@ -53,6 +62,24 @@ void SetMacroAbortWait(bool value)
 	abortMacroWait = value;
 }
 
+std::condition_variable &GetMacroWaitCV(Macro *macro)
+{
+	return macro ? macro->GetWaitCV() : GetMacroWaitCV();
+}
+
+bool MacroWaitShouldAbort(Macro *macro)
+{
+	return MacroWaitShouldAbort() || (macro && macro->WaitShouldAbort());
+}
+
+void SetMacroAbortWait(Macro *macro, bool value)
+{
+	if (!macro) {
+		return;
+	}
+	macro->SetAbortWait(value);
+}
+
 bool ShutdownCheckIsNecessary()
 {
 	return shutdownConditionCount > 0;
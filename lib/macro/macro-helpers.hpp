@@ -19,9 +19,15 @@ class MacroAction;
 class MacroCondition;
 
 EXPORT std::deque<std::shared_ptr<Macro>> &GetMacros();
+EXPORT std::weak_ptr<Macro> GetWeakMacroByName(const char *name);
+// Returns true if the calling thread is currently running the action list of
+// the given macro, as opposed to e.g. an action queue performing its actions
+EXPORT bool IsRunningActionsOfMacro(Macro *);
 
 EXPORT std::optional<std::deque<std::shared_ptr<MacroAction>>>
 GetMacroActions(Macro *);
+EXPORT std::optional<std::deque<std::shared_ptr<MacroAction>>>
+GetMacroElseActions(Macro *);
 EXPORT std::optional<std::deque<std::shared_ptr<MacroCondition>>>
 GetMacroConditions(Macro *);
 
@@ -35,6 +41,12 @@ EXPORT std::condition_variable &GetMacroTransitionCV();
 EXPORT std::atomic_bool &MacroWaitShouldAbort();
 EXPORT void SetMacroAbortWait(bool);
 
+// Used to wait for a timeout of a single macro without waking up the actions
+// of all other macros when it is stopped or its wait is aborted
+EXPORT std::condition_variable &GetMacroWaitCV(Macro *);
+EXPORT bool MacroWaitShouldAbort(Macro *);
+EXPORT void SetMacroAbortWait(Macro *, bool);
+
 EXPORT bool ShutdownCheckIsNecessary();
 EXPORT std::atomic_int &GetShutdownConditionCount();
 
@@ -9,6 +9,7 @@
 #include <QMouseEvent>
 #include <QScrollBar>
 #include <QSpacerItem>
+#include <QTimer>
 #include <QtGlobal>
 
 namespace advss {
@@ -35,6 +36,9 @@ MacroSegmentList::MacroSegmentList(QWidget *parent)
 	setWidget(wrapper);
 	setWidgetResizable(true);
 	setAcceptDrops(true);
+
+	connect(verticalScrollBar(), &QScrollBar::valueChanged, this,
+		[this]() { ScheduleContentCreation(); });
 }
 
 MacroSegmentList::~MacroSegmentList()
@@ -102,12 +106,74 @@ void MacroSegmentList::Insert(int idx, MacroSegmentEdit *widget)
 {
 	widget->installEventFilter(this);
 	_contentLayout->insertWidget(idx, widget);
+	ScheduleContentCreation();
 }
 
 void MacroSegmentList::Add(QWidget *widget)
 {
 	widget->installEventFilter(this);
 	_contentLayout->addWidget(widget);
+	ScheduleContentCreation();
+}
+
+void MacroSegmentList::ScheduleContentCreation()
+{
+	if (_contentCreationPending) {
+		return;
+	}
+	_contentCreationPending = true;
+
+	// Wait for the layout to be updated before checking which segments
+	// are visible
+	QTimer::singleShot(0, this, [this]() {
+		_contentCreationPending = false;
+		CreateVisibleContent();
+	});
+}
+
+void MacroSegmentList::CreateVisibleContent()
+{
+	if (!isVisible()) {
+		return;
+	}
+
+	// Also create the editors of segments right below the visible area to
+	// reduce the amount of empty space showing up while scrolling
+	const int preloadHeight = viewport()->height() / 2;
+	const QRect area = viewport()->rect().adjusted(0, 0, 0, preloadHeight);
+
+	bool created = false;
+	for (int idx = 0; idx < _contentLayout->count(); ++idx) {
+		auto widget = WidgetAt(idx);
+		if (!widget || !widget->HasPendingContent()) {
+			continue;
+		}
+		const QRect rect(widget->mapTo(viewport(), QPoint(0, 0)),
+				 widget->size());
+		if (!rect.intersects(area)) {
+			continue;
+		}
+		widget->CreateContent();
+		created = true;
+	}
+
+	// Segments further down the list might have been pushed out of the
+	// visible area or been moved into it
+	if (created) {
+		ScheduleContentCreation();
+	}
+}
+
+void MacroSegmentList::resizeEvent(QResizeEvent *event)
+{
+	QScrollArea::resizeEvent(event);
+	ScheduleContentCreation();
+}
+
+void MacroSegmentList::showEvent(QShowEvent *event)
+{
+	QScrollArea::showEvent(event);
+	ScheduleContentCreation();
 }
 
 void MacroSegmentList::Remove(int idx) const
@@ -42,6 +42,8 @@ protected:
 	void dragEnterEvent(QDragEnterEvent *event);
 	void dragMoveEvent(QDragMoveEvent *event);
 	void dropEvent(QDropEvent *event);
+	void resizeEvent(QResizeEvent *event);
+	void showEvent(QShowEvent *event);
 
 private:
 	int GetSegmentIndexFromPos(const QPoint &) const;
@@ -52,12 +54,15 @@ private:
 	bool IsInListArea(const QPoint &) const;
 	QRect GetContentItemRectWithPadding(int idx) const;
 	void HideLastDropLine();
+	void ScheduleContentCreation();
+	void CreateVisibleContent();
 
 	int _dragPosition = -1;
 	int _dropLineIdx = -1;
 	QPoint _dragCursorPos;
 	std::thread _autoScrollThread;
 	std::atomic_bool _autoScroll{false};
+	bool _contentCreationPending = false;
 
 	QVBoxLayout *_layout;
 	QVBoxLayout *_contentLayout;
@@ -338,6 +338,16 @@ void MacroSegmentEdit::SetCollapsed(bool collapsed)
 	_section->SetCollapsed(collapsed);
 }
 
+bool MacroSegmentEdit::HasPendingContent() const
+{
+	return _section->HasPendingContent() && !_section->IsCollapsed();
+}
+
+void MacroSegmentEdit::CreateContent()
+{
+	_section->CreateContent();
+}
+
 void MacroSegmentEdit::SetSelected(bool selected)
 {
 	_borderFrame->setVisible(selected);
@@ -102,6 +102,11 @@ public:
 	void SetFocusPolicyOfWidgets();
 	void SetCollapsed(bool collapsed);
 	void SetSelected(bool);
+	// The editor widget of the segment is only created once it is needed.
+	// Returns true if the segment is expanded, but the editor widget was
+	// not created yet.
+	bool HasPendingContent() const;
+	void CreateContent();
 	virtual std::shared_ptr<MacroSegment> Data() const = 0;
 
 public slots:
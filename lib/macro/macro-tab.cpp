@@ -21,11 +21,11 @@
 #include <QGraphicsOpacityEffect>
 #include <QMenu>
 #include <QPropertyAnimation>
+#include <QTimer>
 
 namespace advss {
 
 static QObject *addPulse = nullptr;
-static QTimer onChangeHighlightTimer;
 
 static bool macroNameExists(const std::string &name)
 {
@@ -967,11 +967,6 @@ void AdvSceneSwitcher::SetupMacroTab()
 	ui->macroPriorityWarning->setVisible(
 		switcher->functionNamesByPriority[0] != macro_func);
 
-	onChangeHighlightTimer.setInterval(1500);
-	connect(&onChangeHighlightTimer, SIGNAL(timeout()), this,
-		SLOT(HighlightOnChange()));
-	onChangeHighlightTimer.start();
-
 	// Set action and condition toolbars
 	const std::string pathPrefix =
 		GetDataFilePath("res/images/" + GetThemeTypeName());
@@ -1042,11 +1037,17 @@ void AdvSceneSwitcher::SetupMacroTab()
 
 	SetupSegmentCopyPasteShortcutHandlers(this);
 
-	// Macro segment highlight
+	// Single timer driving all periodic UI updates of the macro tab
 	auto timer = new QTimer(this);
-	connect(timer, &QTimer::timeout,
-		[this]() { runSegmentHighligtChecks(this); });
-	timer->start(1500);
+	connect(timer, &QTimer::timeout, [this]() {
+		if (!ui->macroTab->isVisible()) {
+			return;
+		}
+		ui->macros->RefreshVisibleItems();
+		HighlightOnChange();
+		runSegmentHighligtChecks(this);
+	});
+	timer->start(MacroTree::refreshInterval);
 }
 
 void AdvSceneSwitcher::ShowMacroContextMenu(const QPoint &pos)
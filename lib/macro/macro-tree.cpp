@@ -5,6 +5,7 @@
 #include "ui-helpers.hpp"
 #include "utility.hpp"
 
+#include <algorithm>
 #include <obs.h>
 #include <string>
 #include <QLabel>
@@ -84,9 +85,8 @@ MacroTreeItem::MacroTreeItem(MacroTree *tree, std::shared_ptr<Macro> macroItem,
 	connect(_tree->window(),
 		SIGNAL(MacroRenamed(const QString &, const QString &)), this,
 		SLOT(MacroRenamed(const QString &, const QString &)));
-	connect(&_timer, SIGNAL(timeout()), this, SLOT(HighlightIfExecuted()));
-	connect(&_timer, SIGNAL(timeout()), this, SLOT(UpdatePaused()));
-	_timer.start(1500);
+	_lastUIStateVersion = _macro->GetUIStateVersion();
+	_lastHighlightCheckTime = std::chrono::high_resolution_clock::now();
 }
 
 void MacroTreeItem::EnableHighlight(bool enable)
@@ -94,23 +94,34 @@ void MacroTreeItem::EnableHighlight(bool enable)
 	_highlight = enable;
 }
 
-void MacroTreeItem::UpdatePaused()
+void MacroTreeItem::RefreshState()
 {
-	const QSignalBlocker blocker(_running);
-	_running->setChecked(!_macro->Paused());
-}
+	if (!_macro) {
+		return;
+	}
 
-void MacroTreeItem::HighlightIfExecuted()
-{
-	if (!_highlight || !_macro) {
+	const auto version = _macro->GetUIStateVersion();
+	if (version == _lastUIStateVersion) {
 		return;
 	}
+	_lastUIStateVersion = version;
 
-	if (_lastHighlightCheckTime.time_since_epoch().count() != 0 &&
-	    _macro->WasExecutedSince(_lastHighlightCheckTime)) {
+	const bool running = !_macro->Paused();
+	if (_running->isChecked() != running) {
+		const QSignalBlocker blocker(_running);
+		_running->setChecked(running);
+	}
+
+	// Items are not refreshed while they are scrolled out of view, so
+	// executions which happened before the last refresh interval are not
+	// highlighted once the item becomes visible again
+	const auto now = std::chrono::high_resolution_clock::now();
+	const auto since = std::max(_lastHighlightCheckTime,
+				    now - MacroTree::refreshInterval);
+	if (_highlight && _macro->WasExecutedSince(since)) {
 		HighlightWidget(this, Qt::green, QColor(0, 0, 0, 0), true);
 	}
-	_lastHighlightCheckTime = std::chrono::high_resolution_clock::now();
+	_lastHighlightCheckTime = now;
 }
 
 void MacroTreeItem::MacroRenamed(const QString &oldName, const QString &newName)
@@ -1280,6 +1291,30 @@ inline MacroTreeItem *MacroTree::GetItemWidget(int idx) const
 	return reinterpret_cast<MacroTreeItem *>(widget);
 }
 
+void MacroTree::RefreshVisibleItems()
+{
+	auto model = GetModel();
+	if (!model || !isVisible()) {
+		return;
+	}
+
+	const QRect rect = viewport()->rect();
+	const auto first = indexAt(rect.topLeft());
+	if (!first.isValid()) {
+		return;
+	}
+	const auto last = indexAt(rect.bottomLeft());
+	const int lastRow = last.isValid() ? last.row()
+					   : model->rowCount(QModelIndex()) - 1;
+
+	for (int row = first.row(); row <= lastRow; row++) {
+		auto item = GetItemWidget(row);
+		if (item) {
+			item->RefreshState();
+		}
+	}
+}
+
 void MacroTree::paintEvent(QPaintEvent *event)
 {
 	MacroTreeModel *mtm = GetModel();
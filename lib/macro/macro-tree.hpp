@@ -1,6 +1,5 @@
 #pragma once
 
-#include <QTimer>
 #include <QLabel>
 #include <QCheckBox>
 #include <QListView>
@@ -37,14 +36,13 @@ public:
 private slots:
 	void ExpandClicked(bool checked);
 	void EnableHighlight(bool enable);
-	void UpdatePaused();
-	void HighlightIfExecuted();
 	void MacroRenamed(const QString &, const QString &);
 
 private:
 	virtual void paintEvent(QPaintEvent *event) override;
 	void mouseDoubleClickEvent(QMouseEvent *event) override;
 	void Update(bool force);
+	void RefreshState();
 
 	enum class Type {
 		Unknown,
@@ -64,7 +62,7 @@ private:
 	MacroTree *_tree;
 	bool _highlight;
 	std::chrono::high_resolution_clock::time_point _lastHighlightCheckTime{};
-	QTimer _timer;
+	uint64_t _lastUIStateVersion = 0;
 	std::shared_ptr<Macro> _macro;
 
 	friend class MacroTree;
@@ -136,6 +134,12 @@ public:
 	bool SingleItemSelected() const;
 	bool SelectionEmpty() const;
 
+	// Refreshes the pause state and execution highlight of all visible
+	// items, whose macro state changed since the last refresh
+	void RefreshVisibleItems();
+	// Interval in which RefreshVisibleItems() is expected to be called
+	static constexpr std::chrono::milliseconds refreshInterval{1500};
+
 public slots:
 	void GroupSelectedItems();
 	void UngroupSelectedGroups();
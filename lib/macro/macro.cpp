@@ -75,6 +75,8 @@ static void obs_frontend_remove_dock(const char *id)
 namespace advss {
 
 static std::deque<std::shared_ptr<Macro>> macros;
+// The macro whose action list is currently being run on this thread
+static thread_local Macro *macroRunningActions = nullptr;
 
 Macro::Macro(const std::string &name, const bool addHotkey,
 	     const bool shortCircuitEvaluation)
@@ -302,7 +304,9 @@ bool Macro::PerformActions(bool match, bool forceParallel, bool ignorePause)
 	auto group = _parent.lock();
 	if (group) {
 		group->_lastExecutionTime = _lastExecutionTime;
+		++group->_uiStateVersion;
 	}
+	++_uiStateVersion;
 	if (_runCount != std::numeric_limits<int>::max()) {
 		_runCount++;
 	}
@@ -381,6 +385,11 @@ bool Macro::RunActionsHelper(
 	// reordered while actions are currently being executed.
 	auto actions = actionsToRun;
 
+	// Actions of other macros might be run in between using the "macro"
+	// action, so the previous value has to be restored afterwards
+	auto previousMacroRunningActions = macroRunningActions;
+	macroRunningActions = this;
+
 	bool actionsExecutedSuccessfully = true;
 	for (auto &action : actions) {
 		if (action->Enabled()) {
@@ -400,6 +409,7 @@ bool Macro::RunActionsHelper(
 			action->EnableHighlight();
 		}
 	}
+	macroRunningActions = previousMacroRunningActions;
 	_done = true;
 	return actionsExecutedSuccessfully;
 }
@@ -467,6 +477,9 @@ void Macro::SetPaused(bool pause)
 		_lastUnpauseTime = std::chrono::high_resolution_clock::now();
 		ResetTimers();
 	}
+	if (_paused != pause) {
+		++_uiStateVersion;
+	}
 	_paused = pause;
 }
 
@@ -491,10 +504,18 @@ Macro::PauseStateSaveBehavior Macro::GetPauseStateSaveBehavior() const
 	return _pauseSaveBehavior;
 }
 
+void Macro::SetAbortWait(bool abort)
+{
+	_abortWait = abort;
+	if (abort) {
+		_waitCV.notify_all();
+	}
+}
+
 void Macro::Stop()
 {
 	_stop = true;
-	GetMacroWaitCV().notify_all();
+	_waitCV.notify_all();
 	for (auto &t : _helperThreads) {
 		if (t.joinable()) {
 			t.join();
@@ -759,6 +780,39 @@ bool Macro::Save(obs_data_t *obj, bool saveForCopy) const
 }
 
 bool Macro::Load(obs_data_t *obj)
+{
+	LoadSettings(obj);
+	LoadSegments(obj);
+	LoadRegistrations(obj);
+	return true;
+}
+
+void Macro::LoadRegistrations(obs_data_t *obj)
+{
+	if (_isGroup) {
+		return;
+	}
+
+	LoadDockSettings(obj);
+
+	obs_data_set_default_bool(obj, "registerHotkeys", true);
+	_registerHotkeys = obs_data_get_bool(obj, "registerHotkeys");
+	if (_registerHotkeys) {
+		SetupHotkeys();
+	}
+	OBSDataArrayAutoRelease pauseHotkey =
+		obs_data_get_array(obj, "pauseHotkey");
+	obs_hotkey_load(_pauseHotkey, pauseHotkey);
+	OBSDataArrayAutoRelease unpauseHotkey =
+		obs_data_get_array(obj, "unpauseHotkey");
+	obs_hotkey_load(_unpauseHotkey, unpauseHotkey);
+	OBSDataArrayAutoRelease togglePauseHotkey =
+		obs_data_get_array(obj, "togglePauseHotkey");
+	obs_hotkey_load(_togglePauseHotkey, togglePauseHotkey);
+	SetHotkeysDesc();
+}
+
+void Macro::LoadSettings(obs_data_t *obj)
 {
 	_name = obs_data_get_string(obj, "name");
 
@@ -768,8 +822,7 @@ bool Macro::Load(obs_data_t *obj)
 			obs_data_get_obj(obj, "groupData");
 		_isCollapsed = obs_data_get_bool(groupData, "collapsed");
 		_groupSize = obs_data_get_int(groupData, "size");
-
-		return true;
+		return;
 	}
 
 	_pauseSaveBehavior = static_cast<PauseStateSaveBehavior>(
@@ -798,28 +851,19 @@ bool Macro::Load(obs_data_t *obj)
 		obs_data_get_bool(obj, "useCustomConditionCheckInterval");
 	_customConditionCheckInterval.Load(obj, "customConditionCheckInterval");
 
-	LoadDockSettings(obj);
-
 	LoadSplitterPos(_actionConditionSplitterPosition, obj,
 			"macroActionConditionSplitterPosition");
 	LoadSplitterPos(_elseActionSplitterPosition, obj,
 			"macroElseActionSplitterPosition");
 
-	obs_data_set_default_bool(obj, "registerHotkeys", true);
-	_registerHotkeys = obs_data_get_bool(obj, "registerHotkeys");
-	if (_registerHotkeys) {
-		SetupHotkeys();
+	_inputVariables.Load(obj);
+}
+
+void Macro::LoadSegments(obs_data_t *obj)
+{
+	if (_isGroup) {
+		return;
 	}
-	OBSDataArrayAutoRelease pauseHotkey =
-		obs_data_get_array(obj, "pauseHotkey");
-	obs_hotkey_load(_pauseHotkey, pauseHotkey);
-	OBSDataArrayAutoRelease unpauseHotkey =
-		obs_data_get_array(obj, "unpauseHotkey");
-	obs_hotkey_load(_unpauseHotkey, unpauseHotkey);
-	OBSDataArrayAutoRelease togglePauseHotkey =
-		obs_data_get_array(obj, "togglePauseHotkey");
-	obs_hotkey_load(_togglePauseHotkey, togglePauseHotkey);
-	SetHotkeysDesc();
 
 	bool root = true;
 	OBSDataArrayAutoRelease conditions =
@@ -879,10 +923,6 @@ bool Macro::Load(obs_data_t *obj)
 		}
 	}
 	UpdateElseActionIndices();
-
-	_inputVariables.Load(obj);
-
-	return true;
 }
 
 bool Macro::PostLoad()
@@ -1298,19 +1338,47 @@ void SaveMacros(obs_data_t *obj)
 	obs_data_array_release(macroArray);
 }
 
+static long long msSince(std::chrono::high_resolution_clock::time_point start)
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(
+		       std::chrono::high_resolution_clock::now() - start)
+		.count();
+}
+
 void LoadMacros(obs_data_t *obj)
 {
 	macros.clear();
-	obs_data_array_t *macroArray = obs_data_get_array(obj, "macros");
+	OBSDataArrayAutoRelease macroArray = obs_data_get_array(obj, "macros");
 	size_t count = obs_data_array_count(macroArray);
 
+	std::vector<std::shared_ptr<Macro>> newMacros;
+	std::vector<OBSDataAutoRelease> data;
 	for (size_t i = 0; i < count; i++) {
-		obs_data_t *array_obj = obs_data_array_item(macroArray, i);
-		macros.emplace_back(std::make_shared<Macro>());
-		macros.back()->Load(array_obj);
-		obs_data_release(array_obj);
+		newMacros.emplace_back(std::make_shared<Macro>());
+		data.emplace_back(obs_data_array_item(macroArray, i));
 	}
-	obs_data_array_release(macroArray);
+
+	// All phases run on the main thread, as segments might create QObjects
+	// when being created or loaded
+	auto start = std::chrono::high_resolution_clock::now();
+	for (size_t i = 0; i < count; i++) {
+		newMacros[i]->LoadSettings(data[i]);
+	}
+	const auto dataLoadDuration = msSince(start);
+
+	start = std::chrono::high_resolution_clock::now();
+	for (size_t i = 0; i < count; i++) {
+		newMacros[i]->LoadSegments(data[i]);
+	}
+	const auto segmentLoadDuration = msSince(start);
+
+	start = std::chrono::high_resolution_clock::now();
+	for (size_t i = 0; i < count; i++) {
+		newMacros[i]->LoadRegistrations(data[i]);
+	}
+	macros.insert(macros.end(), newMacros.begin(), newMacros.end());
+	const auto registrationDuration = msSince(start);
+	start = std::chrono::high_resolution_clock::now();
 
 	int groupCount = 0;
 	std::shared_ptr<Macro> group;
@@ -1348,6 +1416,12 @@ void LoadMacros(obs_data_t *obj)
 		}
 		macros.erase(it);
 	}
+
+	blog(LOG_INFO,
+	     "loaded %d macros (settings: %lld ms, segments: %lld ms, "
+	     "registration: %lld ms, post load: %lld ms)",
+	     (int)count, dataLoadDuration, segmentLoadDuration,
+	     registrationDuration, msSince(start));
 }
 
 std::deque<std::shared_ptr<Macro>> &GetMacros()
@@ -1355,6 +1429,11 @@ std::deque<std::shared_ptr<Macro>> &GetMacros()
 	return macros;
 }
 
+bool IsRunningActionsOfMacro(Macro *macro)
+{
+	return macro && macroRunningActions == macro;
+}
+
 bool CheckMacros()
 {
 	bool matchFound = false;
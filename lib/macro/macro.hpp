@@ -9,6 +9,8 @@
 
 #include <QString>
 #include <QByteArray>
+#include <atomic>
+#include <condition_variable>
 #include <string>
 #include <deque>
 #include <memory>
@@ -52,6 +54,11 @@ public:
 
 	void Stop();
 	bool GetStop() const { return _stop; }
+	// Only actions of this macro are woken up when the macro is stopped or
+	// when its currently running wait is aborted
+	std::condition_variable &GetWaitCV() { return _waitCV; }
+	void SetAbortWait(bool abort);
+	bool WaitShouldAbort() const { return _abortWait; }
 	void ResetTimers();
 
 	void SetMatchOnChange(bool onChange);
@@ -131,6 +138,9 @@ public:
 	const QList<int> &GetElseActionSplitterPosition() const;
 	bool HasValidSplitterPositions() const;
 	bool WasExecutedSince(const TimePoint &) const;
+	// Incremented whenever the macro was executed or its pause state
+	// changed, so widgets only have to be refreshed if this value changes
+	uint64_t GetUIStateVersion() const { return _uiStateVersion; }
 	bool OnChangePreventedActionsRecently();
 	void ResetUIHelpers();
 
@@ -161,6 +171,14 @@ public:
 	StringVariable ConditionsFalseStatusText() const;
 
 private:
+	// Loading is split into phases, so LoadMacros() can log the time spent
+	// parsing the macro settings, creating the segments, and registering
+	// hotkeys and docks
+	void LoadSettings(obs_data_t *obj);
+	void LoadSegments(obs_data_t *obj);
+	void LoadRegistrations(obs_data_t *obj);
+	friend void LoadMacros(obs_data_t *obj);
+
 	void SetupHotkeys();
 	void ClearHotkeys() const;
 	void SetHotkeysDesc() const;
@@ -182,10 +200,13 @@ private:
 	std::string _name = "";
 	bool _die = false;
 	bool _stop = false;
+	std::atomic_bool _abortWait = {false};
+	std::condition_variable _waitCV;
 	bool _done = true;
 	TimePoint _lastCheckTime{};
 	TimePoint _lastUnpauseTime{};
 	TimePoint _lastExecutionTime{};
+	std::atomic<uint64_t> _uiStateVersion{0};
 	std::thread _backgroundThread;
 	std::vector<std::thread> _helperThreads;
 
@@ -254,7 +275,6 @@ bool RunMacros();
 void StopAllMacros();
 Macro *GetMacroByName(const char *name);
 Macro *GetMacroByQString(const QString &name);
-std::weak_ptr<Macro> GetWeakMacroByName(const char *name);
 void InvalidateMacroTempVarValues();
 std::shared_ptr<Macro> GetMacroWithInvalidConditionInterval();
 
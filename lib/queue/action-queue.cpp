@@ -3,6 +3,8 @@
 #include "plugin-state-helpers.hpp"
 #include "ui-helpers.hpp"
 
+#include <algorithm>
+
 namespace advss {
 
 static std::deque<std::shared_ptr<Item>> queues;
@@ -46,6 +48,8 @@ void ActionQueue::Save(obs_data_t *obj) const
 	obs_data_set_string(obj, "name", _name.c_str());
 	obs_data_set_bool(obj, "runOnStartup", _runOnStartup);
 	obs_data_set_bool(obj, "resolveVariablesOnAdd", _resolveVariablesOnAdd);
+	obs_data_set_bool(obj, "coalesceActions", _coalesceActions);
+	obs_data_set_int(obj, "workerCount", _workerCount);
 }
 
 void ActionQueue::Load(obs_data_t *obj)
@@ -55,6 +59,9 @@ void ActionQueue::Load(obs_data_t *obj)
 	_runOnStartup = obs_data_get_bool(obj, "runOnStartup");
 	_resolveVariablesOnAdd =
 		obs_data_get_bool(obj, "resolveVariablesOnAdd");
+	_coalesceActions = obs_data_get_bool(obj, "coalesceActions");
+	obs_data_set_default_int(obj, "workerCount", 1);
+	_workerCount = std::max(1, (int)obs_data_get_int(obj, "workerCount"));
 
 	if (_runOnStartup) {
 		Start();
@@ -67,26 +74,44 @@ void ActionQueue::Start()
 		return;
 	}
 
-	if (_thread.joinable()) {
-		_thread.join();
+	for (auto &thread : _threads) {
+		if (thread.joinable()) {
+			thread.join();
+		}
 	}
+	_threads.clear();
 	_stop = false;
-	_thread = std::thread(&ActionQueue::RunActions, this);
+	for (int i = 0; i < _workerCount; i++) {
+		_threads.emplace_back(&ActionQueue::RunActions, this);
+	}
 }
 
 void ActionQueue::Stop()
 {
 	_stop = true;
 	_cv.notify_all();
-	if (std::this_thread::get_id() == _thread.get_id()) {
+	if (IsWorkerThread()) {
 		return;
 	}
 
-	if (_thread.joinable()) {
-		_thread.join();
+	for (auto &thread : _threads) {
+		if (thread.joinable()) {
+			thread.join();
+		}
 	}
 }
 
+bool ActionQueue::IsWorkerThread() const
+{
+	const auto id = std::this_thread::get_id();
+	for (const auto &thread : _threads) {
+		if (thread.get_id() == id) {
+			return true;
+		}
+	}
+	return false;
+}
+
 bool ActionQueue::IsRunning() const
 {
 	return !_stop;
@@ -101,30 +126,49 @@ void ActionQueue::Clear()
 {
 	std::lock_guard<std::mutex> lock(_mutex);
 	_actions.clear();
-}
+	_priorityActions.clear();
+	_coalescingEntries.clear();
+	_priorityCoalescingEntries.clear();
+}
+
+void ActionQueue::Add(const std::shared_ptr<MacroAction> &action,
+		      bool highPriority)
+{
+	// Copying the action might be expensive, so do it before locking the
+	// queue to not block the threads performing the queued actions
+	Entry entry;
+	entry.action = _resolveVariablesOnAdd
+			       ? action->CopyWithResolvedVariables()
+			       : action;
+	entry.added = std::chrono::high_resolution_clock::now();
+	if (_coalesceActions) {
+		entry.coalescingKey = entry.action->GetQueueCoalescingKey();
+	}
 
-void ActionQueue::Add(const std::shared_ptr<MacroAction> &action)
-{
 	std::lock_guard<std::mutex> lock(_mutex);
-	if (_resolveVariablesOnAdd) {
-		auto copy = action->Copy();
-		copy->GetMacro();
-		OBSDataAutoRelease data = obs_data_create();
-		action->Save(data);
-		copy->Load(data);
-		copy->PostLoad();
-		copy->ResolveVariablesToFixedValues();
-		_actions.emplace_back(copy);
-	} else {
-		_actions.emplace_back(action);
+	auto &actions = highPriority ? _priorityActions : _actions;
+	auto &coalescingEntries = highPriority ? _priorityCoalescingEntries
+					       : _coalescingEntries;
+	if (!entry.coalescingKey.empty()) {
+		auto it = coalescingEntries.find(entry.coalescingKey);
+		if (it != coalescingEntries.end()) {
+			it->second->action = entry.action;
+			return;
+		}
 	}
-	_cv.notify_all();
+	actions.emplace_back(std::move(entry));
+	if (!actions.back().coalescingKey.empty()) {
+		coalescingEntries[actions.back().coalescingKey] =
+			&actions.back();
+	}
+	_statistics.size.Add(_actions.size() + _priorityActions.size());
+	_cv.notify_one();
 }
 
 bool ActionQueue::IsEmpty()
 {
 	std::lock_guard<std::mutex> lock(_mutex);
-	return _actions.empty();
+	return _actions.empty() && _priorityActions.empty();
 }
 
 ActionQueue::TimePoint ActionQueue::GetLastEmptyTime()
@@ -138,7 +182,21 @@ ActionQueue::TimePoint ActionQueue::GetLastEmptyTime()
 size_t ActionQueue::Size()
 {
 	std::lock_guard<std::mutex> lock(_mutex);
-	return _actions.size();
+	return _actions.size() + _priorityActions.size();
+}
+
+ActionQueue::Statistics ActionQueue::GetStatistics()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _statistics;
+}
+
+static uint64_t
+msSince(const std::chrono::high_resolution_clock::time_point &time)
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(
+		       std::chrono::high_resolution_clock::now() - time)
+		.count();
 }
 
 void ActionQueue::RunActions()
@@ -147,7 +205,8 @@ void ActionQueue::RunActions()
 	while (true) {
 		{ // Grab next action to run
 			std::unique_lock<std::mutex> lock(_mutex);
-			while (_actions.empty() && !_stop) {
+			while (_actions.empty() && _priorityActions.empty() &&
+			       !_stop) {
 				_lastEmpty =
 					std::chrono::high_resolution_clock::now();
 				_cv.wait(lock);
@@ -156,8 +215,20 @@ void ActionQueue::RunActions()
 			if (_stop) {
 				return;
 			}
-			action = _actions.front();
-			_actions.pop_front();
+			const bool priority = !_priorityActions.empty();
+			auto &actions = priority ? _priorityActions : _actions;
+			auto &coalescingEntries =
+				priority ? _priorityCoalescingEntries
+					 : _coalescingEntries;
+			auto &front = actions.front();
+			action = front.action;
+			_statistics.waitTimeMs.Add(msSince(front.added));
+			auto it = coalescingEntries.find(front.coalescingKey);
+			if (it != coalescingEntries.end() &&
+			    it->second == &front) {
+				coalescingEntries.erase(it);
+			}
+			actions.pop_front();
 		}
 
 		if (!action) {
@@ -169,8 +240,43 @@ void ActionQueue::RunActions()
 			     action->GetId().c_str(), _name.c_str());
 			action->LogAction();
 		}
+		const auto start = std::chrono::high_resolution_clock::now();
 		action->PerformAction();
+
+		std::lock_guard<std::mutex> lock(_mutex);
+		_statistics.executionTimeMs.Add(msSince(start));
+	}
+}
+
+void ActionQueue::Histogram::Add(uint64_t value)
+{
+	size_t bucket = 0;
+	while (bucket < _bucketCount - 1 && value > (1ull << bucket)) {
+		++bucket;
 	}
+	++_buckets[bucket];
+}
+
+QString ActionQueue::Histogram::ToString() const
+{
+	QStringList result;
+	for (size_t i = 0; i < _bucketCount; i++) {
+		if (_buckets[i] == 0) {
+			continue;
+		}
+		// The last bucket contains all values exceeding the bound of
+		// the previous bucket
+		const bool isLast = i == _bucketCount - 1;
+		const auto label =
+			(isLast ? "> " : "<= ") +
+			QString::number(1ull << (isLast ? i - 1 : i));
+		result << label + ": " + QString::number(_buckets[i]);
+	}
+	if (result.isEmpty()) {
+		return obs_module_text(
+			"AdvSceneSwitcher.actionQueues.statistics.none");
+	}
+	return result.join(", ");
 }
 
 ActionQueueSettingsDialog::ActionQueueSettingsDialog(QWidget *parent,
@@ -187,6 +293,11 @@ ActionQueueSettingsDialog::ActionQueueSettingsDialog(QWidget *parent,
 		  obs_module_text("AdvSceneSwitcher.actionQueues.clear"))),
 	  _runOnStartup(new QCheckBox()),
 	  _resolveVariablesOnAdd(new QCheckBox()),
+	  _coalesceActions(new QCheckBox()),
+	  _workerCount(new QSpinBox()),
+	  _sizeStatistics(new QLabel()),
+	  _waitTimeStatistics(new QLabel()),
+	  _executionTimeStatistics(new QLabel()),
 	  _queue(settings)
 {
 	QWidget::connect(_startStopToggle, SIGNAL(clicked()), this,
@@ -195,6 +306,10 @@ ActionQueueSettingsDialog::ActionQueueSettingsDialog(QWidget *parent,
 
 	_runOnStartup->setChecked(settings._runOnStartup);
 	_resolveVariablesOnAdd->setChecked(settings._resolveVariablesOnAdd);
+	_coalesceActions->setChecked(settings._coalesceActions);
+	_workerCount->setMinimum(1);
+	_workerCount->setMaximum(32);
+	_workerCount->setValue(settings._workerCount);
 	UpdateLabels();
 
 	auto layout = new QGridLayout();
@@ -224,12 +339,45 @@ ActionQueueSettingsDialog::ActionQueueSettingsDialog(QWidget *parent,
 	_resolveVariablesOnAdd->setToolTip(obs_module_text(
 		"AdvSceneSwitcher.actionQueues.resolveVariablesOnAdd"));
 	++row;
+	layout->addWidget(
+		new QLabel(obs_module_text(
+			"AdvSceneSwitcher.actionQueues.coalesceActions")),
+		row, 0);
+	layout->addWidget(_coalesceActions, row, 1);
+	_coalesceActions->setToolTip(obs_module_text(
+		"AdvSceneSwitcher.actionQueues.coalesceActions.tooltip"));
+	++row;
+	layout->addWidget(new QLabel(obs_module_text(
+				  "AdvSceneSwitcher.actionQueues.workerCount")),
+			  row, 0);
+	layout->addWidget(_workerCount, row, 1);
+	_workerCount->setToolTip(obs_module_text(
+		"AdvSceneSwitcher.actionQueues.workerCount.tooltip"));
+	++row;
 	layout->addWidget(_queueRunStatus, row, 0);
 	layout->addWidget(_startStopToggle, row, 1);
 	++row;
 	layout->addWidget(_queueSize, row, 0);
 	layout->addWidget(_clear, row, 1);
 	++row;
+	layout->addWidget(
+		new QLabel(obs_module_text(
+			"AdvSceneSwitcher.actionQueues.statistics.size")),
+		row, 0);
+	layout->addWidget(_sizeStatistics, row, 1);
+	++row;
+	layout->addWidget(
+		new QLabel(obs_module_text(
+			"AdvSceneSwitcher.actionQueues.statistics.waitTime")),
+		row, 0);
+	layout->addWidget(_waitTimeStatistics, row, 1);
+	++row;
+	layout->addWidget(
+		new QLabel(obs_module_text(
+			"AdvSceneSwitcher.actionQueues.statistics.executionTime")),
+		row, 0);
+	layout->addWidget(_executionTimeStatistics, row, 1);
+	++row;
 	layout->addWidget(_buttonbox, row, 0, 1, -1);
 	layout->setSizeConstraint(QLayout::SetFixedSize);
 	setLayout(layout);
@@ -253,6 +401,17 @@ bool ActionQueueSettingsDialog::AskForSettings(QWidget *parent,
 	settings._runOnStartup = dialog._runOnStartup->isChecked();
 	settings._resolveVariablesOnAdd =
 		dialog._resolveVariablesOnAdd->isChecked();
+	settings._coalesceActions = dialog._coalesceActions->isChecked();
+
+	const int workerCount = dialog._workerCount->value();
+	if (settings._workerCount != workerCount) {
+		settings._workerCount = workerCount;
+		// Restart the queue to apply the new worker count
+		if (settings.IsRunning()) {
+			settings.Stop();
+			settings.Start();
+		}
+	}
 	return true;
 }
 
@@ -284,6 +443,12 @@ void ActionQueueSettingsDialog::UpdateLabels()
 	_queueSize->setText(
 		QString(obs_module_text("AdvSceneSwitcher.actionQueues.size"))
 			.arg(QString::number(_queue.Size())));
+
+	const auto statistics = _queue.GetStatistics();
+	_sizeStatistics->setText(statistics.size.ToString());
+	_waitTimeStatistics->setText(statistics.waitTimeMs.ToString());
+	_executionTimeStatistics->setText(
+		statistics.executionTimeMs.ToString());
 }
 
 static bool AskForSettingsWrapper(QWidget *parent, Item &settings)
@@ -2,12 +2,15 @@
 #include "item-selection-helpers.hpp"
 #include "macro-action.hpp"
 
+#include <array>
 #include <chrono>
 #include <condition_variable>
 #include <deque>
 #include <obs-data.h>
 #include <QCheckBox>
+#include <QSpinBox>
 #include <thread>
+#include <unordered_map>
 
 namespace advss {
 
@@ -18,6 +21,23 @@ class ActionQueue : public Item {
 	using TimePoint = std::chrono::high_resolution_clock::time_point;
 
 public:
+	// Counts values in buckets with power of two upper bounds
+	class Histogram {
+	public:
+		void Add(uint64_t value);
+		QString ToString() const;
+
+	private:
+		static constexpr size_t _bucketCount = 12;
+		std::array<uint64_t, _bucketCount> _buckets = {};
+	};
+
+	struct Statistics {
+		Histogram size;
+		Histogram waitTimeMs;
+		Histogram executionTimeMs;
+	};
+
 	ActionQueue();
 	~ActionQueue();
 
@@ -35,20 +55,42 @@ public:
 	bool IsEmpty();
 	TimePoint GetLastEmptyTime();
 
-	void Add(const std::shared_ptr<MacroAction> &);
+	void Add(const std::shared_ptr<MacroAction> &,
+		 bool highPriority = false);
 	size_t Size();
+	Statistics GetStatistics();
 
 private:
+	struct Entry {
+		std::shared_ptr<MacroAction> action;
+		TimePoint added;
+		std::string coalescingKey;
+	};
+
+	bool IsWorkerThread() const;
 	void RunActions();
 
 	bool _runOnStartup = true;
-	bool _resolveVariablesOnAdd = true;
+	std::atomic_bool _resolveVariablesOnAdd = {true};
+	// Pending actions with the same coalescing key are replaced
+	std::atomic_bool _coalesceActions = {false};
+	// Actions are no longer guaranteed to be performed in order if more
+	// than one worker thread is used
+	int _workerCount = 1;
 	std::atomic_bool _stop = {true};
 	std::mutex _mutex;
 	std::condition_variable _cv;
-	std::thread _thread;
-	std::deque<std::shared_ptr<MacroAction>> _actions;
+	std::vector<std::thread> _threads;
+	std::deque<Entry> _actions;
+	std::deque<Entry> _priorityActions;
+	// Pending entries by their coalescing key, so they do not have to be
+	// searched for when adding actions.
+	// Pointers to the elements of a deque stay valid when elements are
+	// only added or removed at either end.
+	std::unordered_map<std::string, Entry *> _coalescingEntries;
+	std::unordered_map<std::string, Entry *> _priorityCoalescingEntries;
 	TimePoint _lastEmpty;
+	Statistics _statistics;
 
 	friend ActionQueueSelection;
 	friend ActionQueueSettingsDialog;
@@ -73,6 +115,11 @@ private:
 	QPushButton *_clear;
 	QCheckBox *_runOnStartup;
 	QCheckBox *_resolveVariablesOnAdd;
+	QCheckBox *_coalesceActions;
+	QSpinBox *_workerCount;
+	QLabel *_sizeStatistics;
+	QLabel *_waitTimeStatistics;
+	QLabel *_executionTimeStatistics;
 
 	ActionQueue &_queue;
 };
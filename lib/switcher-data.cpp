@@ -1,6 +1,8 @@
 #include "switcher-data.hpp"
 #include "source-helpers.hpp"
 
+#include <algorithm>
+
 namespace advss {
 
 SwitcherData *switcher = nullptr;
@@ -35,49 +37,73 @@ obs_module_t *SwitcherData::GetModule()
 	return _modulePtr;
 }
 
-void SwitcherData::Prune()
+static void requestPrune(void *data, calldata_t *)
+{
+	static_cast<SwitcherData *>(data)->RequestPrune();
+}
+
+static bool setup()
 {
-	for (size_t i = 0; i < windowSwitches.size(); i++) {
-		WindowSwitch &s = windowSwitches[i];
-		if (!s.valid()) {
-			windowSwitches.erase(windowSwitches.begin() + i--);
+	AddPluginInitStep([]() {
+		if (!switcher) {
+			return;
+		}
+		auto handler = obs_get_signal_handler();
+		switcher->sourceDestroySignal.Connect(handler, "source_destroy",
+						      requestPrune, switcher);
+		switcher->sourceRemoveSignal.Connect(handler, "source_remove",
+						     requestPrune, switcher);
+	});
+	AddPluginCleanupStep([]() {
+		if (!switcher) {
+			return;
 		}
+		switcher->sourceDestroySignal.Disconnect();
+		switcher->sourceRemoveSignal.Disconnect();
+	});
+	return true;
+}
+
+static bool setupDone = setup();
+
+template<typename T> static void removeInvalidEntries(std::deque<T> &entries)
+{
+	entries.erase(std::remove_if(entries.begin(), entries.end(),
+				     [](T &entry) { return !entry.valid(); }),
+		      entries.end());
+}
+
+static bool isInvalidScene(const OBSWeakSource &scene)
+{
+	return !WeakSourceValid(scene);
+}
+
+void SwitcherData::RequestPrune()
+{
+	pruneRequired = true;
+}
+
+void SwitcherData::PruneIfRequired()
+{
+	if (pruneRequired.exchange(false)) {
+		Prune();
 	}
+}
+
+void SwitcherData::Prune()
+{
+	pruneRequired = false;
 
 	if (nonMatchingScene && !WeakSourceValid(nonMatchingScene)) {
 		switchIfNotMatching = NoMatchBehavior::NO_SWITCH;
 		nonMatchingScene = nullptr;
 	}
 
-	for (size_t i = 0; i < randomSwitches.size(); i++) {
-		RandomSwitch &s = randomSwitches[i];
-		if (!s.valid()) {
-			randomSwitches.erase(randomSwitches.begin() + i--);
-		}
-	}
-
-	for (size_t i = 0; i < screenRegionSwitches.size(); i++) {
-		ScreenRegionSwitch &s = screenRegionSwitches[i];
-		if (!s.valid()) {
-			screenRegionSwitches.erase(
-				screenRegionSwitches.begin() + i--);
-		}
-	}
-
-	for (size_t i = 0; i < pauseEntries.size(); i++) {
-		PauseEntry &s = pauseEntries[i];
-		if (!s.valid()) {
-			pauseEntries.erase(pauseEntries.begin() + i--);
-		}
+	if (!idleData.valid()) {
+		idleData.idleEnable = false;
 	}
 
-	for (size_t i = 0; i < sceneSequenceSwitches.size(); i++) {
-		SceneSequenceSwitch &s = sceneSequenceSwitches[i];
-		if (!s.valid()) {
-			sceneSequenceSwitches.erase(
-				sceneSequenceSwitches.begin() + i--);
-		}
-
+	for (auto &s : sceneSequenceSwitches) {
 		auto cur = &s;
 		while (cur != nullptr) {
 			if (cur->extendedSequence &&
@@ -89,66 +115,24 @@ void SwitcherData::Prune()
 		}
 	}
 
-	for (size_t i = 0; i < sceneTransitions.size(); i++) {
-		SceneTransition &s = sceneTransitions[i];
-		if (!s.valid()) {
-			sceneTransitions.erase(sceneTransitions.begin() + i--);
-		}
-	}
-
-	for (size_t i = 0; i < defaultSceneTransitions.size(); i++) {
-		DefaultSceneTransition &s = defaultSceneTransitions[i];
-		if (!s.valid()) {
-			defaultSceneTransitions.erase(
-				defaultSceneTransitions.begin() + i--);
-		}
-	}
-
-	for (size_t i = 0; i < executableSwitches.size(); i++) {
-		ExecutableSwitch &s = executableSwitches[i];
-		if (!s.valid()) {
-			executableSwitches.erase(executableSwitches.begin() +
-						 i--);
-		}
-	}
-
-	for (size_t i = 0; i < fileSwitches.size(); i++) {
-		FileSwitch &s = fileSwitches[i];
-		if (!s.valid()) {
-			fileSwitches.erase(fileSwitches.begin() + i--);
-		}
-	}
-
-	for (size_t i = 0; i < timeSwitches.size(); i++) {
-		TimeSwitch &s = timeSwitches[i];
-		if (!s.valid()) {
-			timeSwitches.erase(timeSwitches.begin() + i--);
-		}
-	}
-
-	if (!idleData.valid()) {
-		idleData.idleEnable = false;
-	}
-
-	for (size_t i = 0; i < mediaSwitches.size(); i++) {
-		MediaSwitch &s = mediaSwitches[i];
-		if (!s.valid()) {
-			mediaSwitches.erase(mediaSwitches.begin() + i--);
-		}
-	}
-
-	for (size_t i = 0; i < audioSwitches.size(); i++) {
-		AudioSwitch &s = audioSwitches[i];
-		if (!s.valid()) {
-			audioSwitches.erase(audioSwitches.begin() + i--);
-		}
-	}
+	removeInvalidEntries(windowSwitches);
+	removeInvalidEntries(randomSwitches);
+	removeInvalidEntries(screenRegionSwitches);
+	removeInvalidEntries(pauseEntries);
+	removeInvalidEntries(sceneSequenceSwitches);
+	removeInvalidEntries(sceneTransitions);
+	removeInvalidEntries(defaultSceneTransitions);
+	removeInvalidEntries(executableSwitches);
+	removeInvalidEntries(fileSwitches);
+	removeInvalidEntries(timeSwitches);
+	removeInvalidEntries(mediaSwitches);
+	removeInvalidEntries(audioSwitches);
 
 	for (auto &sg : sceneGroups) {
-		for (size_t i = 0; i < sg.scenes.size(); i++)
-			if (!WeakSourceValid(sg.scenes[i])) {
-				sg.scenes.erase(sg.scenes.begin() + i--);
-			}
+		auto &scenes = sg.scenes;
+		scenes.erase(std::remove_if(scenes.begin(), scenes.end(),
+					    isInvalidScene),
+			     scenes.end());
 	}
 }
 
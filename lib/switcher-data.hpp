@@ -19,6 +19,7 @@
 #include "priority-helper.hpp"
 #include "plugin-state-helpers.hpp"
 
+#include <atomic>
 #include <condition_variable>
 #include <vector>
 #include <deque>
@@ -77,7 +78,7 @@ public:
 	void SaveUISettings(obs_data_t *obj);
 	void SaveVersion(obs_data_t *obj, const std::string &currentVersion);
 
-	void LoadSettings(obs_data_t *obj);
+	void LoadSettings(obs_data_t *obj, bool isImport = false);
 	void LoadGeneralSettings(obs_data_t *obj);
 	void LoadHotkeys(obs_data_t *obj);
 	void LoadUISettings(obs_data_t *obj);
@@ -95,6 +96,7 @@ public:
 	std::mutex m;
 	std::unique_lock<std::mutex> *mainLoopLock = nullptr;
 	bool stop = false;
+	std::atomic_bool checkRequested = {false};
 	std::condition_variable cv;
 
 	std::vector<std::function<void(obs_data_t *)>> saveSteps;
@@ -209,7 +211,11 @@ public:
 	void loadSceneGroups(obs_data_t *obj);
 	void loadVideoSwitches(obs_data_t *obj);
 
+	// Removing entries referring to sources which no longer exist is only
+	// necessary if a source was removed or destroyed since the last check
 	void Prune();
+	void RequestPrune();
+	void PruneIfRequired();
 
 	bool checkSceneSequence(OBSWeakSource &scene, OBSWeakSource &transition,
 				int &linger, bool &setPrevSceneAfterLinger);
@@ -236,6 +242,10 @@ public:
 	void writeToStatusFile(const QString &msg);
 	void checkSwitchCooldown(bool &match);
 
+	std::atomic_bool pruneRequired = {true};
+	OBSSignal sourceDestroySignal;
+	OBSSignal sourceRemoveSignal;
+
 	std::deque<WindowSwitch> windowSwitches;
 	std::vector<std::string> ignoreWindowsSwitches;
 	IdleData idleData;
@@ -0,0 +1,203 @@
+#include "animation-helpers.hpp"
+#include "obs-module-helper.hpp"
+#include "plugin-state-helpers.hpp"
+
+#include <obs.h>
+#include <QComboBox>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace advss {
+
+namespace {
+struct Animation {
+	AnimationId id;
+	double from;
+	double to;
+	std::chrono::steady_clock::time_point start;
+	std::chrono::milliseconds duration;
+	Easing easing;
+	std::shared_ptr<std::function<bool(double)>> apply;
+};
+} // namespace
+
+static std::mutex mutex;
+static std::condition_variable animationDone;
+static std::unordered_map<std::string, Animation> animations;
+static AnimationId nextId = 0;
+
+static bool setup();
+static bool setupDone = setup();
+static void tick(void *, float);
+
+static bool setup()
+{
+	AddPluginInitStep([]() { obs_add_tick_callback(tick, nullptr); });
+	AddPluginCleanupStep([]() {
+		obs_remove_tick_callback(tick, nullptr);
+		std::lock_guard<std::mutex> lock(mutex);
+		animations.clear();
+		animationDone.notify_all();
+	});
+	return true;
+}
+
+void PopulateEasingSelection(QComboBox *list)
+{
+	list->addItem(obs_module_text("AdvSceneSwitcher.easing.linear"),
+		      static_cast<int>(Easing::LINEAR));
+	list->addItem(obs_module_text("AdvSceneSwitcher.easing.easeIn"),
+		      static_cast<int>(Easing::EASE_IN));
+	list->addItem(obs_module_text("AdvSceneSwitcher.easing.easeOut"),
+		      static_cast<int>(Easing::EASE_OUT));
+	list->addItem(obs_module_text("AdvSceneSwitcher.easing.easeInOut"),
+		      static_cast<int>(Easing::EASE_IN_OUT));
+}
+
+static void tick(void *, float)
+{
+	struct Step {
+		std::string key;
+		AnimationId id;
+		double value;
+		bool done;
+		std::shared_ptr<std::function<bool(double)>> apply;
+	};
+
+	// Only ever accessed from the graphics thread
+	static std::vector<Step> steps;
+	steps.clear();
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (animations.empty()) {
+			return;
+		}
+
+		const auto now = std::chrono::steady_clock::now();
+		for (const auto &[key, animation] : animations) {
+			const auto elapsed = now - animation.start;
+			double progress = 1.0;
+			if (animation.duration.count() > 0 &&
+			    elapsed < animation.duration) {
+				progress = std::chrono::duration<double>(
+						   elapsed) /
+					   animation.duration;
+			}
+			const double value =
+				animation.from +
+				(animation.to - animation.from) *
+					ApplyEasing(animation.easing, progress);
+			steps.push_back({key, animation.id, value,
+					 progress >= 1.0, animation.apply});
+		}
+	}
+
+	// The apply functions are called without holding the lock, so they
+	// are free to start or stop animations themselves
+	bool animationEnded = false;
+	for (auto &step : steps) {
+		if (!(*step.apply)(step.value)) {
+			step.done = true;
+		}
+		animationEnded = animationEnded || step.done;
+	}
+
+	if (!animationEnded) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+	for (const auto &step : steps) {
+		if (!step.done) {
+			continue;
+		}
+
+		// The animation might have been replaced in the meantime
+		auto it = animations.find(step.key);
+		if (it != animations.end() && it->second.id == step.id) {
+			animations.erase(it);
+		}
+	}
+	animationDone.notify_all();
+}
+
+AnimationId StartAnimation(const std::string &key, double from, double to,
+			   std::chrono::milliseconds duration, Easing easing,
+			   std::function<bool(double)> apply)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	auto &animation = animations[key];
+	animation.id = ++nextId;
+	animation.from = from;
+	animation.to = to;
+	animation.start = std::chrono::steady_clock::now();
+	animation.duration = duration;
+	animation.easing = easing;
+	animation.apply =
+		std::make_shared<std::function<bool(double)>>(std::move(apply));
+
+	// Waiting threads have to be notified in case an animation was replaced
+	animationDone.notify_all();
+	return animation.id;
+}
+
+void StopAnimation(const std::string &key)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	if (animations.erase(key) > 0) {
+		animationDone.notify_all();
+	}
+}
+
+bool AnimationIsActive(const std::string &key)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return animations.find(key) != animations.end();
+}
+
+static bool animationIsActiveHelper(AnimationId id)
+{
+	for (const auto &[_, animation] : animations) {
+		if (animation.id == id) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool AnimationIsActive(AnimationId id)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return animationIsActiveHelper(id);
+}
+
+bool WaitForAnimation(AnimationId id, const std::function<bool()> &abort)
+{
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			if (!animationIsActiveHelper(id)) {
+				return true;
+			}
+			// The abort condition is checked periodically, as it
+			// usually cannot notify us
+			const auto done = animationDone.wait_for(
+				lock, std::chrono::milliseconds(50), [id]() {
+					return !animationIsActiveHelper(id);
+				});
+			if (done) {
+				return true;
+			}
+		}
+
+		if (abort && abort()) {
+			return false;
+		}
+	}
+}
+
+} // namespace advss
@@ -0,0 +1,41 @@
+#pragma once
+#include "easing.hpp"
+#include "export-symbol-helper.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+class QComboBox;
+
+namespace advss {
+
+EXPORT void PopulateEasingSelection(QComboBox *);
+
+// Animations are advanced once per frame by the OBS tick callback, so any
+// number of them can be active at the same time without requiring a thread
+// each.
+//
+// Each animation is identified by a key, e.g. the name of the property it
+// modifies. Starting an animation using a key, which is already being
+// animated, replaces the active animation.
+//
+// The apply function is called from the OBS graphics thread with the current
+// value. If it returns false the animation is stopped.
+
+using AnimationId = uint64_t;
+
+EXPORT AnimationId StartAnimation(const std::string &key, double from,
+				  double to, std::chrono::milliseconds duration,
+				  Easing easing,
+				  std::function<bool(double)> apply);
+EXPORT void StopAnimation(const std::string &key);
+EXPORT bool AnimationIsActive(const std::string &key);
+EXPORT bool AnimationIsActive(AnimationId);
+
+// Blocks until the animation is completed, stopped or replaced.
+// Returns false if waiting was aborted using the abort function.
+EXPORT bool WaitForAnimation(AnimationId, const std::function<bool()> &abort);
+
+} // namespace advss
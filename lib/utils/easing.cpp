@@ -0,0 +1,29 @@
+#include "easing.hpp"
+
+namespace advss {
+
+double ApplyEasing(Easing easing, double progress)
+{
+	switch (easing) {
+	case Easing::LINEAR:
+		return progress;
+	case Easing::EASE_IN:
+		return progress * progress * progress;
+	case Easing::EASE_OUT: {
+		const double inverse = 1.0 - progress;
+		return 1.0 - inverse * inverse * inverse;
+	}
+	case Easing::EASE_IN_OUT:
+		if (progress < 0.5) {
+			return 4.0 * progress * progress * progress;
+		} else {
+			const double inverse = -2.0 * progress + 2.0;
+			return 1.0 - inverse * inverse * inverse / 2.0;
+		}
+	default:
+		break;
+	}
+	return progress;
+}
+
+} // namespace advss
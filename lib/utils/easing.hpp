@@ -0,0 +1,17 @@
+#pragma once
+#include "export-symbol-helper.hpp"
+
+namespace advss {
+
+enum class Easing {
+	LINEAR,
+	EASE_IN,
+	EASE_OUT,
+	EASE_IN_OUT,
+};
+
+// Maps the progress of an animation in the range of 0 to 1 to the progress of
+// the animated value
+EXPORT double ApplyEasing(Easing, double progress);
+
+} // namespace advss
@@ -0,0 +1,187 @@
+#include "frontend-state.hpp"
+#include "plugin-state-helpers.hpp"
+
+#include <obs-frontend-api.h>
+#include <atomic>
+#include <mutex>
+
+namespace advss {
+
+static std::atomic_bool recordingActive = {false};
+static std::atomic_bool recordingPaused = {false};
+static std::atomic_bool streamingActive = {false};
+static std::atomic_bool replayBufferActive = {false};
+static std::atomic_bool virtualCamActive = {false};
+static std::atomic_bool studioModeActive = {false};
+
+// The weak source references are only swapped inside the frontend event
+// handler, so the lock is never held for long
+static std::mutex sourceMutex;
+static OBSWeakSource previewScene;
+static OBSWeakSource currentTransition;
+
+static bool setup();
+static bool setupDone = setup();
+
+static OBSWeakSource getWeakSource(obs_source_t *source)
+{
+	OBSWeakSourceAutoRelease weakSource =
+		obs_source_get_weak_source(source);
+	obs_source_release(source);
+	return OBSWeakSource(weakSource.Get());
+}
+
+static void updatePreviewScene()
+{
+	OBSWeakSource scene;
+	if (studioModeActive) {
+		scene = getWeakSource(obs_frontend_get_current_preview_scene());
+	}
+	std::lock_guard<std::mutex> lock(sourceMutex);
+	previewScene = scene;
+}
+
+static void updateCurrentTransition()
+{
+	auto transition =
+		getWeakSource(obs_frontend_get_current_transition());
+	std::lock_guard<std::mutex> lock(sourceMutex);
+	currentTransition = transition;
+}
+
+static void updateAll()
+{
+	recordingActive = obs_frontend_recording_active();
+	recordingPaused = obs_frontend_recording_paused();
+	streamingActive = obs_frontend_streaming_active();
+	replayBufferActive = obs_frontend_replay_buffer_active();
+#if LIBOBS_API_VER >= MAKE_SEMANTIC_VERSION(27, 0, 0)
+	virtualCamActive = obs_frontend_virtualcam_active();
+#endif
+	studioModeActive = obs_frontend_preview_program_mode_active();
+	updatePreviewScene();
+	updateCurrentTransition();
+}
+
+static void clearSources()
+{
+	std::lock_guard<std::mutex> lock(sourceMutex);
+	previewScene = nullptr;
+	currentTransition = nullptr;
+}
+
+static void handleFrontendEvent(enum obs_frontend_event event, void *)
+{
+	switch (event) {
+	case OBS_FRONTEND_EVENT_RECORDING_STARTED:
+		recordingActive = true;
+		recordingPaused = false;
+		break;
+	case OBS_FRONTEND_EVENT_RECORDING_STOPPED:
+		recordingActive = false;
+		recordingPaused = false;
+		break;
+	case OBS_FRONTEND_EVENT_RECORDING_PAUSED:
+		recordingPaused = true;
+		break;
+	case OBS_FRONTEND_EVENT_RECORDING_UNPAUSED:
+		recordingPaused = false;
+		break;
+	case OBS_FRONTEND_EVENT_STREAMING_STARTED:
+		streamingActive = true;
+		break;
+	case OBS_FRONTEND_EVENT_STREAMING_STOPPED:
+		streamingActive = false;
+		break;
+	case OBS_FRONTEND_EVENT_REPLAY_BUFFER_STARTED:
+		replayBufferActive = true;
+		break;
+	case OBS_FRONTEND_EVENT_REPLAY_BUFFER_STOPPED:
+		replayBufferActive = false;
+		break;
+#if LIBOBS_API_VER >= MAKE_SEMANTIC_VERSION(27, 0, 0)
+	case OBS_FRONTEND_EVENT_VIRTUALCAM_STARTED:
+		virtualCamActive = true;
+		break;
+	case OBS_FRONTEND_EVENT_VIRTUALCAM_STOPPED:
+		virtualCamActive = false;
+		break;
+#endif
+	case OBS_FRONTEND_EVENT_STUDIO_MODE_ENABLED:
+		studioModeActive = true;
+		updatePreviewScene();
+		break;
+	case OBS_FRONTEND_EVENT_STUDIO_MODE_DISABLED:
+		studioModeActive = false;
+		updatePreviewScene();
+		break;
+	case OBS_FRONTEND_EVENT_PREVIEW_SCENE_CHANGED:
+		updatePreviewScene();
+		break;
+	case OBS_FRONTEND_EVENT_TRANSITION_CHANGED:
+	case OBS_FRONTEND_EVENT_TRANSITION_LIST_CHANGED:
+		updateCurrentTransition();
+		break;
+	case OBS_FRONTEND_EVENT_SCENE_COLLECTION_CLEANUP:
+	case OBS_FRONTEND_EVENT_EXIT:
+		clearSources();
+		break;
+	case OBS_FRONTEND_EVENT_FINISHED_LOADING:
+	case OBS_FRONTEND_EVENT_SCENE_COLLECTION_CHANGED:
+		updateAll();
+		break;
+	default:
+		break;
+	}
+}
+
+static bool setup()
+{
+	obs_frontend_add_event_callback(handleFrontendEvent, nullptr);
+	AddPluginInitStep(updateAll);
+	return true;
+}
+
+bool FrontendRecordingActive()
+{
+	return recordingActive;
+}
+
+bool FrontendRecordingPaused()
+{
+	return recordingPaused;
+}
+
+bool FrontendStreamingActive()
+{
+	return streamingActive;
+}
+
+bool FrontendReplayBufferActive()
+{
+	return replayBufferActive;
+}
+
+bool FrontendVirtualCamActive()
+{
+	return virtualCamActive;
+}
+
+bool FrontendStudioModeActive()
+{
+	return studioModeActive;
+}
+
+OBSWeakSource FrontendPreviewScene()
+{
+	std::lock_guard<std::mutex> lock(sourceMutex);
+	return previewScene;
+}
+
+OBSWeakSource FrontendCurrentTransition()
+{
+	std::lock_guard<std::mutex> lock(sourceMutex);
+	return currentTransition;
+}
+
+} // namespace advss
@@ -0,0 +1,22 @@
+#pragma once
+#include "export-symbol-helper.hpp"
+
+#include <obs.hpp>
+
+namespace advss {
+
+// Mirror of the OBS frontend state, which is kept up to date using the OBS
+// frontend events.
+// It can be queried from any thread without having to call into the frontend
+// API, which in parts is only safe to be used from the UI thread.
+
+EXPORT bool FrontendRecordingActive();
+EXPORT bool FrontendRecordingPaused();
+EXPORT bool FrontendStreamingActive();
+EXPORT bool FrontendReplayBufferActive();
+EXPORT bool FrontendVirtualCamActive();
+EXPORT bool FrontendStudioModeActive();
+EXPORT OBSWeakSource FrontendPreviewScene();
+EXPORT OBSWeakSource FrontendCurrentTransition();
+
+} // namespace advss
@@ -1,25 +1,29 @@
 #include "math-helpers.hpp"
 #include "obs-module-helper.hpp"
 
+#include <algorithm>
+#include <cctype>
 #include <climits>
 #include <exprtk.hpp>
 #include <random>
 
 namespace advss {
 
-std::variant<double, std::string> EvalMathExpression(const std::string &expr)
+static double randomValue()
 {
-	static bool setupDone = false;
-	static exprtk::symbol_table<double> symbolTable;
 	static std::random_device rd;
 	static std::mt19937 gen(rd());
 	static std::uniform_real_distribution<double> dis(0.0, 1.0);
-	static auto randomFunc = []() {
-		return dis(gen);
-	};
+	return dis(gen);
+}
+
+std::variant<double, std::string> EvalMathExpression(const std::string &expr)
+{
+	static bool setupDone = false;
+	static exprtk::symbol_table<double> symbolTable;
 
 	if (!setupDone) {
-		symbolTable.add_function("random", randomFunc);
+		symbolTable.add_function("random", randomValue);
 		setupDone = true;
 	}
 
@@ -35,6 +39,167 @@ std::variant<double, std::string> EvalMathExpression(const std::string &expr)
 	       " \"" + expr + "\"";
 }
 
+struct MathExpression::CompiledExpression {
+	exprtk::symbol_table<double> symbolTable;
+	exprtk::expression<double> expression;
+	// Storage of the values the symbols of the variables are bound to
+	std::vector<double> values;
+};
+
+MathExpression::MathExpression() = default;
+MathExpression::~MathExpression() = default;
+
+MathExpression::MathExpression(const MathExpression &other)
+{
+	std::lock_guard<std::mutex> lock(other._mutex);
+	_expression = other._expression;
+}
+
+MathExpression &MathExpression::operator=(const MathExpression &other)
+{
+	if (this != &other) {
+		std::scoped_lock lock(_mutex, other._mutex);
+		_expression = other._expression;
+		_compiled = false;
+		_variableNames.clear();
+		_compiledExpression.reset();
+	}
+	return *this;
+}
+
+static std::string getSymbolName(size_t idx)
+{
+	return "advss_variable_" + std::to_string(idx);
+}
+
+static bool isPartOfToken(char c)
+{
+	return std::isalnum(static_cast<unsigned char>(c)) || c == '_' ||
+	       c == '.' || c == '$';
+}
+
+// Replaces all "${name}" placeholders with symbol names.
+// Placeholders directly next to other tokens, like in "1${name}", cannot be
+// replaced, as the text substitution would result in a different token.
+static std::optional<std::string>
+replacePlaceholders(const std::string &expression,
+		    std::vector<std::string> &names)
+{
+	std::string result;
+	size_t pos = 0;
+	while (true) {
+		const auto start = expression.find("${", pos);
+		const auto end = start == std::string::npos
+					 ? std::string::npos
+					 : expression.find('}', start + 2);
+		if (end == std::string::npos) {
+			result += expression.substr(pos);
+			break;
+		}
+
+		if ((start > 0 && isPartOfToken(expression[start - 1])) ||
+		    (end + 1 < expression.size() &&
+		     isPartOfToken(expression[end + 1]))) {
+			return {};
+		}
+
+		result += expression.substr(pos, start - pos);
+		const auto name = expression.substr(start + 2, end - start - 2);
+		auto it = std::find(names.begin(), names.end(), name);
+		if (it == names.end()) {
+			it = names.insert(names.end(), name);
+		}
+		result += getSymbolName(it - names.begin());
+		pos = end + 1;
+	}
+	return result;
+}
+
+bool MathExpression::Compile(const std::string &expression)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return CompileInternal(expression);
+}
+
+bool MathExpression::CompileInternal(const std::string &expression)
+{
+	if (_compiled && expression == _expression) {
+		return !!_compiledExpression;
+	}
+
+	_expression = expression;
+	_compiled = true;
+	_variableNames.clear();
+	_compiledExpression.reset();
+
+	const auto text = replacePlaceholders(expression, _variableNames);
+	if (!text) {
+		return false;
+	}
+
+	auto compiled = std::make_unique<CompiledExpression>();
+	compiled->values.resize(_variableNames.size(), 0.0);
+	compiled->symbolTable.add_function("random", randomValue);
+	for (size_t i = 0; i < _variableNames.size(); i++) {
+		compiled->symbolTable.add_variable(getSymbolName(i),
+						   compiled->values[i]);
+	}
+	compiled->expression.register_symbol_table(compiled->symbolTable);
+
+	exprtk::parser<double> parser;
+	if (!parser.compile(*text, compiled->expression)) {
+		return false;
+	}
+	_compiledExpression = std::move(compiled);
+	return true;
+}
+
+std::vector<std::string> MathExpression::GetVariableNames() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _variableNames;
+}
+
+std::optional<double>
+MathExpression::Evaluate(const std::vector<double> &values)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return EvaluateInternal(values);
+}
+
+std::optional<double> MathExpression::Evaluate(
+	const std::string &expression,
+	const std::function<std::optional<double>(const std::string &)>
+		&getValue)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (!CompileInternal(expression)) {
+		return {};
+	}
+
+	std::vector<double> values;
+	for (const auto &name : _variableNames) {
+		auto value = getValue(name);
+		if (!value) {
+			return {};
+		}
+		values.emplace_back(*value);
+	}
+	return EvaluateInternal(values);
+}
+
+std::optional<double>
+MathExpression::EvaluateInternal(const std::vector<double> &values)
+{
+	if (!_compiledExpression ||
+	    values.size() != _compiledExpression->values.size()) {
+		return {};
+	}
+	std::copy(values.begin(), values.end(),
+		  _compiledExpression->values.begin());
+	return _compiledExpression->expression.value();
+}
+
 bool IsValidNumber(const std::string &str)
 {
 	return GetDouble(str).has_value();
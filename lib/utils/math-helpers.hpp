@@ -1,14 +1,62 @@
 #pragma once
 #include "export-symbol-helper.hpp"
 
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <variant>
+#include <vector>
 #include <optional>
 
 namespace advss {
 
 std::variant<double, std::string>
 EvalMathExpression(const std::string &expression);
+
+// Compiles a math expression once, so it can be evaluated repeatedly without
+// having to parse it again.
+//
+// Variable placeholders of the form "${name}" contained in the expression are
+// bound to symbols instead of being substituted as text, so changing variable
+// values does not require the expression to be compiled again.
+// The values of the placeholders are passed to Evaluate() in the order of
+// GetVariableNames().
+//
+// All functions can be called from multiple threads concurrently.
+class MathExpression {
+public:
+	MathExpression();
+	~MathExpression();
+	// The compiled state is not shared between copies
+	MathExpression(const MathExpression &);
+	MathExpression &operator=(const MathExpression &);
+
+	bool Compile(const std::string &expression);
+	std::vector<std::string> GetVariableNames() const;
+	std::optional<double> Evaluate(const std::vector<double> &values);
+	// Compiles the expression, if it changed, and evaluates it using the
+	// values returned by getValue() for each variable name as one step
+	std::optional<double> Evaluate(
+		const std::string &expression,
+		const std::function<std::optional<double>(const std::string &)>
+			&getValue);
+
+private:
+	struct CompiledExpression;
+
+	bool CompileInternal(const std::string &expression);
+	std::optional<double>
+	EvaluateInternal(const std::vector<double> &values);
+
+	// Evaluating modifies the values the symbols are bound to
+	mutable std::mutex _mutex;
+	std::string _expression;
+	bool _compiled = false;
+	std::vector<std::string> _variableNames;
+	std::unique_ptr<CompiledExpression> _compiledExpression;
+};
+
 bool IsValidNumber(const std::string &str);
 EXPORT std::optional<double> GetDouble(const std::string &str);
 EXPORT std::optional<int> GetInt(const std::string &str);
@@ -0,0 +1,152 @@
+#pragma once
+#include "log-helper.hpp"
+#include "plugin-state-helpers.hpp"
+
+#include <asio.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace advss {
+
+// Runs the network I/O of all connections and sockets on a small, fixed
+// number of threads, so the number of threads does not grow with the number
+// of connections.
+//
+// Handlers of a single websocket connection are serialized using a strand
+// per connection by websocketpp itself.
+//
+// This header is only used by plugins with access to asio and each plugin
+// module gets its own instance, as the asio services cannot safely be shared
+// across module boundaries.
+class NetworkRuntime {
+public:
+	static NetworkRuntime &Instance();
+
+	asio::io_context &Context() { return _context; }
+	bool Stopped() const { return _stopped; }
+
+private:
+	NetworkRuntime();
+	void Run();
+	void Stop();
+
+	static constexpr unsigned maxThreadCount = 2;
+
+	asio::io_context _context;
+	asio::executor_work_guard<asio::io_context::executor_type> _workGuard;
+	std::vector<std::thread> _threads;
+	std::atomic_bool _stopped{false};
+};
+
+// Calls a function after a delay on one of the network threads.
+// Cancelling the timer waits until a callback, which is currently running,
+// has finished, so it is safe to destroy the objects used by the callback
+// afterwards.
+// The callback must not cancel the timer it was started by.
+class NetworkTimer {
+public:
+	NetworkTimer();
+	~NetworkTimer();
+
+	void Start(std::chrono::milliseconds delay,
+		   std::function<void()> callback);
+	void Cancel();
+
+private:
+	asio::steady_timer _timer;
+	std::mutex _mutex;
+	std::condition_variable _cv;
+	int _pendingCallbacks = 0;
+};
+
+inline NetworkRuntime &NetworkRuntime::Instance()
+{
+	// Intentionally leaked, as connections might still be destroyed
+	// during static deinitialization
+	static NetworkRuntime *runtime = new NetworkRuntime();
+	return *runtime;
+}
+
+inline NetworkRuntime::NetworkRuntime()
+	: _workGuard(asio::make_work_guard(_context))
+{
+	const unsigned count = std::clamp(
+		std::thread::hardware_concurrency() / 4, 1u, maxThreadCount);
+	for (unsigned i = 0; i < count; ++i) {
+		_threads.emplace_back(&NetworkRuntime::Run, this);
+	}
+	AddPluginCleanupStep([this]() { Stop(); });
+}
+
+inline void NetworkRuntime::Run()
+{
+	while (true) {
+		try {
+			_context.run();
+			return;
+		} catch (const std::exception &e) {
+			blog(LOG_WARNING, "exception in network thread: %s",
+			     e.what());
+		}
+	}
+}
+
+inline void NetworkRuntime::Stop()
+{
+	_stopped = true;
+	_workGuard.reset();
+	_context.stop();
+	for (auto &thread : _threads) {
+		if (thread.joinable()) {
+			thread.join();
+		}
+	}
+	_threads.clear();
+}
+
+inline NetworkTimer::NetworkTimer()
+	: _timer(NetworkRuntime::Instance().Context())
+{
+}
+
+inline NetworkTimer::~NetworkTimer()
+{
+	Cancel();
+}
+
+inline void NetworkTimer::Start(std::chrono::milliseconds delay,
+				std::function<void()> callback)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	++_pendingCallbacks;
+	_timer.expires_after(delay);
+	_timer.async_wait([this, callback](const asio::error_code &ec) {
+		if (!ec) {
+			callback();
+		}
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			--_pendingCallbacks;
+		}
+		_cv.notify_all();
+	});
+}
+
+inline void NetworkTimer::Cancel()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	_timer.cancel();
+	// Callbacks will no longer be called once the runtime was stopped
+	while (_pendingCallbacks > 0 && !NetworkRuntime::Instance().Stopped()) {
+		_cv.wait_for(lock, std::chrono::milliseconds(10));
+	}
+}
+
+} // namespace advss
@@ -121,6 +121,23 @@ int GetIntervalValue()
 	return GetSwitcher()->interval;
 }
 
+bool RequestMacroCheck()
+{
+	auto switcher = GetSwitcher();
+	if (!switcher) {
+		return true;
+	}
+	switcher->checkRequested = true;
+
+	// The request can only be missed if the main loop is about to wait,
+	// which it only does while holding the lock.
+	// Waiting for the lock is not an option, as it is held while
+	// connections are destroyed, which waits for the network threads.
+	std::unique_lock<std::mutex> lock(switcher->m, std::try_to_lock);
+	switcher->cv.notify_one();
+	return lock.owns_lock();
+}
+
 void SetPluginNoMatchBehavior(NoMatchBehavior behavior)
 {
 	GetSwitcher()->switchIfNotMatching = behavior;
@@ -25,6 +25,11 @@ EXPORT void StopPlugin();
 EXPORT void StartPlugin();
 EXPORT bool PluginIsRunning();
 EXPORT int GetIntervalValue();
+// Wakes up the main loop to check the macro conditions without waiting for
+// the end of the current interval.
+// Returns false if the main loop was busy and the request might have been
+// missed, in which case it should be repeated a little later.
+EXPORT bool RequestMacroCheck();
 
 enum class NoMatchBehavior { NO_SWITCH = 0, SWITCH = 1, RANDOM_SWITCH = 2 };
 EXPORT void SetPluginNoMatchBehavior(NoMatchBehavior);
@@ -87,6 +87,13 @@ RegexConfig RegexConfig::PartialMatchRegexConfig(bool enabled)
 	return regex;
 }
 
+bool RegexConfig::operator==(const RegexConfig &other) const
+{
+	return _enable == other._enable &&
+	       _partialMatch == other._partialMatch &&
+	       _options == other._options;
+}
+
 RegexConfigWidget::RegexConfigWidget(QWidget *parent, bool showEnable)
 	: QWidget(parent),
 	  _openSettings(new QToolButton()),
@@ -39,6 +39,8 @@ public:
 
 	EXPORT static RegexConfig PartialMatchRegexConfig(bool enabled = false);
 
+	EXPORT bool operator==(const RegexConfig &other) const;
+
 private:
 	bool _enable = false;
 	bool _partialMatch = false;
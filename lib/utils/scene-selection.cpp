@@ -1,4 +1,5 @@
 #include "scene-selection.hpp"
+#include "frontend-state.hpp"
 #include "obs-module-helper.hpp"
 #include "scene-group.hpp"
 #include "scene-switch-helpers.hpp"
@@ -119,13 +120,8 @@ OBSWeakSource SceneSelection::GetScene(bool advance) const
 		return GetPreviousScene();
 	case Type::CURRENT:
 		return GetCurrentScene();
-	case Type::PREVIEW: {
-		auto s = obs_frontend_get_current_preview_scene();
-		auto scene = obs_source_get_weak_source(s);
-		obs_weak_source_release(scene);
-		obs_source_release(s);
-		return scene;
-	}
+	case Type::PREVIEW:
+		return FrontendPreviewScene();
 	case Type::VARIABLE: {
 		auto var = _variable.lock();
 		if (!var) {
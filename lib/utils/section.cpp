@@ -44,6 +44,21 @@ Section::Section(const int animationDuration, QWidget *parent)
 
 void Section::Collapse(bool collapse)
 {
+	if (_createContent) {
+		if (collapse) {
+			const QSignalBlocker b(_toggleButton);
+			_toggleButton->setChecked(true);
+			_toggleButton->setArrowType(Qt::ArrowType::RightArrow);
+			_collapsed = true;
+			emit Collapsed(true);
+			return;
+		}
+		// Start the expand animation from the collapsed state
+		auto create = std::move(_createContent);
+		_createContent = {};
+		SetContent(create(), true);
+	}
+
 	_toggleButton->setChecked(collapse);
 	_toggleButton->setArrowType(collapse ? Qt::ArrowType::RightArrow
 					     : Qt::ArrowType::DownArrow);
@@ -62,6 +77,7 @@ void Section::SetContent(QWidget *w)
 
 void Section::SetContent(QWidget *w, bool collapsed)
 {
+	_createContent = {};
 	CleanUpPreviousContent();
 	delete _contentArea;
 
@@ -101,6 +117,37 @@ void Section::SetContent(QWidget *w, bool collapsed)
 	_collapsed = collapsed;
 }
 
+void Section::SetLazyContent(const std::function<QWidget *()> &create,
+			     bool collapsed)
+{
+	CleanUpPreviousContent();
+	delete _contentArea;
+	_contentArea = nullptr;
+	_content = nullptr;
+	if (_toggleAnimation) {
+		_toggleAnimation->deleteLater();
+		_toggleAnimation = nullptr;
+	}
+	_createContent = create;
+
+	setMinimumHeight(0);
+	const QSignalBlocker b(_toggleButton);
+	_toggleButton->setChecked(collapsed);
+	_toggleButton->setArrowType(collapsed ? Qt::ArrowType::RightArrow
+					      : Qt::ArrowType::DownArrow);
+	_collapsed = collapsed;
+}
+
+void Section::CreateContent()
+{
+	if (!_createContent) {
+		return;
+	}
+	auto create = std::move(_createContent);
+	_createContent = {};
+	SetContent(create(), _collapsed);
+}
+
 void Section::AddHeaderWidget(QWidget *w)
 {
 	_headerWidgetLayout->addWidget(w);
@@ -7,6 +7,8 @@
 #include <QToolButton>
 #include <QWidget>
 
+#include <functional>
+
 namespace advss {
 
 class Section : public QWidget {
@@ -18,8 +20,15 @@ public:
 
 	void SetContent(QWidget *w);
 	void SetContent(QWidget *w, bool collapsed);
+	// The content widget will only be created once the section is
+	// expanded or CreateContent() is called
+	void SetLazyContent(const std::function<QWidget *()> &create,
+			    bool collapsed);
+	void CreateContent();
+	bool HasPendingContent() const { return !!_createContent; }
 	void AddHeaderWidget(QWidget *);
 	void SetCollapsed(bool);
+	bool IsCollapsed() const { return _collapsed; }
 
 protected:
 	bool eventFilter(QObject *obj, QEvent *event) override;
@@ -43,6 +52,7 @@ private:
 	QParallelAnimationGroup *_contentAnimation = nullptr;
 	QScrollArea *_contentArea = nullptr;
 	QWidget *_content = nullptr;
+	std::function<QWidget *()> _createContent;
 	int _animationDuration;
 	std::atomic_bool _transitioning = {false};
 	std::atomic_bool _collapsed = {false};
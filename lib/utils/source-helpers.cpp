@@ -1,9 +1,206 @@
 #include "source-helpers.hpp"
+#include "frontend-state.hpp"
+#include "plugin-state-helpers.hpp"
 
 #include <obs-frontend-api.h>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
 
 namespace advss {
 
+namespace {
+
+// Caches the results of looking up sources, transitions, and filters by name,
+// as resolving a name requires either the global source list lock or
+// iterating over all available transitions.
+//
+// Cached sources are validated on every lookup by checking if the source still
+// exists and still has the requested name.
+// Cached failed lookups are discarded whenever a source is created, renamed,
+// or the list of transitions changes.
+class SourceResolutionCache {
+public:
+	enum class Kind { SOURCE, TRANSITION, FILTER };
+
+	static SourceResolutionCache &Instance();
+	OBSWeakSource Resolve(Kind, const char *name,
+			      const std::function<OBSWeakSource()> &resolve,
+			      const OBSWeakSource &parent = nullptr,
+			      bool cacheFailedLookups = true);
+	void Clear();
+
+private:
+	SourceResolutionCache() = default;
+
+	struct Key {
+		Kind kind;
+		obs_weak_source_t *parent;
+		std::string name;
+		bool operator==(const Key &other) const
+		{
+			return kind == other.kind && parent == other.parent &&
+			       name == other.name;
+		}
+	};
+	struct KeyHash {
+		size_t operator()(const Key &key) const
+		{
+			return std::hash<std::string>{}(key.name) ^
+			       (std::hash<obs_weak_source_t *>{}(key.parent)
+				<< 1) ^
+			       static_cast<size_t>(key.kind);
+		}
+	};
+
+	void Connect();
+	void Disconnect();
+	static void SourcesChanged(void *, calldata_t *);
+	static void FrontendEvent(enum obs_frontend_event, void *);
+
+	std::mutex _mutex;
+	std::unordered_map<Key, OBSWeakSource, KeyHash> _cache;
+	std::vector<OBSSignal> _signals;
+	bool _connected = false;
+
+	static bool _setupDone;
+	static bool Setup();
+};
+
+bool SourceResolutionCache::_setupDone = SourceResolutionCache::Setup();
+
+bool SourceResolutionCache::Setup()
+{
+	AddPluginInitStep([]() { Instance().Connect(); });
+	AddPluginCleanupStep([]() { Instance().Disconnect(); });
+	obs_frontend_add_event_callback(FrontendEvent, nullptr);
+	return true;
+}
+
+SourceResolutionCache &SourceResolutionCache::Instance()
+{
+	static SourceResolutionCache cache;
+	return cache;
+}
+
+void SourceResolutionCache::Connect()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto sh = obs_get_signal_handler();
+	for (const auto signal : {"source_create", "source_destroy",
+				  "source_remove", "source_rename"}) {
+		_signals.emplace_back(sh, signal, SourcesChanged, this);
+	}
+	_connected = true;
+}
+
+void SourceResolutionCache::Disconnect()
+{
+	std::vector<OBSSignal> signals;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_connected = false;
+		_cache.clear();
+		std::swap(signals, _signals);
+	}
+	// Signals are disconnected without holding the lock to avoid
+	// deadlocks with signal handlers running at the same time
+	signals.clear();
+}
+
+void SourceResolutionCache::Clear()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_cache.clear();
+}
+
+void SourceResolutionCache::SourcesChanged(void *data, calldata_t *)
+{
+	static_cast<SourceResolutionCache *>(data)->Clear();
+}
+
+void SourceResolutionCache::FrontendEvent(enum obs_frontend_event event,
+					  void *)
+{
+	switch (event) {
+	case OBS_FRONTEND_EVENT_TRANSITION_LIST_CHANGED:
+	case OBS_FRONTEND_EVENT_SCENE_COLLECTION_CHANGED:
+	case OBS_FRONTEND_EVENT_SCENE_COLLECTION_CLEANUP:
+		Instance().Clear();
+		break;
+	default:
+		break;
+	}
+}
+
+static bool isValidCacheEntry(const OBSWeakSource &weakSource,
+			      const char *name, const OBSWeakSource &parent)
+{
+	OBSSourceAutoRelease source = obs_weak_source_get_source(weakSource);
+	if (!source) {
+		return false;
+	}
+	auto sourceName = obs_source_get_name(source);
+	if (!sourceName || strcmp(sourceName, name) != 0) {
+		return false;
+	}
+	if (!parent) {
+		return true;
+	}
+	auto filterParent = obs_filter_get_parent(source);
+	return filterParent &&
+	       obs_weak_source_references_source(parent, filterParent);
+}
+
+OBSWeakSource
+SourceResolutionCache::Resolve(Kind kind, const char *name,
+			       const std::function<OBSWeakSource()> &resolve,
+			       const OBSWeakSource &parent,
+			       bool cacheFailedLookups)
+{
+	Key key{kind, parent.Get(), name};
+	bool isCached = false;
+	OBSWeakSource cached;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (!_connected) {
+			return resolve();
+		}
+		auto it = _cache.find(key);
+		if (it != _cache.end()) {
+			isCached = true;
+			cached = it->second;
+		}
+	}
+
+	// Validation has to happen without holding the lock, as releasing the
+	// last reference of a source will emit the "source_destroy" signal
+	if (isCached &&
+	    (!cached || isValidCacheEntry(cached, name, parent))) {
+		return cached;
+	}
+
+	auto result = resolve();
+	if (!result && !cacheFailedLookups) {
+		return result;
+	}
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (!_connected) {
+		return result;
+	}
+	// Avoid growing indefinitely if names keep changing, which can for
+	// example happen for variable based selections
+	constexpr size_t maxCacheSize = 1024;
+	if (_cache.size() >= maxCacheSize) {
+		_cache.clear();
+	}
+	_cache[key] = result;
+	return result;
+}
+
+} // namespace
+
 bool WeakSourceValid(obs_weak_source_t *ws)
 {
 	obs_source_t *source = obs_weak_source_get_source(ws);
@@ -26,7 +223,7 @@ std::string GetWeakSourceName(obs_weak_source_t *weak_source)
 	return name;
 }
 
-OBSWeakSource GetWeakSourceByName(const char *name)
+static OBSWeakSource getWeakSourceByNameHelper(const char *name)
 {
 	OBSWeakSource weak;
 	obs_source_t *source = obs_get_source_by_name(name);
@@ -39,24 +236,26 @@ OBSWeakSource GetWeakSourceByName(const char *name)
 	return weak;
 }
 
+OBSWeakSource GetWeakSourceByName(const char *name)
+{
+	if (!name) {
+		return nullptr;
+	}
+	return SourceResolutionCache::Instance().Resolve(
+		SourceResolutionCache::Kind::SOURCE, name,
+		[name]() { return getWeakSourceByNameHelper(name); });
+}
+
 OBSWeakSource GetWeakSourceByQString(const QString &name)
 {
 	return GetWeakSourceByName(name.toUtf8().constData());
 }
 
-OBSWeakSource GetWeakTransitionByName(const char *transitionName)
+static OBSWeakSource getWeakTransitionByNameHelper(const char *transitionName)
 {
 	OBSWeakSource weak;
 	obs_source_t *source = nullptr;
 
-	if (strcmp(transitionName, "Default") == 0) {
-		source = obs_frontend_get_current_transition();
-		weak = obs_source_get_weak_source(source);
-		obs_source_release(source);
-		obs_weak_source_release(weak);
-		return weak;
-	}
-
 	obs_frontend_source_list *transitions = new obs_frontend_source_list();
 	obs_frontend_get_transitions(transitions);
 	bool match = false;
@@ -80,12 +279,28 @@ OBSWeakSource GetWeakTransitionByName(const char *transitionName)
 	return weak;
 }
 
+OBSWeakSource GetWeakTransitionByName(const char *transitionName)
+{
+	if (!transitionName) {
+		return nullptr;
+	}
+	if (strcmp(transitionName, "Default") == 0) {
+		return FrontendCurrentTransition();
+	}
+	return SourceResolutionCache::Instance().Resolve(
+		SourceResolutionCache::Kind::TRANSITION, transitionName,
+		[transitionName]() {
+			return getWeakTransitionByNameHelper(transitionName);
+		});
+}
+
 OBSWeakSource GetWeakTransitionByQString(const QString &name)
 {
 	return GetWeakTransitionByName(name.toUtf8().constData());
 }
 
-OBSWeakSource GetWeakFilterByName(OBSWeakSource source, const char *name)
+static OBSWeakSource getWeakFilterByNameHelper(const OBSWeakSource &source,
+						const char *name)
 {
 	OBSWeakSource weak;
 	auto s = obs_weak_source_get_source(source);
@@ -99,6 +314,21 @@ OBSWeakSource GetWeakFilterByName(OBSWeakSource source, const char *name)
 	return weak;
 }
 
+OBSWeakSource GetWeakFilterByName(OBSWeakSource source, const char *name)
+{
+	if (!source || !name) {
+		return nullptr;
+	}
+	// Adding a filter to a source does not emit a global signal, so failed
+	// lookups cannot be cached
+	return SourceResolutionCache::Instance().Resolve(
+		SourceResolutionCache::Kind::FILTER, name,
+		[&source, name]() {
+			return getWeakFilterByNameHelper(source, name);
+		},
+		source, false);
+}
+
 OBSWeakSource GetWeakFilterByQString(OBSWeakSource source, const QString &name)
 {
 	return GetWeakFilterByName(source, name.toUtf8().constData());
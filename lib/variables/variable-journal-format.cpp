@@ -0,0 +1,104 @@
+#include "variable-journal-format.hpp"
+
+#include <algorithm>
+#include <nlohmann/json.hpp>
+
+namespace advss {
+
+// Number of records the journal may contain in addition to the latest value
+// of each variable before it is compacted
+constexpr size_t compactionThreshold = 1000;
+
+std::string CreateJournalHeader(const std::string &id)
+{
+	nlohmann::json header;
+	header["id"] = id;
+	return header.dump() + "\n";
+}
+
+std::string CreateJournalRecord(const std::string &name, uint64_t sequence,
+				const std::string &value)
+{
+	nlohmann::json json;
+	json["name"] = name;
+	json["sequence"] = sequence;
+	json["value"] = value;
+	// Values are not guaranteed to be valid UTF-8
+	return json.dump(-1, ' ', false,
+			 nlohmann::json::error_handler_t::replace) +
+	       "\n";
+}
+
+std::string CreateCompactJournal(const std::string &id,
+				 const JournalEntries &entries)
+{
+	std::string result = CreateJournalHeader(id);
+	for (const auto &[name, entry] : entries) {
+		result += CreateJournalRecord(name, entry.sequence,
+					      entry.value);
+	}
+	return result;
+}
+
+JournalContents ParseJournal(const std::string &data)
+{
+	JournalContents contents;
+	contents.truncated = !data.empty() && data.back() != '\n';
+
+	bool isHeader = true;
+	size_t lineStart = 0;
+	while (lineStart < data.size()) {
+		auto lineEnd = data.find('\n', lineStart);
+		if (lineEnd == std::string::npos) {
+			lineEnd = data.size();
+		}
+		const auto line = data.substr(lineStart, lineEnd - lineStart);
+		lineStart = lineEnd + 1;
+
+		try {
+			const auto json = nlohmann::json::parse(line);
+			if (isHeader) {
+				contents.id = json.at("id").get<std::string>();
+				isHeader = false;
+				continue;
+			}
+
+			const auto name = json.at("name").get<std::string>();
+			const auto sequence =
+				json.at("sequence").get<uint64_t>();
+			auto &entry = contents.entries[name];
+			if (sequence >= entry.sequence) {
+				entry = {sequence,
+					 json.at("value").get<std::string>()};
+			}
+			contents.sequence =
+				std::max(contents.sequence, sequence);
+			++contents.recordCount;
+		} catch (const nlohmann::json::exception &) {
+			// Incomplete records are skipped
+			if (isHeader) {
+				return {};
+			}
+		}
+	}
+	return contents;
+}
+
+JournalEntries GetJournalEntriesAfter(const JournalEntries &entries,
+				      uint64_t sequence)
+{
+	JournalEntries result;
+	for (const auto &[name, entry] : entries) {
+		if (entry.sequence > sequence) {
+			result.emplace(name, entry);
+		}
+	}
+	return result;
+}
+
+bool JournalShouldBeCompacted(size_t recordCount, size_t entryCount)
+{
+	return recordCount > entryCount + compactionThreshold;
+}
+
+} // namespace advss
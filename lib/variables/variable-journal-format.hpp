@@ -0,0 +1,38 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace advss {
+
+// The journal consists of a header line containing the journal id followed by
+// one JSON record per line for each modification of a variable.
+
+struct JournalEntry {
+	uint64_t sequence = 0;
+	std::string value;
+};
+
+// Latest value of each variable
+using JournalEntries = std::unordered_map<std::string, JournalEntry>;
+
+struct JournalContents {
+	std::string id;
+	uint64_t sequence = 0;
+	size_t recordCount = 0;
+	// The last record is incomplete if OBS crashed while it was written
+	bool truncated = false;
+	JournalEntries entries;
+};
+
+std::string CreateJournalHeader(const std::string &id);
+std::string CreateJournalRecord(const std::string &name, uint64_t sequence,
+				const std::string &value);
+std::string CreateCompactJournal(const std::string &id,
+				 const JournalEntries &entries);
+JournalContents ParseJournal(const std::string &data);
+JournalEntries GetJournalEntriesAfter(const JournalEntries &entries,
+				      uint64_t sequence);
+bool JournalShouldBeCompacted(size_t recordCount, size_t entryCount);
+
+} // namespace advss
@@ -0,0 +1,321 @@
+#include "variable-journal.hpp"
+#include "log-helper.hpp"
+#include "plugin-state-helpers.hpp"
+#include "variable.hpp"
+
+#include <obs-frontend-api.h>
+#include <obs-module.h>
+#include <obs.hpp>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QUrl>
+#include <QUuid>
+
+namespace advss {
+
+static bool setup();
+static bool setupDone = setup();
+
+static bool setup()
+{
+	AddPluginInitStep([]() {
+		SetSavedVariableChangeCallback([](const std::string &name,
+						  const std::string &value) {
+			VariableJournal::Instance().Record(name, value);
+		});
+	});
+	AddPluginCleanupStep([]() { VariableJournal::Instance().Stop(); });
+	return true;
+}
+
+static std::string getJournalPath()
+{
+	auto sceneCollectionName = obs_frontend_get_current_scene_collection();
+	if (!sceneCollectionName) {
+		return "";
+	}
+	const std::string fileName =
+		"variable-journals/" +
+		QUrl::toPercentEncoding(QString::fromUtf8(sceneCollectionName))
+			.toStdString() +
+		".jsonl";
+	bfree(sceneCollectionName);
+
+	auto path = obs_module_config_path(fileName.c_str());
+	if (!path) {
+		return "";
+	}
+	std::string result = path;
+	bfree(path);
+
+	const auto dirPath = QFileInfo(QString::fromStdString(result))
+				     .absolutePath();
+	if (!QDir().mkpath(dirPath)) {
+		blog(LOG_WARNING,
+		     "failed to create variable journal directory");
+		return "";
+	}
+	return result;
+}
+
+static void appendToJournal(const std::string &path,
+			    const std::vector<std::string> &records)
+{
+	if (path.empty() || records.empty()) {
+		return;
+	}
+
+	QFile file(QString::fromStdString(path));
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+		blog(LOG_WARNING, "failed to open variable journal \"%s\"",
+		     path.c_str());
+		return;
+	}
+	for (const auto &record : records) {
+		file.write(record.data(), record.size());
+	}
+
+	// The data is handed to the operating system right away, so it will
+	// not be lost if OBS crashes
+	file.flush();
+}
+
+static void writeJournal(const std::string &path, const std::string &id,
+			 const JournalEntries &entries)
+{
+	if (path.empty()) {
+		return;
+	}
+
+	// QSaveFile writes to a temporary file first, which is then renamed,
+	// so the previous journal is kept if writing fails
+	QSaveFile file(QString::fromStdString(path));
+	if (!file.open(QIODevice::WriteOnly)) {
+		blog(LOG_WARNING, "failed to open variable journal \"%s\"",
+		     path.c_str());
+		return;
+	}
+
+	const auto data = CreateCompactJournal(id, entries);
+	file.write(data.data(), data.size());
+
+	if (!file.commit()) {
+		blog(LOG_WARNING, "failed to write variable journal \"%s\"",
+		     path.c_str());
+	}
+}
+
+static JournalContents readJournal(const std::string &path)
+{
+	QFile file(QString::fromStdString(path));
+	if (!file.open(QIODevice::ReadOnly)) {
+		return {};
+	}
+	return ParseJournal(file.readAll().toStdString());
+}
+
+VariableJournal &VariableJournal::Instance()
+{
+	static VariableJournal journal;
+	return journal;
+}
+
+VariableJournal::~VariableJournal()
+{
+	Stop();
+}
+
+void VariableJournal::Record(const std::string &name, const std::string &value)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (!_active) {
+		return;
+	}
+
+	++_sequence;
+	_entries[name] = {_sequence, value};
+	_pending.emplace_back(CreateJournalRecord(name, _sequence, value));
+	++_recordCount;
+	_cv.notify_one();
+}
+
+void VariableJournal::Save(obs_data_t *obj)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (!_active) {
+		return;
+	}
+
+	OBSDataAutoRelease data = obs_data_create();
+	obs_data_set_string(data, "id", _id.c_str());
+	obs_data_set_int(data, "sequence", static_cast<long long>(_sequence));
+	obs_data_set_obj(obj, "variableJournal", data);
+}
+
+void VariableJournal::Load(obs_data_t *obj, bool isImport)
+{
+	std::lock_guard<std::mutex> fileLock(_fileMutex);
+
+	// Records of the previously loaded settings still have to be written
+	// to the previous journal
+	std::vector<std::string> pending;
+	std::string previousPath;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_active = false;
+		pending = std::move(_pending);
+		_pending.clear();
+		previousPath = _path;
+	}
+	appendToJournal(previousPath, pending);
+
+	const auto path = getJournalPath();
+	if (path.empty()) {
+		return;
+	}
+
+	OBSDataAutoRelease data = obs_data_get_obj(obj, "variableJournal");
+	const std::string savedId = obs_data_get_string(data, "id");
+	const auto savedSequence =
+		static_cast<uint64_t>(obs_data_get_int(data, "sequence"));
+
+	auto journal = readJournal(path);
+	std::string id;
+	uint64_t sequence = 0;
+	JournalEntries entries;
+	size_t recordCount = 0;
+
+	if (isImport && !journal.id.empty()) {
+		// The journal belongs to the settings of the scene collection
+		// and not to the imported ones, so it is neither replayed nor
+		// rewritten and new modifications are appended to it
+		id = journal.id;
+		sequence = journal.sequence;
+		entries = std::move(journal.entries);
+		recordCount = journal.recordCount;
+
+		// Records must not be appended to an incomplete line
+		if (journal.truncated) {
+			writeJournal(path, id, entries);
+			recordCount = entries.size();
+		}
+	} else if (!isImport && !journal.id.empty() &&
+		   (savedId.empty() || savedId == journal.id)) {
+		// Settings without a journal position were either saved before
+		// any modification was recorded or OBS crashed before they were
+		// saved once, so the whole journal applies to them
+		id = journal.id;
+		sequence = std::max(journal.sequence, savedSequence);
+
+		const auto newerEntries =
+			GetJournalEntriesAfter(journal.entries, savedSequence);
+		for (const auto &item : GetVariables()) {
+			auto variable =
+				std::dynamic_pointer_cast<Variable>(item);
+			if (!variable || variable->GetSaveAction() !=
+						 Variable::SaveAction::SAVE) {
+				continue;
+			}
+
+			auto it = newerEntries.find(variable->Name());
+			if (it == newerEntries.end()) {
+				continue;
+			}
+
+			variable->SetValue(it->second.value);
+			entries.emplace(*it);
+		}
+
+		if (!entries.empty()) {
+			blog(LOG_INFO,
+			     "restored %d variable values from journal",
+			     (int)entries.size());
+		}
+		writeJournal(path, id, entries);
+		recordCount = entries.size();
+	} else {
+		// Continue the journal position of the loaded settings, so
+		// modifications are replayed even if they are never saved again
+		id = savedId.empty()
+			     ? QUuid::createUuid().toString().toStdString()
+			     : savedId;
+		sequence = savedSequence;
+		writeJournal(path, id, entries);
+	}
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	_path = path;
+	_id = id;
+	_sequence = sequence;
+	_entries = std::move(entries);
+	_recordCount = recordCount;
+	_active = true;
+	StartWorker();
+}
+
+void VariableJournal::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop = true;
+		_active = false;
+	}
+	_cv.notify_all();
+
+	// Pending records are still written before the worker exits
+	if (_thread.joinable()) {
+		_thread.join();
+	}
+}
+
+void VariableJournal::StartWorker()
+{
+	if (_thread.joinable()) {
+		return;
+	}
+	_stop = false;
+	_thread = std::thread(&VariableJournal::Worker, this);
+}
+
+bool VariableJournal::ShouldCompact() const
+{
+	return JournalShouldBeCompacted(_recordCount, _entries.size());
+}
+
+void VariableJournal::Worker()
+{
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_cv.wait(lock, [this]() {
+				return _stop || !_pending.empty();
+			});
+			if (_stop && _pending.empty()) {
+				return;
+			}
+		}
+
+		std::lock_guard<std::mutex> fileLock(_fileMutex);
+		std::unique_lock<std::mutex> lock(_mutex);
+		const auto path = _path;
+
+		if (ShouldCompact()) {
+			const auto id = _id;
+			const auto entries = _entries;
+			_pending.clear();
+			_recordCount = entries.size();
+			lock.unlock();
+			writeJournal(path, id, entries);
+			continue;
+		}
+
+		const auto records = std::move(_pending);
+		_pending.clear();
+		lock.unlock();
+		appendToJournal(path, records);
+	}
+}
+
+} // namespace advss
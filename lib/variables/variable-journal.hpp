@@ -0,0 +1,63 @@
+#pragma once
+#include "variable-journal-format.hpp"
+
+#include <obs-data.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace advss {
+
+// Records modifications of variables, which are configured to be saved, as
+// they happen, so their values are not lost if OBS is not shut down cleanly.
+//
+// Each modification is appended to a journal file, which is kept per scene
+// collection in the plugin's config directory.
+// The journal position is stored alongside the variables whenever the settings
+// are saved and all modifications, which happened after that point, are
+// replayed when the settings are loaded again.
+//
+// The journal is rewritten to only contain the latest value of each variable
+// whenever it grows too large.
+//
+// Imported settings are loaded without replaying the journal, as it belongs to
+// the settings of the scene collection.
+class VariableJournal {
+public:
+	static VariableJournal &Instance();
+
+	void Record(const std::string &name, const std::string &value);
+	void Save(obs_data_t *obj);
+	void Load(obs_data_t *obj, bool isImport = false);
+	void Stop();
+
+private:
+	VariableJournal() = default;
+	~VariableJournal();
+
+	void Worker();
+	void StartWorker();
+	bool ShouldCompact() const;
+
+	// Protects the journal file and is always locked before _mutex
+	std::mutex _fileMutex;
+
+	std::mutex _mutex;
+	std::condition_variable _cv;
+	std::thread _thread;
+	bool _stop = false;
+	bool _active = false;
+
+	std::string _path;
+	std::string _id;
+	uint64_t _sequence = 0;
+	std::vector<std::string> _pending;
+	size_t _recordCount = 0;
+	JournalEntries _entries;
+};
+
+} // namespace advss
@@ -5,6 +5,9 @@
 #include "utility.hpp"
 
 #include <QGridLayout>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
 
 namespace advss {
 
@@ -14,6 +17,9 @@ static std::deque<std::shared_ptr<Item>> variables;
 // when resolving strings containing variables, etc.
 static std::chrono::high_resolution_clock::time_point lastVariableChange{};
 
+static std::function<void(const std::string &, const std::string &)>
+	savedVariableChangeCallback;
+
 Variable::Variable() : Item()
 {
 	lastVariableChange = std::chrono::high_resolution_clock::now();
@@ -31,10 +37,11 @@ void Variable::Load(obs_data_t *obj)
 		static_cast<SaveAction>(obs_data_get_int(obj, "saveAction"));
 	_defaultValue = obs_data_get_string(obj, "defaultValue");
 
+	std::lock_guard<std::mutex> lock(_mutex);
 	if (_saveAction == SaveAction::SAVE) {
-		SetValue(obs_data_get_string(obj, "value"));
+		SetValueHelper(obs_data_get_string(obj, "value"));
 	} else if (_saveAction == SaveAction::SET_DEFAULT) {
-		SetValue(_defaultValue);
+		SetValueHelper(_defaultValue);
 	}
 
 	lastVariableChange = std::chrono::high_resolution_clock::now();
@@ -64,30 +71,86 @@ std::string Variable::Value(bool updateLastUsed) const
 
 std::optional<double> Variable::DoubleValue() const
 {
-	return GetDouble(Value());
+	std::lock_guard<std::mutex> lock(_mutex);
+	UpdateLastUsed();
+	return _doubleValue;
 }
 
 std::optional<int> Variable::IntValue() const
 {
-	return GetInt(Value());
+	std::lock_guard<std::mutex> lock(_mutex);
+	UpdateLastUsed();
+	return _intValue;
 }
 
 void Variable::SetValue(const std::string &value)
+{
+	SetValue(value, GetDouble(value), GetInt(value));
+}
+
+// Uses the shortest representation, which is parsed back to the same value, so
+// the numeric values of the variable do not change when its string value is
+// parsed again, e.g. after saving and loading it
+static std::string toLosslessString(double value)
+{
+	std::string result;
+	for (int precision = 6; precision <= 17; ++precision) {
+		std::ostringstream stream;
+		stream << std::setprecision(precision) << value;
+		result = stream.str();
+		if (GetDouble(result) == value) {
+			break;
+		}
+	}
+	return result;
+}
+
+void Variable::SetValue(double value)
+{
+	if (!std::isfinite(value)) {
+		SetValue(ToString(value));
+		return;
+	}
+
+	// The value does not have to be parsed again, as its string
+	// representation is lossless
+	const auto stringValue = toLosslessString(value);
+	SetValue(stringValue, value, GetInt(stringValue));
+}
+
+void Variable::SetValue(const std::string &value,
+			const std::optional<double> &doubleValue,
+			const std::optional<int> &intValue)
 {
 	std::lock_guard<std::mutex> lock(_mutex);
+	SetValueHelper(value, doubleValue, intValue);
+
+	// Invoked while still holding the lock, so the order in which changes
+	// are reported matches the order in which they were applied
+	if (_saveAction == SaveAction::SAVE && savedVariableChangeCallback) {
+		savedVariableChangeCallback(_name, _value);
+	}
+}
+
+void Variable::SetValueHelper(const std::string &value)
+{
+	SetValueHelper(value, GetDouble(value), GetInt(value));
+}
+
+void Variable::SetValueHelper(const std::string &value,
+			      const std::optional<double> &doubleValue,
+			      const std::optional<int> &intValue)
+{
 	_previousValue = _value;
 	_value = value;
+	_doubleValue = doubleValue;
+	_intValue = intValue;
 
 	UpdateLastUsed();
 	UpdateLastChanged();
 	lastVariableChange = std::chrono::high_resolution_clock::now();
 }
 
-void Variable::SetValue(double value)
-{
-	SetValue(ToString(value));
-}
-
 std::optional<uint64_t> Variable::GetSecondsSinceLastUse() const
 {
 	if (_lastUsed.time_since_epoch().count() == 0) {
@@ -200,11 +263,11 @@ bool VariableSettingsDialog::AskForSettings(QWidget *parent, Variable &settings)
 	}
 
 	settings._name = dialog._name->text().toStdString();
-	settings.SetValue(dialog._value->toPlainText().toStdString());
 	settings._defaultValue =
 		dialog._defaultValue->toPlainText().toStdString();
 	settings._saveAction =
 		static_cast<Variable::SaveAction>(dialog._save->currentIndex());
+	settings.SetValue(dialog._value->toPlainText().toStdString());
 	lastVariableChange = std::chrono::high_resolution_clock::now();
 
 	return true;
@@ -390,6 +453,13 @@ static bool variableWithNameExists(const std::string &name)
 	return !!GetVariableByName(name);
 }
 
+void SetSavedVariableChangeCallback(
+	const std::function<void(const std::string &, const std::string &)>
+		&callback)
+{
+	savedVariableChangeCallback = callback;
+}
+
 void SaveVariables(obs_data_t *obj)
 {
 	obs_data_array_t *variablesArray = obs_data_array_create();
@@ -3,6 +3,7 @@
 #include "item-selection-helpers.hpp"
 #include "resizing-text-edit.hpp"
 
+#include <functional>
 #include <mutex>
 #include <obs-data.h>
 #include <optional>
@@ -46,10 +47,22 @@ public:
 	void UpdateLastChanged();
 
 private:
+	void SetValue(const std::string &value,
+		      const std::optional<double> &doubleValue,
+		      const std::optional<int> &intValue);
+	void SetValueHelper(const std::string &value);
+	void SetValueHelper(const std::string &value,
+			    const std::optional<double> &doubleValue,
+			    const std::optional<int> &intValue);
+
 	SaveAction _saveAction = SaveAction::DONT_SAVE;
 	std::string _value = "";
 	std::string _previousValue = "";
 	std::string _defaultValue = "";
+	// The numeric representations of the value are only determined when
+	// the value changes instead of every time they are used
+	std::optional<double> _doubleValue;
+	std::optional<int> _intValue;
 	int _valueChangeCount = 0;
 	mutable std::chrono::high_resolution_clock::time_point _lastUsed;
 	mutable std::chrono::high_resolution_clock::time_point _lastChanged;
@@ -115,10 +128,17 @@ EXPORT std::weak_ptr<Variable> GetWeakVariableByQString(const QString &name);
 EXPORT std::string GetWeakVariableName(std::weak_ptr<Variable>);
 EXPORT QStringList GetVariablesNameList();
 
+// The callback is invoked with the name and new value whenever a variable,
+// which is configured to be saved, is modified.
+// It is not invoked while variables are being loaded.
+void SetSavedVariableChangeCallback(
+	const std::function<void(const std::string &, const std::string &)> &);
+
 void SaveVariables(obs_data_t *obj);
 void LoadVariables(obs_data_t *obj);
 void ImportVariables(obs_data_t *obj);
 
-std::chrono::high_resolution_clock::time_point GetLastVariableChangeTime();
+EXPORT std::chrono::high_resolution_clock::time_point
+GetLastVariableChangeTime();
 
 } // namespace advss
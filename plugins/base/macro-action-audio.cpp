@@ -3,8 +3,10 @@
 #include "layout-helpers.hpp"
 #include "macro-helpers.hpp"
 #include "selection-helpers.hpp"
+#include "source-helpers.hpp"
 
 #include <chrono>
+#include <cmath>
 
 namespace advss {
 
@@ -44,17 +46,6 @@ static const std::map<MacroActionAudio::FadeType, std::string> fadeTypes = {
 	 "AdvSceneSwitcher.action.audio.fade.type.rate"},
 };
 
-namespace {
-struct FadeInfo {
-	std::atomic_bool active = {false};
-	std::atomic_int id = {0};
-};
-} // namespace
-
-static FadeInfo masterAudioFade;
-static std::unordered_map<std::string, FadeInfo> audioFades;
-
-constexpr auto fadeInterval = std::chrono::milliseconds(100);
 constexpr float minFade = 0.000001f;
 
 // For backwards compatibility
@@ -73,42 +64,16 @@ auto get_master_volume = obs_get_master_volume;
 auto set_master_volume = obs_set_master_volume;
 #endif
 
-void MacroActionAudio::SetFadeActive(bool value) const
+std::string MacroActionAudio::GetFadeKey() const
 {
-	if (_action == Action::SOURCE_VOLUME) {
-		audioFades[_audioSource.ToString()].active = value;
-	} else {
-		masterAudioFade.active = value;
+	if (_action != Action::SOURCE_VOLUME) {
+		return "audio.volume.master";
 	}
-}
-
-bool MacroActionAudio::FadeActive() const
-{
-	bool active = true;
-	if (_action == Action::SOURCE_VOLUME) {
-		auto it = audioFades.find(_audioSource.ToString());
-		if (it == audioFades.end()) {
-			return false;
-		}
-		active = it->second.active;
-	} else {
-		active = masterAudioFade.active;
-	}
-
-	return active;
-}
-
-std::atomic_int *MacroActionAudio::GetFadeIdPtr() const
-{
-
-	if (_action == Action::SOURCE_VOLUME) {
-		auto it = audioFades.find(_audioSource.ToString());
-		if (it == audioFades.end()) {
-			return nullptr;
-		}
-		return &it->second.id;
+	const auto name = GetWeakSourceName(_audioSource.GetSource());
+	if (name.empty()) {
+		return "";
 	}
-	return &masterAudioFade.id;
+	return "audio.volume." + name;
 }
 
 float MacroActionAudio::GetVolume() const
@@ -143,56 +108,13 @@ float MacroActionAudio::GetCurrentVolume() const
 	return curVol;
 }
 
-void MacroActionAudio::FadeVolume() const
-{
-	float vol = GetVolume();
-	float curVol = GetCurrentVolume();
-	bool volIncrease = curVol <= vol;
-	float volDiff = (volIncrease) ? vol - curVol : curVol - vol;
-	int nrSteps = 0;
-	float volStep = 0.;
-	if (_fadeType == FadeType::DURATION) {
-		nrSteps = _duration.Milliseconds() / fadeInterval.count();
-		volStep = volDiff / nrSteps;
-	} else {
-		volStep = _rate / 1000.0f;
-		nrSteps = volDiff / volStep;
-	}
-
-	if (volStep < minFade || nrSteps <= 1) {
-		SetVolume(vol);
-		SetFadeActive(false);
-		return;
-	}
-
-	auto macro = GetMacro();
-	int step = 0;
-	auto fadeId = GetFadeIdPtr();
-	int expectedFadeId = ++(*fadeId);
-	for (; step < nrSteps && !MacroIsStopped(macro) &&
-	       expectedFadeId == *fadeId;
-	     ++step) {
-		curVol = (volIncrease) ? curVol + volStep : curVol - volStep;
-		SetVolume(curVol);
-		std::this_thread::sleep_for(fadeInterval);
-	}
-
-	// As a final step set desired volume once again in case floating-point
-	// precision errors compounded to a noticeable error
-	if (step == nrSteps) {
-		SetVolume(vol);
-	}
-
-	SetFadeActive(false);
-}
-
 void MacroActionAudio::StartFade() const
 {
-	if (_action == Action::SOURCE_VOLUME && !_audioSource.GetSource()) {
+	const auto key = GetFadeKey();
+	if (key.empty()) {
 		return;
 	}
-
-	if (FadeActive() && !_abortActiveFade) {
+	if (AnimationIsActive(key) && !_abortActiveFade) {
 		blog(LOG_WARNING,
 		     "Audio fade for volume of %s already active! New fade request will be ignored!",
 		     (_action == Action::SOURCE_VOLUME)
@@ -200,14 +122,58 @@ void MacroActionAudio::StartFade() const
 			     : "master volume");
 		return;
 	}
-	SetFadeActive(true);
+
+	// Any active fade is replaced, so the new fade starts at whatever
+	// volume the previous fade has reached so far
+	const float vol = GetVolume();
+	const float curVol = GetCurrentVolume();
+	const float volDiff = std::abs(vol - curVol);
+	std::chrono::milliseconds duration(0);
+	if (_fadeType == FadeType::DURATION) {
+		duration = std::chrono::milliseconds(_duration.Milliseconds());
+	} else if (_rate > 0.) {
+		duration = std::chrono::milliseconds(
+			static_cast<int64_t>(volDiff / (_rate / 100.) * 1000.));
+	}
+
+	if (volDiff < minFade || duration.count() <= 0) {
+		StopAnimation(key);
+		SetVolume(vol);
+		return;
+	}
+
+	// The fade is stopped once the macro is stopped or the source is gone
+	const bool isSourceFade = _action == Action::SOURCE_VOLUME;
+	const OBSWeakSource source = _audioSource.GetSource();
+	const auto macro = GetMacro();
+	const auto weakMacro =
+		GetWeakMacroByName(GetMacroName(macro).c_str());
+	const auto id = StartAnimation(
+		key, curVol, vol, duration, _fadeEasing,
+		[isSourceFade, source, weakMacro](double value) {
+			// Do not keep the macro alive while changing the volume
+			{
+				auto macro = weakMacro.lock();
+				if (!macro || MacroIsStopped(macro.get())) {
+					return false;
+				}
+			}
+			if (!isSourceFade) {
+				set_master_volume(static_cast<float>(value));
+				return true;
+			}
+			OBSSourceAutoRelease s =
+				obs_weak_source_get_source(source);
+			if (!s) {
+				return false;
+			}
+			obs_source_set_volume(s, static_cast<float>(value));
+			return true;
+		});
 
 	if (_wait) {
-		FadeVolume();
-	} else {
-		AddMacroHelperThread(GetMacro(),
-				     std::thread(&MacroActionAudio::FadeVolume,
-						 this));
+		WaitForAnimation(id,
+				 [macro]() { return MacroIsStopped(macro); });
 	}
 }
 
@@ -316,6 +282,7 @@ bool MacroActionAudio::Save(obs_data_t *obj) const
 	obs_data_set_int(obj, "fadeType", static_cast<int>(_fadeType));
 	obs_data_set_bool(obj, "wait", _wait);
 	obs_data_set_bool(obj, "abortActiveFade", _abortActiveFade);
+	obs_data_set_int(obj, "fadeEasing", static_cast<int>(_fadeEasing));
 	obs_data_set_bool(obj, "useDb", _useDb);
 	_volumeDB.Save(obj, "volumeDB");
 	obs_data_set_int(obj, "version", 3);
@@ -358,6 +325,13 @@ bool MacroActionAudio::Load(obs_data_t *obj)
 	} else {
 		_abortActiveFade = false;
 	}
+	const auto fadeEasing = obs_data_get_int(obj, "fadeEasing");
+	if (fadeEasing < static_cast<int>(Easing::LINEAR) ||
+	    fadeEasing > static_cast<int>(Easing::EASE_IN_OUT)) {
+		_fadeEasing = Easing::LINEAR;
+	} else {
+		_fadeEasing = static_cast<Easing>(fadeEasing);
+	}
 
 	if (obs_data_get_int(obj, "version") < 2) {
 		_useDb = false;
@@ -401,6 +375,13 @@ void MacroActionAudio::ResolveVariablesToFixedValues()
 	_rate.ResolveVariables();
 }
 
+std::shared_ptr<MacroAction> MacroActionAudio::CopyWithResolvedVariables() const
+{
+	auto copy = std::make_shared<MacroActionAudio>(*this);
+	copy->ResolveVariablesToFixedValues();
+	return copy;
+}
+
 static inline void populateActionSelection(QComboBox *list)
 {
 	for (const auto &[action, name] : actionTypes) {
@@ -444,7 +425,9 @@ MacroActionAudioEdit::MacroActionAudioEdit(
 		  obs_module_text("AdvSceneSwitcher.action.audio.fade.wait"))),
 	  _abortActiveFade(new QCheckBox(
 		  obs_module_text("AdvSceneSwitcher.action.audio.fade.abort"))),
+	  _fadeEasing(new QComboBox),
 	  _fadeTypeLayout(new QHBoxLayout),
+	  _fadeEasingLayout(new QHBoxLayout),
 	  _fadeOptionsLayout(new QVBoxLayout)
 {
 	_syncOffset->setMinimum(-950);
@@ -473,6 +456,7 @@ MacroActionAudioEdit::MacroActionAudioEdit(
 	_sources->SetSourceNameList(sources);
 	populateFadeTypeSelection(_fadeTypes);
 	PopulateMonitorTypeSelection(_monitorTypes);
+	PopulateEasingSelection(_fadeEasing);
 
 	QWidget::connect(_actions, SIGNAL(currentIndexChanged(int)), this,
 			 SLOT(ActionChanged(int)));
@@ -517,6 +501,8 @@ MacroActionAudioEdit::MacroActionAudioEdit(
 			 SLOT(AbortActiveFadeChanged(int)));
 	QWidget::connect(_fadeTypes, SIGNAL(currentIndexChanged(int)), this,
 			 SLOT(FadeTypeChanged(int)));
+	QWidget::connect(_fadeEasing, SIGNAL(currentIndexChanged(int)), this,
+			 SLOT(FadeEasingChanged(int)));
 
 	std::unordered_map<std::string, QWidget *> widgetPlaceholders = {
 		{"{{audioSources}}", _sources},
@@ -534,6 +520,7 @@ MacroActionAudioEdit::MacroActionAudioEdit(
 		{"{{wait}}", _wait},
 		{"{{abortActiveFade}}", _abortActiveFade},
 		{"{{fadeTypes}}", _fadeTypes},
+		{"{{fadeEasing}}", _fadeEasing},
 	};
 	QHBoxLayout *entryLayout = new QHBoxLayout;
 	PlaceWidgets(obs_module_text("AdvSceneSwitcher.action.audio.entry"),
@@ -542,8 +529,12 @@ MacroActionAudioEdit::MacroActionAudioEdit(
 	PlaceWidgets(
 		obs_module_text("AdvSceneSwitcher.action.audio.fade.duration"),
 		_fadeTypeLayout, widgetPlaceholders);
+	PlaceWidgets(
+		obs_module_text("AdvSceneSwitcher.action.audio.fade.easing"),
+		_fadeEasingLayout, widgetPlaceholders);
 
 	_fadeOptionsLayout->addLayout(_fadeTypeLayout);
+	_fadeOptionsLayout->addLayout(_fadeEasingLayout);
 	_fadeOptionsLayout->addWidget(_abortActiveFade);
 	_fadeOptionsLayout->addWidget(_wait);
 
@@ -620,6 +611,9 @@ void MacroActionAudioEdit::SetWidgetVisibility()
 				     _entryData->_fade);
 	_wait->setVisible(hasVolumeControl(_entryData->_action) &&
 			  _entryData->_fade);
+	SetLayoutVisible(_fadeEasingLayout,
+			 hasVolumeControl(_entryData->_action) &&
+				 _entryData->_fade);
 	_duration->setEnabled(_entryData->_fade);
 	_rate->setEnabled(_entryData->_fade);
 	_fadeTypes->setEnabled(_entryData->_fade);
@@ -657,6 +651,8 @@ void MacroActionAudioEdit::UpdateEntryData()
 	_wait->setChecked(_entryData->_wait);
 	_abortActiveFade->setChecked(_entryData->_abortActiveFade);
 	_fadeTypes->setCurrentIndex(static_cast<int>(_entryData->_fadeType));
+	_fadeEasing->setCurrentIndex(_fadeEasing->findData(
+		static_cast<int>(_entryData->_fadeEasing)));
 	SetWidgetVisibility();
 }
 
@@ -817,4 +813,15 @@ void MacroActionAudioEdit::FadeTypeChanged(int value)
 	SetWidgetVisibility();
 }
 
+void MacroActionAudioEdit::FadeEasingChanged(int idx)
+{
+	if (_loading || !_entryData) {
+		return;
+	}
+
+	auto lock = LockContext();
+	_entryData->_fadeEasing =
+		static_cast<Easing>(_fadeEasing->itemData(idx).toInt());
+}
+
 } // namespace advss
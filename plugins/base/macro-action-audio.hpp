@@ -1,5 +1,6 @@
 #pragma once
 #include "macro-action-edit.hpp"
+#include "animation-helpers.hpp"
 #include "duration-control.hpp"
 #include "slider-spinbox.hpp"
 #include "source-selection.hpp"
@@ -21,6 +22,7 @@ public:
 	static std::shared_ptr<MacroAction> Create(Macro *m);
 	std::shared_ptr<MacroAction> Copy() const;
 	void ResolveVariablesToFixedValues();
+	std::shared_ptr<MacroAction> CopyWithResolvedVariables() const;
 
 	SourceSelection _audioSource;
 
@@ -55,15 +57,13 @@ public:
 	DoubleVariable _rate = 100.;
 	bool _wait = false;
 	bool _abortActiveFade = false;
+	Easing _fadeEasing = Easing::LINEAR;
 
 private:
 	void StartFade() const;
-	void FadeVolume() const;
 	void SetVolume(float vol) const;
 	float GetCurrentVolume() const;
-	void SetFadeActive(bool value) const;
-	bool FadeActive() const;
-	std::atomic_int *GetFadeIdPtr() const;
+	std::string GetFadeKey() const;
 	float GetVolume() const;
 
 	static bool _registered;
@@ -102,6 +102,7 @@ private slots:
 	void WaitChanged(int value);
 	void AbortActiveFadeChanged(int value);
 	void FadeTypeChanged(int value);
+	void FadeEasingChanged(int value);
 signals:
 	void HeaderInfoChanged(const QString &);
 
@@ -121,7 +122,9 @@ protected:
 	VariableDoubleSpinBox *_rate;
 	QCheckBox *_wait;
 	QCheckBox *_abortActiveFade;
+	QComboBox *_fadeEasing;
 	QHBoxLayout *_fadeTypeLayout;
+	QHBoxLayout *_fadeEasingLayout;
 	QVBoxLayout *_fadeOptionsLayout;
 	std::shared_ptr<MacroActionAudio> _entryData;
 
@@ -183,6 +183,26 @@ void MacroActionFilter::ResolveVariablesToFixedValues()
 	_manualSettingValue.ResolveVariables();
 }
 
+std::shared_ptr<MacroAction>
+MacroActionFilter::CopyWithResolvedVariables() const
+{
+	auto copy = std::make_shared<MacroActionFilter>(*this);
+	copy->ResolveVariablesToFixedValues();
+	return copy;
+}
+
+std::string MacroActionFilter::GetQueueCoalescingKey() const
+{
+	// Only setting the value of the same individual setting again will
+	// override the previous change completely
+	if (_action != Action::SETTINGS ||
+	    _settingsInputMethod != SettingsInputMethod::INDIVIDUAL_MANUAL) {
+		return "";
+	}
+	return GetId() + "|" + _source.ToString() + "|" + _filter.ToString() +
+	       "|" + _setting.GetID();
+}
+
 static inline void populateActionSelection(QComboBox *list)
 {
 	for (auto entry : actionTypes) {
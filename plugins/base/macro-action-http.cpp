@@ -151,6 +151,13 @@ void MacroActionHttp::ResolveVariablesToFixedValues()
 	_timeout.ResolveVariables();
 }
 
+std::shared_ptr<MacroAction> MacroActionHttp::CopyWithResolvedVariables() const
+{
+	auto copy = std::make_shared<MacroActionHttp>(*this);
+	copy->ResolveVariablesToFixedValues();
+	return copy;
+}
+
 static inline void populateMethodSelection(QComboBox *list)
 {
 	for (auto entry : methods) {
@@ -23,6 +23,7 @@ public:
 	static std::shared_ptr<MacroAction> Create(Macro *m);
 	std::shared_ptr<MacroAction> Copy() const;
 	void ResolveVariablesToFixedValues();
+	std::shared_ptr<MacroAction> CopyWithResolvedVariables() const;
 
 	enum class Method {
 		GET = 0,
@@ -81,7 +81,7 @@ static void waitHelper(std::unique_lock<std::mutex> *lock, Macro *macro,
 	int playingStateCount = 0;
 
 	while (true) {
-		if (MacroWaitShouldAbort() || MacroIsStopped(macro)) {
+		if (MacroWaitShouldAbort(macro) || MacroIsStopped(macro)) {
 			break;
 		}
 		if (obs_source_media_get_state(source) !=
@@ -91,7 +91,7 @@ static void waitHelper(std::unique_lock<std::mutex> *lock, Macro *macro,
 		if (playingStateCount >= playingStateBreakThreshold) {
 			break;
 		}
-		GetMacroWaitCV().wait_for(*lock, 10ms);
+		GetMacroWaitCV(macro).wait_for(*lock, 10ms);
 	}
 }
 
@@ -130,6 +130,7 @@ void MacroActionMedia::PerformActionHelper(obs_source_t *source) const
 		SeekToPercentage(source);
 		break;
 	case Action::WAIT_FOR_PLAYBACK_STOP: {
+		SetMacroAbortWait(GetMacro(), false);
 		std::unique_lock<std::mutex> lock(*GetMutex());
 		waitHelper(&lock, GetMacro(), source);
 		break;
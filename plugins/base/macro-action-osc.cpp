@@ -1,5 +1,9 @@
 #include "macro-action-osc.hpp"
+#include "macro-helpers.hpp"
+#include "osc-parser.hpp"
 
+#include <algorithm>
+#include <iterator>
 #include <obs.hpp>
 #include <QGroupBox>
 #include <system_error>
@@ -14,9 +18,8 @@ bool MacroActionOSC::_registered = MacroActionFactory::Register(
 
 MacroActionOSC::MacroActionOSC(Macro *m)
 	: MacroAction(m),
-	  _ctx(asio::io_context()),
-	  _tcpSocket(asio::ip::tcp::socket(_ctx)),
-	  _udpSocket(asio::ip::udp::socket(_ctx))
+	  _tcpSocket(NetworkRuntime::Instance().Context()),
+	  _udpSocket(NetworkRuntime::Instance().Context())
 {
 }
 
@@ -29,6 +32,9 @@ void MacroActionOSC::SendOSCTCPMessage(const asio::mutable_buffer &buffer)
 		     "failed to send OSC message \"%s\" via TCP %s %d: %s",
 		     _message.ToString().c_str(), _ip.c_str(), _port.GetValue(),
 		     e.what());
+		// Reconnect on the next attempt to send a message
+		asio::error_code ec;
+		_tcpSocket.close(ec);
 	}
 }
 
@@ -44,10 +50,10 @@ void MacroActionOSC::SendOSCUDPMessage(const asio::mutable_buffer &buffer)
 	}
 }
 
-void MacroActionOSC::UDPReconnect()
+bool MacroActionOSC::UDPReconnect()
 {
 	asio::error_code ec;
-	asio::ip::udp::resolver resolver(_ctx);
+	asio::ip::udp::resolver resolver(NetworkRuntime::Instance().Context());
 	auto endpoints = resolver.resolve(asio::ip::udp::v4(), _ip.c_str(),
 					  std::to_string(_port.GetValue()), ec);
 	if (ec) {
@@ -58,23 +64,26 @@ void MacroActionOSC::UDPReconnect()
 	if (ec) {
 		blog(LOG_WARNING, "failed to get IP for \"%s\": %s",
 		     _ip.c_str(), ec.message().c_str());
-		return;
+		return false;
 	}
 
 	try {
 		_updEndpoint = endpoints.begin()->endpoint();
-		_udpSocket = asio::ip::udp::socket(_ctx);
+		_udpSocket = asio::ip::udp::socket(
+			NetworkRuntime::Instance().Context());
 		_udpSocket.open(endpoints.begin()->endpoint().protocol());
 	} catch (const std::exception &e) {
 		blog(LOG_WARNING, "failed to connect to UDP %s %d: %s",
 		     _ip.c_str(), _port.GetValue(), e.what());
+		return false;
 	}
+	return true;
 }
 
-void MacroActionOSC::TCPReconnect()
+bool MacroActionOSC::TCPReconnect()
 {
 	asio::error_code ec;
-	asio::ip::tcp::resolver resolver(_ctx);
+	asio::ip::tcp::resolver resolver(NetworkRuntime::Instance().Context());
 	auto endpoints = resolver.resolve(asio::ip::tcp::v4(), _ip.c_str(),
 					  std::to_string(_port.GetValue()), ec);
 	if (ec) {
@@ -85,50 +94,189 @@ void MacroActionOSC::TCPReconnect()
 	if (ec) {
 		blog(LOG_WARNING, "failed to get IP for \"%s\": %s",
 		     _ip.c_str(), ec.message().c_str());
-		return;
+		return false;
 	}
 	try {
-		_tcpSocket = asio::ip::tcp::socket(_ctx);
+		_tcpSocket = asio::ip::tcp::socket(
+			NetworkRuntime::Instance().Context());
 		_tcpSocket.connect(endpoints.begin()->endpoint());
 	} catch (const std::exception &e) {
 		blog(LOG_WARNING, "failed to connect to TCP %s %d: %s",
 		     _ip.c_str(), _port.GetValue(), e.what());
+		return false;
 	}
+	return true;
+}
+
+bool MacroActionOSC::TCPConnectionWasClosed()
+{
+	// Writing to a connection, which was closed by the receiver, usually
+	// still succeeds, so check if the receiver has closed it before
+	asio::error_code ec;
+	_tcpSocket.non_blocking(true, ec);
+	if (ec) {
+		return true;
+	}
+	char data;
+	_tcpSocket.read_some(asio::buffer(&data, 1), ec);
+	const bool closed = ec && ec != asio::error::would_block;
+	asio::error_code ignored;
+	_tcpSocket.non_blocking(false, ignored);
+	return closed;
 }
 
 void MacroActionOSC::CheckReconnect()
 {
+	// The address is only resolved again if the destination changed, as
+	// the IP and port might be set using variables
+	const std::string ip = _ip;
+	const int port = _port;
+	if (ip != _connectedIP || port != _connectedPort) {
+		_reconnect = true;
+	}
+
+	bool connected = true;
 	if (_protocol == Protocol::TCP &&
-	    (_reconnect || !_tcpSocket.is_open())) {
-		TCPReconnect();
+	    (_reconnect || !_tcpSocket.is_open() || TCPConnectionWasClosed())) {
+		connected = TCPReconnect();
 	}
 
 	if (_protocol == Protocol::UDP &&
 	    (_reconnect || !_udpSocket.is_open())) {
-		UDPReconnect();
+		connected = UDPReconnect();
 	}
+
+	_reconnect = !connected;
+	_connectedIP = ip;
+	_connectedPort = port;
 }
 
-bool MacroActionOSC::PerformAction()
+static bool isSamePort(const IntVariable &a, const IntVariable &b)
 {
+	if (a.IsFixedType() != b.IsFixedType()) {
+		return false;
+	}
+	if (a.IsFixedType()) {
+		return a.GetFixedValue() == b.GetFixedValue();
+	}
+	return a.GetVariable().lock() == b.GetVariable().lock();
+}
+
+bool MacroActionOSC::SharesBundleWith(const MacroActionOSC &other) const
+{
+	// Only the configured destination is compared, as the variables of
+	// other actions must not be resolved while they might be performed on
+	// a different thread
+	return _bundle && other._bundle && _protocol == other._protocol &&
+	       _ip.UnresolvedValue() == other._ip.UnresolvedValue() &&
+	       isSamePort(_port, other._port);
+}
+
+static std::vector<std::shared_ptr<MacroActionOSC>>
+getEnabledOSCActions(const std::deque<std::shared_ptr<MacroAction>> &actions)
+{
+	// Disabled actions are skipped when running the actions of a macro, so
+	// they do not split up a bundle
+	std::vector<std::shared_ptr<MacroActionOSC>> result;
+	for (const auto &action : actions) {
+		if (action->Enabled()) {
+			result.emplace_back(
+				std::dynamic_pointer_cast<MacroActionOSC>(
+					action));
+		}
+	}
+	return result;
+}
+
+std::pair<std::shared_ptr<MacroActionOSC>, std::shared_ptr<MacroActionOSC>>
+MacroActionOSC::GetAdjacentBundleActions() const
+{
+	// The following actions of the bundle will not be performed if this
+	// action is performed on its own, e.g. by an action queue, so the
+	// message has to be sent by this action alone
+	const auto macro = GetMacro();
+	if (!IsRunningActionsOfMacro(macro)) {
+		return {};
+	}
+
+	for (const auto &actions :
+	     {GetMacroActions(macro), GetMacroElseActions(macro)}) {
+		if (!actions) {
+			continue;
+		}
+		const auto sequence = getEnabledOSCActions(*actions);
+		auto it = std::find_if(sequence.begin(), sequence.end(),
+				       [this](const auto &action) {
+					       return action.get() == this;
+				       });
+		if (it == sequence.end()) {
+			continue;
+		}
+
+		std::shared_ptr<MacroActionOSC> previous;
+		if (it != sequence.begin() && *std::prev(it) &&
+		    SharesBundleWith(**std::prev(it))) {
+			previous = *std::prev(it);
+		}
+		std::shared_ptr<MacroActionOSC> next;
+		if (std::next(it) != sequence.end() && *std::next(it) &&
+		    SharesBundleWith(**std::next(it))) {
+			next = *std::next(it);
+		}
+		return {previous, next};
+	}
+
+	// Not part of the macro's action lists
+	return {};
+}
+
+std::optional<std::vector<char>> MacroActionOSC::AddToBundle()
+{
+	const auto [previous, next] = GetAdjacentBundleActions();
+
+	std::vector<std::vector<char>> messages;
+	if (previous) {
+		std::lock_guard<std::mutex> lock(previous->_bundleMutex);
+		messages = std::move(previous->_bundleMessages);
+		previous->_bundleMessages.clear();
+	}
+
 	auto buffer = _message.GetBuffer();
-	if (!buffer.has_value()) {
-		blog(LOG_WARNING, "failed to create or fill OSC buffer!");
-		return true;
+	if (buffer) {
+		messages.emplace_back(std::move(*buffer));
+	} else {
+		blog(LOG_WARNING, "failed to create OSC buffer for %s",
+		     _message.ToString().c_str());
 	}
 
-	CheckReconnect();
+	// The bundle is sent by its last action, so none of its messages are
+	// sent if the macro stops before reaching it
+	if (next) {
+		std::lock_guard<std::mutex> lock(_bundleMutex);
+		_bundleMessages = std::move(messages);
+		return std::vector<char>();
+	}
 
-	if (_protocol == Protocol::TCP &&
-	    (_reconnect || !_tcpSocket.is_open())) {
-		TCPReconnect();
+	if (messages.empty()) {
+		return {};
 	}
+	return CreateOSCBundle(messages);
+}
 
-	if (_protocol == Protocol::UDP &&
-	    (_reconnect || !_udpSocket.is_open())) {
-		UDPReconnect();
+bool MacroActionOSC::PerformAction()
+{
+	auto buffer = _bundle ? AddToBundle() : _message.GetBuffer();
+	if (!buffer.has_value()) {
+		blog(LOG_WARNING, "failed to create or fill OSC buffer!");
+		return true;
+	}
+	if (buffer->empty()) {
+		// Will be sent as part of the bundle by a following action
+		return true;
 	}
 
+	CheckReconnect();
+
 	auto rawMessage = asio::buffer(*buffer);
 
 	switch (_protocol) {
@@ -160,6 +308,7 @@ bool MacroActionOSC::Save(obs_data_t *obj) const
 	_ip.Save(obj, "ip");
 	_port.Save(obj, "port");
 	_message.Save(obj);
+	obs_data_set_bool(obj, "bundle", _bundle);
 	return true;
 }
 
@@ -170,6 +319,7 @@ bool MacroActionOSC::Load(obs_data_t *obj)
 	_ip.Load(obj, "ip");
 	_port.Load(obj, "port");
 	_message.Load(obj);
+	_bundle = obs_data_get_bool(obj, "bundle");
 	return true;
 }
 
@@ -225,10 +375,14 @@ MacroActionOSCEdit::MacroActionOSCEdit(
 	  _protocol(new QComboBox(this)),
 	  _ip(new VariableLineEdit(this)),
 	  _port(new VariableSpinBox(this)),
+	  _bundle(new QCheckBox(
+		  obs_module_text("AdvSceneSwitcher.action.osc.bundle"))),
 	  _message(new OSCMessageEdit(this))
 {
 	populateProtocolSelection(_protocol);
 	_port->setMaximum(65535);
+	_bundle->setToolTip(
+		obs_module_text("AdvSceneSwitcher.action.osc.bundle.tooltip"));
 
 	auto networkGroup =
 		new QGroupBox(obs_module_text("AdvSceneSwitcher.osc.network"));
@@ -250,6 +404,8 @@ MacroActionOSCEdit::MacroActionOSCEdit(
 					 "AdvSceneSwitcher.osc.network.port")),
 				 row, 0);
 	networkLayout->addWidget(_port, row, 1);
+	++row;
+	networkLayout->addWidget(_bundle, row, 0, 1, 2);
 	networkGroup->setLayout(networkLayout);
 
 	auto messageGroup =
@@ -271,6 +427,8 @@ MacroActionOSCEdit::MacroActionOSCEdit(
 		_port,
 		SIGNAL(NumberVariableChanged(const NumberVariable<int> &)),
 		this, SLOT(PortChanged(const NumberVariable<int> &)));
+	QWidget::connect(_bundle, SIGNAL(stateChanged(int)), this,
+			 SLOT(BundleChanged(int)));
 	QWidget::connect(_message, SIGNAL(MessageChanged(const OSCMessage &)),
 			 this, SLOT(MessageChanged(const OSCMessage &)));
 
@@ -288,6 +446,7 @@ void MacroActionOSCEdit::UpdateEntryData()
 	_protocol->setCurrentIndex(static_cast<int>(_entryData->GetProtocol()));
 	_ip->setText(_entryData->GetIP());
 	_port->SetValue(_entryData->GetPortNr());
+	_bundle->setChecked(_entryData->_bundle);
 	_message->SetMessage(_entryData->_message);
 
 	adjustSize();
@@ -324,6 +483,16 @@ void MacroActionOSCEdit::PortChanged(const NumberVariable<int> &value)
 	_entryData->SetPortNr(value);
 }
 
+void MacroActionOSCEdit::BundleChanged(int value)
+{
+	if (_loading || !_entryData) {
+		return;
+	}
+
+	auto lock = LockContext();
+	_entryData->_bundle = value;
+}
+
 void MacroActionOSCEdit::MessageChanged(const OSCMessage &m)
 {
 	if (_loading || !_entryData) {
@@ -1,8 +1,11 @@
 #pragma once
 #include "macro-action-edit.hpp"
+#include "network-runtime.hpp"
 #include "osc-helpers.hpp"
 
+#include <QCheckBox>
 #include <memory>
+#include <mutex>
 #include <asio.hpp>
 
 namespace advss {
@@ -32,25 +35,43 @@ public:
 	void ResolveVariablesToFixedValues();
 
 	OSCMessage _message;
+	// Consecutive actions with this option enabled sending to the same
+	// destination are combined into a single OSC bundle
+	bool _bundle = false;
 
 private:
 	void SendOSCTCPMessage(const asio::mutable_buffer &);
 	void SendOSCUDPMessage(const asio::mutable_buffer &);
 
 	void CheckReconnect();
-	void TCPReconnect();
-	void UDPReconnect();
+	bool TCPReconnect();
+	bool UDPReconnect();
+	bool TCPConnectionWasClosed();
+
+	bool SharesBundleWith(const MacroActionOSC &) const;
+	std::pair<std::shared_ptr<MacroActionOSC>,
+		  std::shared_ptr<MacroActionOSC>>
+	GetAdjacentBundleActions() const;
+	std::optional<std::vector<char>> AddToBundle();
 
 	Protocol _protocol = Protocol::UDP;
 	StringVariable _ip = "localhost";
 	IntVariable _port = 12345;
 	bool _reconnect = true;
+	// The resolved address of the current connection, which is reused as
+	// long as the destination does not change
+	std::string _connectedIP;
+	int _connectedPort = 0;
 
-	asio::io_context _ctx;
 	asio::ip::tcp::socket _tcpSocket;
 	asio::ip::udp::socket _udpSocket;
 	asio::ip::udp::endpoint _updEndpoint;
 
+	// Messages of the bundle collected so far, which are passed on to the
+	// following action of the bundle when it is performed
+	std::vector<std::vector<char>> _bundleMessages;
+	std::mutex _bundleMutex;
+
 	static bool _registered;
 	static const std::string id;
 };
@@ -75,6 +96,7 @@ private slots:
 	void MessageChanged(const OSCMessage &);
 	void ProtocolChanged(int);
 	void PortChanged(const NumberVariable<int> &value);
+	void BundleChanged(int);
 
 signals:
 	void HeaderInfoChanged(const QString &);
@@ -86,6 +108,7 @@ private:
 	QComboBox *_protocol;
 	VariableLineEdit *_ip;
 	VariableSpinBox *_port;
+	QCheckBox *_bundle;
 	OSCMessageEdit *_message;
 	bool _loading = true;
 };
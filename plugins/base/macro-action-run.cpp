@@ -21,6 +21,12 @@ bool MacroActionRun::PerformAction()
 		return true;
 	}
 
+	if (_procConfig.IsCoprocess()) {
+		// The response is not of interest, if not waiting for it
+		_procConfig.PostToCoprocess();
+		return true;
+	}
+
 	bool procStarted = _procConfig.StartProcessDetached();
 
 	// Fall back to using default application to open given file
@@ -117,6 +117,14 @@ void MacroActionSceneVisibility::ResolveVariablesToFixedValues()
 	_source.ResolveVariables();
 }
 
+std::shared_ptr<MacroAction>
+MacroActionSceneVisibility::CopyWithResolvedVariables() const
+{
+	auto copy = std::make_shared<MacroActionSceneVisibility>(*this);
+	copy->ResolveVariablesToFixedValues();
+	return copy;
+}
+
 static inline void populateActionSelection(QComboBox *list)
 {
 	for (const auto &entry : actionTypes) {
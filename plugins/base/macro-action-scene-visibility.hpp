@@ -17,6 +17,7 @@ public:
 	static std::shared_ptr<MacroAction> Create(Macro *m);
 	std::shared_ptr<MacroAction> Copy() const;
 	void ResolveVariablesToFixedValues();
+	std::shared_ptr<MacroAction> CopyWithResolvedVariables() const;
 
 	SceneSelection _scene;
 	SceneItemSelection _source;
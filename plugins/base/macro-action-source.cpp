@@ -249,6 +249,25 @@ void MacroActionSource::ResolveVariablesToFixedValues()
 	_manualSettingValue.ResolveVariables();
 }
 
+std::shared_ptr<MacroAction>
+MacroActionSource::CopyWithResolvedVariables() const
+{
+	auto copy = std::make_shared<MacroActionSource>(*this);
+	copy->ResolveVariablesToFixedValues();
+	return copy;
+}
+
+std::string MacroActionSource::GetQueueCoalescingKey() const
+{
+	// Only setting the value of the same individual setting again will
+	// override the previous change completely
+	if (_action != Action::SETTINGS ||
+	    _settingsInputMethod != SettingsInputMethod::INDIVIDUAL_MANUAL) {
+		return "";
+	}
+	return GetId() + "|" + _source.ToString() + "|" + _setting.GetID();
+}
+
 static inline void populateActionSelection(QComboBox *list)
 {
 	for (auto &[actionType, name] : actionTypes) {
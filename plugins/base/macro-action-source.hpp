@@ -23,6 +23,8 @@ public:
 	static std::shared_ptr<MacroAction> Create(Macro *m);
 	std::shared_ptr<MacroAction> Copy() const;
 	void ResolveVariablesToFixedValues();
+	std::shared_ptr<MacroAction> CopyWithResolvedVariables() const;
+	std::string GetQueueCoalescingKey() const;
 
 	SourceSelection _source;
 	SourceSettingButton _button;
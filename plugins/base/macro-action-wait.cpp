@@ -27,8 +27,8 @@ static std::default_random_engine re(rd());
 static void waitHelper(std::unique_lock<std::mutex> *lock, Macro *macro,
 		       std::chrono::high_resolution_clock::time_point &time)
 {
-	while (!MacroWaitShouldAbort() && !MacroIsStopped(macro)) {
-		if (GetMacroWaitCV().wait_until(*lock, time) ==
+	while (!MacroWaitShouldAbort(macro) && !MacroIsStopped(macro)) {
+		if (GetMacroWaitCV(macro).wait_until(*lock, time) ==
 		    std::cv_status::timeout) {
 			break;
 		}
@@ -57,10 +57,11 @@ bool MacroActionWait::PerformAction()
 		    std::chrono::milliseconds((int)(sleepDuration * 1000));
 
 	SetMacroAbortWait(false);
+	SetMacroAbortWait(GetMacro(), false);
 	std::unique_lock<std::mutex> lock(*GetMutex());
 	waitHelper(&lock, GetMacro(), time);
 
-	return !MacroWaitShouldAbort();
+	return !MacroWaitShouldAbort(GetMacro());
 }
 
 bool MacroActionWait::Save(obs_data_t *obj) const
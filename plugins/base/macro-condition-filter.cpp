@@ -3,6 +3,7 @@
 #include "json-helpers.hpp"
 #include "text-helpers.hpp"
 #include "source-settings-helpers.hpp"
+#include "source-settings-watcher.hpp"
 #include "selection-helpers.hpp"
 
 #include <regex>
@@ -32,7 +33,8 @@ const static std::map<MacroConditionFilter::Condition, std::string>
 		 "AdvSceneSwitcher.condition.filter.type.individualSettingChanged"},
 };
 
-bool MacroConditionFilter::CheckConditionHelper(const OBSWeakSource &filter)
+bool MacroConditionFilter::CheckConditionHelper(const OBSWeakSource &filter,
+						SettingsState &state)
 {
 	bool ret = false;
 	OBSSourceAutoRelease filterSource = obs_weak_source_get_source(filter);
@@ -40,6 +42,9 @@ bool MacroConditionFilter::CheckConditionHelper(const OBSWeakSource &filter)
 		return false;
 	}
 
+	auto &watcher = SourceSettingsWatcher::Instance();
+	auto &cache = state.cache;
+
 	switch (_condition) {
 	case Condition::ENABLED:
 		ret = obs_source_enabled(filterSource);
@@ -48,22 +53,38 @@ bool MacroConditionFilter::CheckConditionHelper(const OBSWeakSource &filter)
 		ret = !obs_source_enabled(filterSource);
 		break;
 	case Condition::SETTINGS_MATCH: {
-		ret = CompareSourceSettings(filter, _settings, _regex);
-		const auto settings = GetSourceSettings(filter);
+		const std::string pattern = _settings;
+		if (!cache.IsValid(filter, watcher.GetVersion(filter),
+				   pattern)) {
+			uint64_t version = 0;
+			const auto settings =
+				watcher.GetSettings(filter, version);
+			cache.Update(filter, version, pattern, settings,
+				     _jsonMatcher.Matches(settings, pattern,
+							  _regex));
+		}
+		ret = cache.Result();
+		const auto settings = cache.Value().value_or("");
 		SetVariableValue(settings);
 		SetTempVarValue("settings", settings);
 		break;
 	}
 	case Condition::SETTINGS_CHANGED: {
-		const auto settings = GetSourceSettings(filter);
-		ret = !_currentSettings.empty() && settings != _currentSettings;
-		_currentSettings = settings;
-		SetVariableValue(settings);
-		SetTempVarValue("settings", settings);
+		if (!cache.IsValid(filter, watcher.GetVersion(filter))) {
+			uint64_t version = 0;
+			const auto settings =
+				watcher.GetSettings(filter, version);
+			ret = !state.currentSettings.empty() &&
+			      settings != state.currentSettings;
+			state.currentSettings = settings;
+			cache.Update(filter, version, "", {}, ret);
+		}
+		SetVariableValue(state.currentSettings);
+		SetTempVarValue("settings", state.currentSettings);
 		break;
 	}
 	case Condition::INDIVIDUAL_SETTING_MATCH: {
-		auto value = GetSourceSettingValue(filter, _setting);
+		auto value = GetSettingValue(filter, cache);
 		if (!value) {
 			return false;
 		}
@@ -74,12 +95,12 @@ bool MacroConditionFilter::CheckConditionHelper(const OBSWeakSource &filter)
 		break;
 	}
 	case Condition::INDIVIDUAL_SETTING_CHANGED: {
-		auto value = GetSourceSettingValue(filter, _setting);
+		auto value = GetSettingValue(filter, cache);
 		if (!value) {
 			return false;
 		}
-		ret = _currentSettingsValue != value;
-		_currentSettingsValue = *value;
+		ret = state.currentSettingsValue != value;
+		state.currentSettingsValue = *value;
 		SetVariableValue(*value);
 		SetTempVarValue("setting", *value);
 		break;
@@ -90,6 +111,22 @@ bool MacroConditionFilter::CheckConditionHelper(const OBSWeakSource &filter)
 	return ret;
 }
 
+std::optional<std::string>
+MacroConditionFilter::GetSettingValue(const OBSWeakSource &filter,
+				      SourceSettingsCache &cache)
+{
+	const auto version =
+		SourceSettingsWatcher::Instance().GetVersion(filter);
+	if (cache.IsValid(filter, version, _setting.GetID())) {
+		return cache.Value();
+	}
+
+	OBSSourceAutoRelease source = obs_weak_source_get_source(filter);
+	auto value = LookupSourceSetting(source, _setting.GetID());
+	cache.Update(filter, version, _setting.GetID(), value, false);
+	return value;
+}
+
 bool MacroConditionFilter::CheckCondition()
 {
 	auto filters = _filter.GetFilters(_source);
@@ -97,9 +134,14 @@ bool MacroConditionFilter::CheckCondition()
 		return false;
 	}
 
+	// Keep track of the settings state of each filter separately, as the
+	// selection might resolve to multiple filters
+	_settingsStates.resize(filters.size());
+
 	bool ret = true;
-	for (const auto &filter : filters) {
-		ret = ret && CheckConditionHelper(filter);
+	for (size_t i = 0; i < filters.size(); i++) {
+		ret = ret && CheckConditionHelper(filters[i],
+						  _settingsStates[i]);
 	}
 
 	if (GetVariableValue().empty()) {
@@ -109,6 +151,11 @@ bool MacroConditionFilter::CheckCondition()
 	return ret;
 }
 
+void MacroConditionFilter::ResetSettingsCache()
+{
+	_settingsStates.clear();
+}
+
 bool MacroConditionFilter::Save(obs_data_t *obj) const
 {
 	MacroCondition::Save(obj);
@@ -117,6 +164,7 @@ bool MacroConditionFilter::Save(obs_data_t *obj) const
 	obs_data_set_int(obj, "condition", static_cast<int>(_condition));
 	_settings.Save(obj, "settings");
 	_regex.Save(obj);
+	_jsonMatcher.Save(obj);
 	_setting.Save(obj);
 	return true;
 }
@@ -135,6 +183,7 @@ bool MacroConditionFilter::Load(obs_data_t *obj)
 		_regex.CreateBackwardsCompatibleRegex(
 			obs_data_get_bool(obj, "regex"));
 	}
+	_jsonMatcher.Load(obj);
 	_setting.Load(obj);
 	return true;
 }
@@ -150,6 +199,7 @@ std::string MacroConditionFilter::GetShortDesc() const
 void MacroConditionFilter::SetCondition(Condition cond)
 {
 	_condition = cond;
+	ResetSettingsCache();
 	SetupTempVars();
 }
 
@@ -195,11 +245,13 @@ MacroConditionFilterEdit::MacroConditionFilterEdit(
 		  "AdvSceneSwitcher.condition.filter.getSettings"))),
 	  _settings(new VariableTextEdit(this)),
 	  _regex(new RegexConfigWidget(parent)),
+	  _jsonMatchMode(new QComboBox()),
 	  _settingSelection(new SourceSettingSelection()),
 	  _refreshSettingSelection(new QPushButton(
 		  obs_module_text("AdvSceneSwitcher.condition.filter.refresh")))
 {
 	populateConditionSelection(_conditions);
+	PopulateJsonMatchModeSelection(_jsonMatchMode);
 	auto sources = GetSourcesWithFilterNames();
 	sources.sort();
 	_sources->SetSourceNameList(sources);
@@ -221,6 +273,8 @@ MacroConditionFilterEdit::MacroConditionFilterEdit(
 	QWidget::connect(_regex,
 			 SIGNAL(RegexConfigChanged(const RegexConfig &)), this,
 			 SLOT(RegexChanged(const RegexConfig &)));
+	QWidget::connect(_jsonMatchMode, SIGNAL(currentIndexChanged(int)),
+			 this, SLOT(JsonMatchModeChanged(int)));
 	QWidget::connect(_settingSelection,
 			 SIGNAL(SelectionChanged(const SourceSetting &)), this,
 			 SLOT(SettingSelectionChanged(const SourceSetting &)));
@@ -234,6 +288,7 @@ MacroConditionFilterEdit::MacroConditionFilterEdit(
 		{"{{settings}}", _settings},
 		{"{{getSettings}}", _getSettings},
 		{"{{regex}}", _regex},
+		{"{{jsonMatchMode}}", _jsonMatchMode},
 		{"{{settingSelection}}", _settingSelection},
 		{"{{refresh}}", _refreshSettingSelection}};
 
@@ -356,11 +411,24 @@ void MacroConditionFilterEdit::RegexChanged(const RegexConfig &conf)
 
 	auto lock = LockContext();
 	_entryData->_regex = conf;
+	_entryData->ResetSettingsCache();
 
 	adjustSize();
 	updateGeometry();
 }
 
+void MacroConditionFilterEdit::JsonMatchModeChanged(int index)
+{
+	if (_loading || !_entryData) {
+		return;
+	}
+
+	auto lock = LockContext();
+	_entryData->_jsonMatcher.SetMode(static_cast<JsonMatcher::Mode>(
+		_jsonMatchMode->itemData(index).toInt()));
+	_entryData->ResetSettingsCache();
+}
+
 void MacroConditionFilterEdit::SettingSelectionChanged(
 	const SourceSetting &setting)
 {
@@ -389,6 +457,9 @@ void MacroConditionFilterEdit::SetWidgetVisibility()
 	_settings->setVisible(showSettingsControls);
 	_getSettings->setVisible(showSettingsControls);
 	_regex->setVisible(showSettingsControls);
+	_jsonMatchMode->setVisible(
+		_entryData->GetCondition() ==
+		MacroConditionFilter::Condition::SETTINGS_MATCH);
 	_settingSelection->setVisible(
 		_entryData->GetCondition() ==
 			MacroConditionFilter::Condition::INDIVIDUAL_SETTING_MATCH ||
@@ -418,6 +489,8 @@ void MacroConditionFilterEdit::UpdateEntryData()
 		static_cast<int>(_entryData->GetCondition()));
 	_settings->setPlainText(_entryData->_settings);
 	_regex->SetRegexConfig(_entryData->_regex);
+	_jsonMatchMode->setCurrentIndex(_jsonMatchMode->findData(
+		static_cast<int>(_entryData->_jsonMatcher.GetMode())));
 	const auto filters =
 		_entryData->_filter.GetFilters(_entryData->_source);
 	_settingSelection->SetSource(filters.empty() ? nullptr : filters.at(0));
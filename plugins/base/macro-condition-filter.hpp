@@ -1,10 +1,12 @@
 #pragma once
 #include "macro-condition-edit.hpp"
 #include "variable-text-edit.hpp"
+#include "json-helpers.hpp"
 #include "regex-config.hpp"
 #include "source-selection.hpp"
 #include "filter-selection.hpp"
 #include "source-setting.hpp"
+#include "source-settings-watcher.hpp"
 
 #include <QComboBox>
 #include <QPushButton>
@@ -35,20 +37,29 @@ public:
 	};
 	void SetCondition(Condition);
 	Condition GetCondition() const { return _condition; }
+	void ResetSettingsCache();
 
 	SourceSelection _source;
 	FilterSelection _filter;
 	StringVariable _settings = "";
 	RegexConfig _regex;
+	JsonMatcher _jsonMatcher;
 	SourceSetting _setting;
 
 private:
+	struct SettingsState {
+		SourceSettingsCache cache;
+		std::string currentSettings;
+		std::string currentSettingsValue;
+	};
+
 	void SetupTempVars();
-	bool CheckConditionHelper(const OBSWeakSource &);
+	bool CheckConditionHelper(const OBSWeakSource &, SettingsState &);
+	std::optional<std::string> GetSettingValue(const OBSWeakSource &,
+						   SourceSettingsCache &);
 
 	Condition _condition = Condition::ENABLED;
-	std::string _currentSettings;
-	std::string _currentSettingsValue;
+	std::vector<SettingsState> _settingsStates;
 
 	static bool _registered;
 	static const std::string id;
@@ -77,6 +88,7 @@ private slots:
 	void GetSettingsClicked();
 	void SettingsChanged();
 	void RegexChanged(const RegexConfig &);
+	void JsonMatchModeChanged(int);
 	void SettingSelectionChanged(const SourceSetting &);
 	void RefreshVariableSourceSelectionValue();
 signals:
@@ -91,6 +103,7 @@ private:
 	QPushButton *_getSettings;
 	VariableTextEdit *_settings;
 	RegexConfigWidget *_regex;
+	QComboBox *_jsonMatchMode;
 	SourceSettingSelection *_settingSelection;
 	QPushButton *_refreshSettingSelection;
 
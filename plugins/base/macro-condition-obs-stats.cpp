@@ -2,9 +2,8 @@
 #include "layout-helpers.hpp"
 #include "math-helpers.hpp"
 
-#include <obs-frontend-api.h>
 #include <QListView>
-#include <util/config-file.h>
+#include <QVBoxLayout>
 
 namespace advss {
 
@@ -54,374 +53,91 @@ const static std::map<MacroConditionStats::Condition, std::string>
 		 "AdvSceneSwitcher.condition.stats.condition.below"},
 };
 
-MacroConditionStats::MacroConditionStats(Macro *m)
-	: MacroCondition(m),
-	  _cpu_info(os_cpu_usage_info_start())
-{
-}
-
-MacroConditionStats::~MacroConditionStats()
-{
-	os_cpu_usage_info_destroy(_cpu_info);
-}
-
-bool MacroConditionStats::CheckFPS() const
-{
-	switch (_condition) {
-	case Condition::ABOVE:
-		return obs_get_active_fps() > _value;
-	case Condition::EQUALS:
-		return DoubleEquals(obs_get_active_fps(), _value, 0.01);
-	case Condition::BELOW:
-		return obs_get_active_fps() < _value;
-	default:
-		break;
-	}
-	return false;
-}
-
-bool MacroConditionStats::CheckCPU() const
-{
-	double usage = os_cpu_usage_info_query(_cpu_info);
-
-	switch (_condition) {
-	case Condition::ABOVE:
-		return usage > _value;
-	case Condition::EQUALS:
-		return DoubleEquals(usage, _value, 0.1);
-	case Condition::BELOW:
-		return usage < _value;
-	default:
-		break;
-	}
-	return false;
-}
-
-bool MacroConditionStats::CheckMemory() const
-{
-	auto rss =
-		(long double)os_get_proc_resident_size() / (1024.0l * 1024.0l);
-
-	switch (_condition) {
-	case Condition::ABOVE:
-		return rss > _value;
-	case Condition::EQUALS:
-		return DoubleEquals(rss, _value, 0.1);
-	case Condition::BELOW:
-		return rss < _value;
-	default:
-		break;
-	}
-	return false;
-}
-
-bool MacroConditionStats::CheckAvgFrametime() const
-{
-	auto num = (long double)obs_get_average_frame_time_ns() / 1000000.0l;
-
-	switch (_condition) {
-	case Condition::ABOVE:
-		return num > _value;
-	case Condition::EQUALS:
-		return DoubleEquals(num, _value, 0.1);
-	case Condition::BELOW:
-		return num < _value;
-	default:
-		break;
-	}
-	return false;
-}
-
-bool MacroConditionStats::CheckRenderLag()
-{
-	uint32_t total_rendered = obs_get_total_frames();
-	uint32_t total_lagged = obs_get_lagged_frames();
-
-	if (total_rendered < _first_rendered || total_lagged < _first_lagged) {
-		_first_rendered = total_rendered;
-		_first_lagged = total_lagged;
-	}
-	total_rendered -= _first_rendered;
-	total_lagged -= _first_lagged;
-
-	auto num = total_rendered ? (long double)total_lagged /
-					    (long double)total_rendered
-				  : 0.0l;
-	num *= 100.0l;
-
-	switch (_condition) {
-	case Condition::ABOVE:
-		return num > _value;
-	case Condition::EQUALS:
-		return DoubleEquals(num, _value, 0.1);
-	case Condition::BELOW:
-		return num < _value;
-	default:
-		break;
-	}
-	return false;
-}
-
-bool MacroConditionStats::CheckEncodeLag()
-{
-	video_t *video = obs_get_video();
-	uint32_t total_encoded = video_output_get_total_frames(video);
-	uint32_t total_skipped = video_output_get_skipped_frames(video);
-
-	if (total_encoded < _first_encoded || total_skipped < _first_encoded) {
-		_first_encoded = total_encoded;
-		_first_skipped = total_skipped;
-	}
-	total_encoded -= _first_encoded;
-	total_skipped -= _first_skipped;
-
-	auto num = total_encoded ? (long double)total_skipped /
-					   (long double)total_encoded
-				 : 0.0l;
-	num *= 100.0l;
-
-	switch (_condition) {
-	case Condition::ABOVE:
-		return num > _value;
-	case Condition::EQUALS:
-		return DoubleEquals(num, _value, 0.1);
-	case Condition::BELOW:
-		return num < _value;
-	default:
-		break;
-	}
-	return false;
-}
-
-void MacroConditionStats::OutputInfo::Update(obs_output_t *output)
-{
-	uint64_t totalBytes = output ? obs_output_get_total_bytes(output) : 0;
-	uint64_t curTime = os_gettime_ns();
-	uint64_t bytesSent = totalBytes;
-
-	if (bytesSent < lastBytesSent)
-		bytesSent = 0;
-	if (bytesSent == 0)
-		lastBytesSent = 0;
-
-	uint64_t bitsBetween = (bytesSent - lastBytesSent) * 8;
-	long double timePassed =
-		(long double)(curTime - lastBytesSentTime) / 1000000000.0l;
-	kbps = (long double)bitsBetween / timePassed / 1000.0l;
-
-	if (timePassed < 0.01l)
-		kbps = 0.0l;
-
-	int total = output ? obs_output_get_total_frames(output) : 0;
-	int dropped = output ? obs_output_get_frames_dropped(output) : 0;
-
-	if (total < first_total || dropped < first_dropped) {
-		first_total = 0;
-		first_dropped = 0;
-	}
-
-	total -= first_total;
-	dropped -= first_dropped;
-
-	dropped_relative =
-		total ? (long double)dropped / (long double)total * 100.0l
-		      : 0.0l;
-
-	lastBytesSent = bytesSent;
-	lastBytesSentTime = curTime;
-}
-
-bool MacroConditionStats::CheckStreamDroppedFrames()
-{
-	OBSOutputAutoRelease output = obs_frontend_get_streaming_output();
-	_streamInfo.Update(output);
-
-	switch (_condition) {
-	case Condition::ABOVE:
-		return _streamInfo.dropped_relative > _value;
-	case Condition::EQUALS:
-		return DoubleEquals(_streamInfo.dropped_relative, _value, 0.1);
-	case Condition::BELOW:
-		return _streamInfo.dropped_relative < _value;
-	default:
-		break;
-	}
-	return false;
-}
-
-bool MacroConditionStats::CheckStreamBitrate()
-{
-	OBSOutputAutoRelease output = obs_frontend_get_streaming_output();
-	_streamInfo.Update(output);
-
-	switch (_condition) {
-	case Condition::ABOVE:
-		return _streamInfo.kbps > _value;
-	case Condition::EQUALS:
-		return DoubleEquals(_streamInfo.kbps, _value, 1.0);
-	case Condition::BELOW:
-		return _streamInfo.kbps < _value;
-	default:
-		break;
-	}
-	return false;
-}
-
-bool MacroConditionStats::CheckStreamMBSent() const
-{
-	OBSOutputAutoRelease output = obs_frontend_get_streaming_output();
-	uint64_t totalBytes = output ? obs_output_get_total_bytes(output) : 0;
-	long double num = (long double)totalBytes / (1024.0l * 1024.0l);
-
-	switch (_condition) {
-	case Condition::ABOVE:
-		return num > _value;
-	case Condition::EQUALS:
-		return DoubleEquals(num, _value, 0.1);
-	case Condition::BELOW:
-		return num < _value;
-	default:
-		break;
-	}
-	return false;
-}
-
-bool MacroConditionStats::CheckRecordingDroppedFrames()
-{
-	OBSOutputAutoRelease output = obs_frontend_get_recording_output();
-	_recordingInfo.Update(output);
-
-	switch (_condition) {
-	case Condition::ABOVE:
-		return _recordingInfo.dropped_relative > _value;
-	case Condition::EQUALS:
-		return DoubleEquals(_recordingInfo.dropped_relative, _value,
-				    0.1);
-	case Condition::BELOW:
-		return _recordingInfo.dropped_relative < _value;
-	default:
-		break;
-	}
-	return false;
-}
+const static std::map<MacroConditionStats::Aggregation, std::string>
+	aggregationTypes = {
+		{MacroConditionStats::Aggregation::CURRENT,
+		 "AdvSceneSwitcher.condition.stats.aggregation.current"},
+		{MacroConditionStats::Aggregation::AVERAGE,
+		 "AdvSceneSwitcher.condition.stats.aggregation.average"},
+		{MacroConditionStats::Aggregation::MIN,
+		 "AdvSceneSwitcher.condition.stats.aggregation.min"},
+		{MacroConditionStats::Aggregation::MAX,
+		 "AdvSceneSwitcher.condition.stats.aggregation.max"},
+		{MacroConditionStats::Aggregation::PERCENTILE,
+		 "AdvSceneSwitcher.condition.stats.aggregation.percentile"},
+};
 
-bool MacroConditionStats::CheckRecordingBitrate()
+static OBSStatsSampler::Stat getStat(MacroConditionStats::Type type)
 {
-	OBSOutputAutoRelease output = obs_frontend_get_recording_output();
-	_recordingInfo.Update(output);
+	using Stat = OBSStatsSampler::Stat;
+	using Type = MacroConditionStats::Type;
 
-	switch (_condition) {
-	case Condition::ABOVE:
-		return _recordingInfo.kbps > _value;
-	case Condition::EQUALS:
-		return DoubleEquals(_recordingInfo.kbps, _value, 1.0);
-	case Condition::BELOW:
-		return _recordingInfo.kbps < _value;
+	switch (type) {
+	case Type::FPS:
+		return Stat::FPS;
+	case Type::CPU_USAGE:
+		return Stat::CPU_USAGE;
+	case Type::DISK_USAGE:
+		return Stat::DISK_SPACE_AVAILABLE;
+	case Type::MEM_USAGE:
+		return Stat::MEMORY_USAGE;
+	case Type::AVG_FRAMETIME:
+		return Stat::AVG_FRAMETIME;
+	case Type::RENDER_LAG:
+		return Stat::RENDER_LAG;
+	case Type::ENCODE_LAG:
+		return Stat::ENCODE_LAG;
+	case Type::STREAM_DROPPED_FRAMES:
+		return Stat::STREAM_DROPPED_FRAMES;
+	case Type::STREAM_BITRATE:
+		return Stat::STREAM_BITRATE;
+	case Type::STREAM_MB_SENT:
+		return Stat::STREAM_MB_SENT;
+	case Type::RECORDING_DROPPED_FRAMES:
+		return Stat::RECORDING_DROPPED_FRAMES;
+	case Type::RECORDING_BITRATE:
+		return Stat::RECORDING_BITRATE;
+	case Type::RECORDING_MB_SENT:
+		return Stat::RECORDING_MB_SENT;
 	default:
 		break;
 	}
-	return false;
+	return Stat::FPS;
 }
 
-bool MacroConditionStats::CheckRecordingMBSent() const
+static double getEqualsTolerance(MacroConditionStats::Type type)
 {
-	OBSOutputAutoRelease output = obs_frontend_get_recording_output();
-	uint64_t totalBytes = output ? obs_output_get_total_bytes(output) : 0;
-	long double num = (long double)totalBytes / (1024.0l * 1024.0l);
-
-	switch (_condition) {
-	case Condition::ABOVE:
-		return num > _value;
-	case Condition::EQUALS:
-		return DoubleEquals(num, _value, 0.1);
-	case Condition::BELOW:
-		return num < _value;
+	switch (type) {
+	case MacroConditionStats::Type::FPS:
+		return 0.01;
+	case MacroConditionStats::Type::STREAM_BITRATE:
+	case MacroConditionStats::Type::RECORDING_BITRATE:
+		return 1.0;
 	default:
 		break;
 	}
-	return false;
+	return 0.1;
 }
 
-// Based on OBSBasic::GetCurrentOutputPath()
-static const char *getCurrentOutputPath()
+bool MacroConditionStats::CheckCondition()
 {
-	const char *path = nullptr;
-	auto config = obs_frontend_get_profile_config();
-	if (!config) {
-		return path;
+	const auto value = OBSStatsSampler::Instance().Query(
+		getStat(_type), _aggregation,
+		std::chrono::seconds(_windowSeconds), _percentile);
+	if (!value) {
+		return false;
 	}
 
-	const char *mode = config_get_string(config, "Output", "Mode");
-
-	if (strcmp(mode, "Advanced") == 0) {
-		const char *advanced_mode =
-			config_get_string(config, "AdvOut", "RecType");
-
-		if (strcmp(advanced_mode, "FFmpeg") == 0) {
-			path = config_get_string(config, "AdvOut",
-						 "FFFilePath");
-		} else {
-			path = config_get_string(config, "AdvOut",
-						 "RecFilePath");
-		}
-	} else {
-		path = config_get_string(config, "SimpleOutput", "FilePath");
-	}
-
-	return path;
-}
-
-bool MacroConditionStats::CheckDiskUsage() const
-{
-#define MBYTE (1024ULL * 1024ULL)
-	auto path = getCurrentOutputPath();
-	auto mb = os_get_free_disk_space(path) / MBYTE;
 	switch (_condition) {
 	case Condition::ABOVE:
-		return mb > _value;
+		return *value > _value;
 	case Condition::EQUALS:
-		return DoubleEquals(mb, _value, 0.1);
+		return DoubleEquals(*value, _value, getEqualsTolerance(_type));
 	case Condition::BELOW:
-		return mb < _value;
-	default:
-		break;
-	}
-	return false;
-}
-
-bool MacroConditionStats::CheckCondition()
-{
-	switch (_type) {
-	case Type::FPS:
-		return CheckFPS();
-	case Type::CPU_USAGE:
-		return CheckCPU();
-	case Type::DISK_USAGE:
-		return CheckDiskUsage();
-	case Type::MEM_USAGE:
-		return CheckMemory();
-	case Type::AVG_FRAMETIME:
-		return CheckAvgFrametime();
-	case Type::RENDER_LAG:
-		return CheckRenderLag();
-	case Type::ENCODE_LAG:
-		return CheckEncodeLag();
-	case Type::STREAM_DROPPED_FRAMES:
-		return CheckStreamDroppedFrames();
-	case Type::STREAM_BITRATE:
-		return CheckStreamBitrate();
-	case Type::STREAM_MB_SENT:
-		return CheckStreamMBSent();
-	case Type::RECORDING_DROPPED_FRAMES:
-		return CheckRecordingDroppedFrames();
-	case Type::RECORDING_BITRATE:
-		return CheckRecordingBitrate();
-	case Type::RECORDING_MB_SENT:
-		return CheckRecordingMBSent();
+		return *value < _value;
 	default:
 		break;
 	}
-
 	return false;
 }
 
@@ -431,6 +147,9 @@ bool MacroConditionStats::Save(obs_data_t *obj) const
 	_value.Save(obj, "value");
 	obs_data_set_int(obj, "type", static_cast<int>(_type));
 	obs_data_set_int(obj, "condition", static_cast<int>(_condition));
+	obs_data_set_int(obj, "aggregation", static_cast<int>(_aggregation));
+	obs_data_set_int(obj, "window", _windowSeconds);
+	obs_data_set_double(obj, "percentile", _percentile);
 	obs_data_set_int(obj, "version", 1);
 	return true;
 }
@@ -447,6 +166,12 @@ bool MacroConditionStats::Load(obs_data_t *obj)
 	_type = static_cast<MacroConditionStats::Type>(
 		obs_data_get_int(obj, "type"));
 	_condition = static_cast<Condition>(obs_data_get_int(obj, "condition"));
+	_aggregation = static_cast<Aggregation>(
+		obs_data_get_int(obj, "aggregation"));
+	obs_data_set_default_int(obj, "window", 10);
+	_windowSeconds = obs_data_get_int(obj, "window");
+	obs_data_set_default_double(obj, "percentile", 95.);
+	_percentile = obs_data_get_double(obj, "percentile");
 	return true;
 }
 
@@ -474,12 +199,27 @@ MacroConditionStatsEdit::MacroConditionStatsEdit(
 	: QWidget(parent),
 	  _stats(new QComboBox()),
 	  _condition(new QComboBox()),
-	  _value(new VariableDoubleSpinBox())
+	  _value(new VariableDoubleSpinBox()),
+	  _aggregation(new QComboBox()),
+	  _windowLayout(new QHBoxLayout()),
+	  _percentile(new QDoubleSpinBox()),
+	  _window(new QSpinBox())
 {
 	_value->setMaximum(999999999999);
+	_percentile->setMinimum(0.);
+	_percentile->setMaximum(100.);
+	_percentile->setSuffix("%");
+	_window->setMinimum(1);
+	_window->setMaximum(
+		std::chrono::duration_cast<std::chrono::seconds>(
+			OBSStatsSampler::sampleInterval *
+			OBSStatsSampler::historySize)
+			.count());
+	_window->setSuffix("s");
 
 	populateList(_stats, statsTypes);
 	populateList(_condition, statsConditionTypes);
+	populateList(_aggregation, aggregationTypes);
 
 	setToolTip(
 		obs_module_text("AdvSceneSwitcher.condition.stats.dockHint"));
@@ -492,13 +232,38 @@ MacroConditionStatsEdit::MacroConditionStatsEdit(
 			 SLOT(StatsTypeChanged(int)));
 	QWidget::connect(_condition, SIGNAL(currentIndexChanged(int)), this,
 			 SLOT(ConditionChanged(int)));
-
-	auto layout = new QHBoxLayout;
+	QWidget::connect(_aggregation, SIGNAL(currentIndexChanged(int)), this,
+			 SLOT(AggregationChanged(int)));
+	QWidget::connect(_window, SIGNAL(valueChanged(int)), this,
+			 SLOT(WindowChanged(int)));
+	QWidget::connect(_percentile, SIGNAL(valueChanged(double)), this,
+			 SLOT(PercentileChanged(double)));
+
+	const std::unordered_map<std::string, QWidget *> widgetPlaceholders = {
+		{"{{value}}", _value},
+		{"{{stats}}", _stats},
+		{"{{condition}}", _condition},
+		{"{{aggregation}}", _aggregation},
+		{"{{percentile}}", _percentile},
+		{"{{window}}", _window},
+	};
+	auto entryLayout = new QHBoxLayout;
 	PlaceWidgets(obs_module_text("AdvSceneSwitcher.condition.stats.entry"),
-		     layout,
-		     {{"{{value}}", _value},
-		      {"{{stats}}", _stats},
-		      {"{{condition}}", _condition}});
+		     entryLayout, widgetPlaceholders);
+	auto aggregationLayout = new QHBoxLayout;
+	PlaceWidgets(
+		obs_module_text(
+			"AdvSceneSwitcher.condition.stats.entry.aggregation"),
+		aggregationLayout, widgetPlaceholders, false);
+	PlaceWidgets(obs_module_text(
+			     "AdvSceneSwitcher.condition.stats.entry.window"),
+		     _windowLayout, widgetPlaceholders, false);
+	aggregationLayout->addLayout(_windowLayout);
+	aggregationLayout->addStretch();
+
+	auto layout = new QVBoxLayout;
+	layout->addLayout(entryLayout);
+	layout->addLayout(aggregationLayout);
 	setLayout(layout);
 
 	_entryData = entryData;
@@ -532,6 +297,28 @@ void MacroConditionStatsEdit::ConditionChanged(int cond)
 		static_cast<MacroConditionStats::Condition>(cond);
 }
 
+void MacroConditionStatsEdit::AggregationChanged(int value)
+{
+	{
+		GUARD_LOADING_AND_LOCK();
+		_entryData->_aggregation =
+			static_cast<MacroConditionStats::Aggregation>(value);
+	}
+	SetWidgetVisibility();
+}
+
+void MacroConditionStatsEdit::WindowChanged(int value)
+{
+	GUARD_LOADING_AND_LOCK();
+	_entryData->_windowSeconds = value;
+}
+
+void MacroConditionStatsEdit::PercentileChanged(double value)
+{
+	GUARD_LOADING_AND_LOCK();
+	_entryData->_percentile = value;
+}
+
 void MacroConditionStatsEdit::UpdateEntryData()
 {
 	if (!_entryData) {
@@ -541,6 +328,10 @@ void MacroConditionStatsEdit::UpdateEntryData()
 	_value->SetValue(_entryData->_value);
 	_stats->setCurrentIndex(static_cast<int>(_entryData->_type));
 	_condition->setCurrentIndex(static_cast<int>(_entryData->_condition));
+	_aggregation->setCurrentIndex(
+		static_cast<int>(_entryData->_aggregation));
+	_window->setValue(_entryData->_windowSeconds);
+	_percentile->setValue(_entryData->_percentile);
 	SetWidgetVisibility();
 }
 
@@ -550,6 +341,12 @@ void MacroConditionStatsEdit::SetWidgetVisibility()
 		return;
 	}
 
+	SetLayoutVisible(_windowLayout,
+			 _entryData->_aggregation !=
+				 MacroConditionStats::Aggregation::CURRENT);
+	_percentile->setVisible(_entryData->_aggregation ==
+				MacroConditionStats::Aggregation::PERCENTILE);
+
 	switch (_entryData->_type) {
 	case MacroConditionStats::Type::FPS:
 		_value->setMaximum(1000);
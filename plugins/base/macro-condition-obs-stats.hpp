@@ -1,18 +1,20 @@
 #pragma once
 #include "macro-condition-edit.hpp"
+#include "obs-stats-sampler.hpp"
 #include "variable-spinbox.hpp"
 
 #include <obs.hpp>
 #include <QWidget>
 #include <QComboBox>
-#include <util/platform.h>
+#include <QDoubleSpinBox>
+#include <QHBoxLayout>
+#include <QSpinBox>
 
 namespace advss {
 
 class MacroConditionStats : public MacroCondition {
 public:
-	MacroConditionStats(Macro *m);
-	~MacroConditionStats();
+	MacroConditionStats(Macro *m) : MacroCondition(m) {}
 	bool CheckCondition();
 	bool Save(obs_data_t *obj) const;
 	bool Load(obs_data_t *obj);
@@ -49,39 +51,14 @@ public:
 	};
 	Condition _condition = Condition::ABOVE;
 
-private:
-	bool CheckFPS() const;
-	bool CheckCPU() const;
-	bool CheckMemory() const;
-	bool CheckAvgFrametime() const;
-	bool CheckRenderLag();
-	bool CheckEncodeLag();
-	bool CheckStreamDroppedFrames();
-	bool CheckStreamBitrate();
-	bool CheckStreamMBSent() const;
-	bool CheckRecordingDroppedFrames();
-	bool CheckRecordingBitrate();
-	bool CheckRecordingMBSent() const;
-	bool CheckDiskUsage() const;
-
-	os_cpu_usage_info_t *_cpu_info = nullptr;
-	uint32_t _first_encoded = 0xFFFFFFFF;
-	uint32_t _first_skipped = 0xFFFFFFFF;
-	uint32_t _first_rendered = 0xFFFFFFFF;
-	uint32_t _first_lagged = 0xFFFFFFFF;
-	struct OutputInfo {
-		void Update(obs_output_t *output);
-
-		uint64_t lastBytesSent = 0;
-		uint64_t lastBytesSentTime = 0;
-		int first_total = 0;
-		int first_dropped = 0;
-		double dropped_relative = 0.0;
-		long double kbps = 0.0l;
-	};
-	OutputInfo _streamInfo;
-	OutputInfo _recordingInfo;
+	// The values are sampled periodically, so they can be combined over a
+	// time window to avoid reacting to short spikes
+	using Aggregation = OBSStatsSampler::Aggregation;
+	Aggregation _aggregation = Aggregation::CURRENT;
+	int _windowSeconds = 10;
+	double _percentile = 95.;
 
+private:
 	static bool _registered;
 	static const std::string id;
 };
@@ -106,6 +83,9 @@ private slots:
 	void ValueChanged(const NumberVariable<double> &value);
 	void StatsTypeChanged(int type);
 	void ConditionChanged(int cond);
+	void AggregationChanged(int);
+	void WindowChanged(int);
+	void PercentileChanged(double);
 
 signals:
 	void HeaderInfoChanged(const QString &);
@@ -116,6 +96,10 @@ private:
 	QComboBox *_stats;
 	QComboBox *_condition;
 	VariableDoubleSpinBox *_value;
+	QComboBox *_aggregation;
+	QHBoxLayout *_windowLayout;
+	QDoubleSpinBox *_percentile;
+	QSpinBox *_window;
 
 	std::shared_ptr<MacroConditionStats> _entryData;
 	bool _loading = true;
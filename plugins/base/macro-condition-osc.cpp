@@ -0,0 +1,242 @@
+#include "macro-condition-osc.hpp"
+#include "help-icon.hpp"
+#include "layout-helpers.hpp"
+#include "macro-helpers.hpp"
+
+namespace advss {
+
+const std::string MacroConditionOSC::id = "osc";
+
+bool MacroConditionOSC::_registered = MacroConditionFactory::Register(
+	MacroConditionOSC::id,
+	{MacroConditionOSC::Create, MacroConditionOSCEdit::Create,
+	 "AdvSceneSwitcher.condition.osc"});
+
+// Only the first few arguments are made available as separate variables, as
+// the number of temp vars has to be known in advance
+constexpr int maxArgumentTempVars = 8;
+
+static std::string joinArguments(const std::vector<std::string> &arguments)
+{
+	std::string result;
+	for (const auto &argument : arguments) {
+		if (!result.empty()) {
+			result += " ";
+		}
+		result += argument;
+	}
+	return result;
+}
+
+void MacroConditionOSC::Subscribe()
+{
+	const int port = _port;
+	const std::string pattern = _pattern;
+	if (_messageBuffer && _subscribedProtocol == _protocol &&
+	    _subscribedPort == port && _subscribedPattern == pattern) {
+		return;
+	}
+
+	_subscribedProtocol = _protocol;
+	_subscribedPort = port;
+	_subscribedPattern = pattern;
+	_server = OSCServer::Get(_protocol, port);
+	_messageBuffer = _server->Subscribe(pattern);
+}
+
+bool MacroConditionOSC::CheckCondition()
+{
+	Subscribe();
+
+	const bool macroWasPausedSinceLastCheck =
+		MacroWasPausedSince(GetMacro(), _lastCheck);
+	_lastCheck = std::chrono::high_resolution_clock::now();
+	if (macroWasPausedSinceLastCheck) {
+		_messageBuffer->Clear();
+		return false;
+	}
+
+	auto message = _messageBuffer->ConsumeMessage();
+	if (!message) {
+		SetVariableValue("");
+		return false;
+	}
+
+	SetTempVarValues(*message);
+	SetVariableValue(joinArguments(message->arguments));
+	if (_clearBufferOnMatch) {
+		_messageBuffer->Clear();
+	}
+	return true;
+}
+
+bool MacroConditionOSC::Save(obs_data_t *obj) const
+{
+	MacroCondition::Save(obj);
+	obs_data_set_int(obj, "protocol", static_cast<int>(_protocol));
+	_port.Save(obj, "port");
+	_pattern.Save(obj, "pattern");
+	obs_data_set_bool(obj, "clearBufferOnMatch", _clearBufferOnMatch);
+	return true;
+}
+
+bool MacroConditionOSC::Load(obs_data_t *obj)
+{
+	MacroCondition::Load(obj);
+	_protocol = static_cast<OSCServer::Protocol>(
+		obs_data_get_int(obj, "protocol"));
+	_port.Load(obj, "port");
+	_pattern.Load(obj, "pattern");
+	_clearBufferOnMatch = obs_data_get_bool(obj, "clearBufferOnMatch");
+	return true;
+}
+
+std::string MacroConditionOSC::GetShortDesc() const
+{
+	return _pattern.UnresolvedValue();
+}
+
+std::string MacroConditionOSC::GetListenError() const
+{
+	return OSCServer::GetError(_protocol, _port);
+}
+
+void MacroConditionOSC::SetupTempVars()
+{
+	MacroCondition::SetupTempVars();
+	AddTempvar("address",
+		   obs_module_text("AdvSceneSwitcher.tempVar.osc.address"));
+	AddTempvar(
+		"arguments",
+		obs_module_text("AdvSceneSwitcher.tempVar.osc.arguments"),
+		obs_module_text(
+			"AdvSceneSwitcher.tempVar.osc.arguments.description"));
+	for (int i = 1; i <= maxArgumentTempVars; ++i) {
+		const QString name = obs_module_text(
+			"AdvSceneSwitcher.tempVar.osc.argument");
+		AddTempvar("argument" + std::to_string(i),
+			   name.arg(i).toStdString());
+	}
+}
+
+void MacroConditionOSC::SetTempVarValues(const OSCReceivedMessage &message)
+{
+	SetTempVarValue("address", message.address);
+	SetTempVarValue("arguments", joinArguments(message.arguments));
+	for (int i = 1; i <= maxArgumentTempVars; ++i) {
+		SetTempVarValue("argument" + std::to_string(i),
+				i <= (int)message.arguments.size()
+					? message.arguments[i - 1]
+					: "");
+	}
+}
+
+static void populateProtocolSelection(QComboBox *list)
+{
+	list->addItem("TCP");
+	list->addItem("UDP");
+}
+
+MacroConditionOSCEdit::MacroConditionOSCEdit(
+	QWidget *parent, std::shared_ptr<MacroConditionOSC> entryData)
+	: QWidget(parent),
+	  _protocol(new QComboBox(this)),
+	  _port(new VariableSpinBox(this)),
+	  _pattern(new VariableLineEdit(this)),
+	  _clearBufferOnMatch(new QCheckBox(
+		  obs_module_text("AdvSceneSwitcher.clearBufferOnMatch"))),
+	  _listenError(new QLabel())
+{
+	populateProtocolSelection(_protocol);
+	_port->setMaximum(65535);
+
+	QWidget::connect(_protocol, SIGNAL(currentIndexChanged(int)), this,
+			 SLOT(ProtocolChanged(int)));
+	QWidget::connect(
+		_port,
+		SIGNAL(NumberVariableChanged(const NumberVariable<int> &)),
+		this, SLOT(PortChanged(const NumberVariable<int> &)));
+	QWidget::connect(_pattern, SIGNAL(editingFinished()), this,
+			 SLOT(PatternChanged()));
+	QWidget::connect(_clearBufferOnMatch, SIGNAL(stateChanged(int)), this,
+			 SLOT(ClearBufferOnMatchChanged(int)));
+	QWidget::connect(&_timer, SIGNAL(timeout()), this,
+			 SLOT(UpdateListenError()));
+
+	auto entryLayout = new QHBoxLayout();
+	PlaceWidgets(obs_module_text("AdvSceneSwitcher.condition.osc.entry"),
+		     entryLayout,
+		     {{"{{protocol}}", _protocol},
+		      {"{{port}}", _port},
+		      {"{{pattern}}", _pattern},
+		      {"{{tooltip}}",
+		       new HelpIcon(obs_module_text(
+			       "AdvSceneSwitcher.condition.osc.tooltip"))}});
+
+	auto layout = new QVBoxLayout();
+	layout->addLayout(entryLayout);
+	layout->addWidget(_clearBufferOnMatch);
+	layout->addWidget(_listenError);
+	setLayout(layout);
+
+	_entryData = entryData;
+	UpdateEntryData();
+	UpdateListenError();
+	_timer.start(1000);
+	_loading = false;
+}
+
+void MacroConditionOSCEdit::UpdateEntryData()
+{
+	if (!_entryData) {
+		return;
+	}
+
+	_protocol->setCurrentIndex(static_cast<int>(_entryData->_protocol));
+	_port->SetValue(_entryData->_port);
+	_pattern->setText(_entryData->_pattern);
+	_clearBufferOnMatch->setChecked(_entryData->_clearBufferOnMatch);
+}
+
+void MacroConditionOSCEdit::ProtocolChanged(int value)
+{
+	GUARD_LOADING_AND_LOCK();
+	_entryData->_protocol = static_cast<OSCServer::Protocol>(value);
+}
+
+void MacroConditionOSCEdit::PortChanged(const NumberVariable<int> &value)
+{
+	GUARD_LOADING_AND_LOCK();
+	_entryData->_port = value;
+}
+
+void MacroConditionOSCEdit::PatternChanged()
+{
+	GUARD_LOADING_AND_LOCK();
+	_entryData->_pattern = _pattern->text().toStdString();
+	emit HeaderInfoChanged(
+		QString::fromStdString(_entryData->GetShortDesc()));
+}
+
+void MacroConditionOSCEdit::ClearBufferOnMatchChanged(int value)
+{
+	GUARD_LOADING_AND_LOCK();
+	_entryData->_clearBufferOnMatch = value;
+}
+
+void MacroConditionOSCEdit::UpdateListenError()
+{
+	if (!_entryData) {
+		_listenError->hide();
+		return;
+	}
+
+	const auto error = _entryData->GetListenError();
+	_listenError->setText(
+		QString(obs_module_text(
+				"AdvSceneSwitcher.condition.osc.listenError"))
+			.arg(QString::fromStdString(error)));
+	_listenError->setVisible(!error.empty());
+}
+
+} // namespace advss
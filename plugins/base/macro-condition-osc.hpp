@@ -0,0 +1,85 @@
+#pragma once
+#include "macro-condition-edit.hpp"
+#include "osc-server.hpp"
+#include "variable-line-edit.hpp"
+#include "variable-spinbox.hpp"
+
+#include <QCheckBox>
+#include <QLabel>
+#include <QTimer>
+
+namespace advss {
+
+class MacroConditionOSC : public MacroCondition {
+public:
+	MacroConditionOSC(Macro *m) : MacroCondition(m, true) {}
+	bool CheckCondition();
+	bool Save(obs_data_t *obj) const;
+	bool Load(obs_data_t *obj);
+	std::string GetShortDesc() const;
+	std::string GetId() const { return id; };
+	std::string GetListenError() const;
+	static std::shared_ptr<MacroCondition> Create(Macro *m)
+	{
+		return std::make_shared<MacroConditionOSC>(m);
+	}
+
+	OSCServer::Protocol _protocol = OSCServer::Protocol::UDP;
+	IntVariable _port = 12345;
+	StringVariable _pattern = "/*";
+	bool _clearBufferOnMatch = false;
+
+private:
+	void Subscribe();
+	void SetupTempVars();
+	void SetTempVarValues(const OSCReceivedMessage &);
+
+	std::shared_ptr<OSCServer> _server;
+	OSCMessageBuffer _messageBuffer;
+	OSCServer::Protocol _subscribedProtocol = OSCServer::Protocol::UDP;
+	int _subscribedPort = 0;
+	std::string _subscribedPattern;
+	std::chrono::high_resolution_clock::time_point _lastCheck{};
+
+	static bool _registered;
+	static const std::string id;
+};
+
+class MacroConditionOSCEdit : public QWidget {
+	Q_OBJECT
+
+public:
+	MacroConditionOSCEdit(
+		QWidget *parent,
+		std::shared_ptr<MacroConditionOSC> cond = nullptr);
+	void UpdateEntryData();
+	static QWidget *Create(QWidget *parent,
+			       std::shared_ptr<MacroCondition> cond)
+	{
+		return new MacroConditionOSCEdit(
+			parent,
+			std::dynamic_pointer_cast<MacroConditionOSC>(cond));
+	}
+
+private slots:
+	void ProtocolChanged(int);
+	void PortChanged(const NumberVariable<int> &);
+	void PatternChanged();
+	void ClearBufferOnMatchChanged(int);
+	void UpdateListenError();
+signals:
+	void HeaderInfoChanged(const QString &);
+
+private:
+	QComboBox *_protocol;
+	VariableSpinBox *_port;
+	VariableLineEdit *_pattern;
+	QCheckBox *_clearBufferOnMatch;
+	QLabel *_listenError;
+	QTimer _timer;
+
+	std::shared_ptr<MacroConditionOSC> _entryData;
+	bool _loading = true;
+};
+
+} // namespace advss
@@ -1,4 +1,5 @@
 #include "macro-condition-recording.hpp"
+#include "frontend-state.hpp"
 #include "layout-helpers.hpp"
 
 #include <obs-frontend-api.h>
@@ -33,11 +34,11 @@ bool MacroConditionRecord::CheckCondition()
 {
 	switch (_condition) {
 	case Condition::STOP:
-		return !obs_frontend_recording_active();
+		return !FrontendRecordingActive();
 	case Condition::PAUSE:
-		return obs_frontend_recording_paused();
+		return FrontendRecordingPaused();
 	case Condition::START:
-		return obs_frontend_recording_active();
+		return FrontendRecordingActive();
 	case Condition::DURATION:
 		SetTempVarValue(
 			"durationSeconds",
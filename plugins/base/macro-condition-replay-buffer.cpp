@@ -1,4 +1,5 @@
 #include "macro-condition-replay-buffer.hpp"
+#include "frontend-state.hpp"
 #include "layout-helpers.hpp"
 
 #include <obs-frontend-api.h>
@@ -60,9 +61,9 @@ bool MacroConditionReplayBuffer::CheckCondition()
 {
 	switch (_state) {
 	case Condition::STOP:
-		return !obs_frontend_replay_buffer_active();
+		return !FrontendReplayBufferActive();
 	case Condition::START:
-		return obs_frontend_replay_buffer_active();
+		return FrontendReplayBufferActive();
 	case Condition::SAVE:
 		return ReplayBufferWasSaved();
 	default:
@@ -21,10 +21,61 @@ MacroConditionRun::~MacroConditionRun()
 
 bool MacroConditionRun::CheckCondition()
 {
+	if (_procConfig.IsCoprocess()) {
+		return CheckCoprocess();
+	}
+
 	if (!_threadDone) {
 		return false;
 	}
 
+	const bool ret = CheckResult();
+
+	if (_thread.joinable()) {
+		_thread.join();
+	}
+
+	_threadDone = false;
+	_thread = std::thread(&MacroConditionRun::RunProcess, this);
+
+	return ret;
+}
+
+bool MacroConditionRun::CheckCoprocess()
+{
+	// The process is kept running, so no thread is required to wait for it
+	if (_coprocessResponse.valid() &&
+	    _coprocessResponse.wait_for(std::chrono::seconds(0)) !=
+		    std::future_status::ready) {
+		return false;
+	}
+
+	bool ret = false;
+	if (_coprocessResponse.valid()) {
+		auto result = _procConfig.SetCoprocessResponse(
+			_coprocessResponse.get());
+		if (std::holds_alternative<ProcessConfig::ProcStartError>(
+			    result)) {
+			_error = std::get<ProcessConfig::ProcStartError>(
+				result);
+		} else {
+			_error = ProcessConfig::ProcStartError::NONE;
+			_procExitCode = std::get<int>(result);
+		}
+		SetTempVarValues();
+		ret = CheckResult();
+		if (_error == ProcessConfig::ProcStartError::NONE) {
+			SetVariableValue(_procConfig.GetProcessOutputStream());
+		}
+	}
+
+	_coprocessResponse =
+		_procConfig.SendToCoprocess(_timeout.Milliseconds());
+	return ret;
+}
+
+bool MacroConditionRun::CheckResult()
+{
 	bool ret = false;
 
 	switch (_error) {
@@ -44,14 +95,6 @@ bool MacroConditionRun::CheckCondition()
 	default:
 		break;
 	}
-
-	if (_thread.joinable()) {
-		_thread.join();
-	}
-
-	_threadDone = false;
-	_thread = std::thread(&MacroConditionRun::RunProcess, this);
-
 	return ret;
 }
 
@@ -3,6 +3,7 @@
 #include "process-config.hpp"
 #include "duration-control.hpp"
 
+#include <future>
 #include <thread>
 #include <QCheckBox>
 #include <QSpinBox>
@@ -30,6 +31,8 @@ public:
 
 private:
 	void RunProcess();
+	bool CheckCoprocess();
+	bool CheckResult();
 
 	void SetupTempVars();
 	void SetTempVarValues();
@@ -39,6 +42,7 @@ private:
 	ProcessConfig::ProcStartError _error =
 		ProcessConfig::ProcStartError::NONE;
 	int _procExitCode = 0;
+	std::future<Coprocess::Response> _coprocessResponse;
 
 	static bool _registered;
 	static const std::string id;
@@ -42,13 +42,14 @@ static const std::map<MacroConditionSceneTransform::Condition, std::string>
 
 static bool doesTransformOfAnySceneItemMatch(
 	const std::vector<OBSSceneItem> &items, const std::string &jsonCompare,
-	const RegexConfig &regex, std::string &newVariable)
+	const RegexConfig &regex, JsonMatcher &matcher,
+	std::string &newVariable)
 {
 	bool ret = false;
 	std::string json;
 	for (const auto &item : items) {
 		json = GetSceneItemTransform(item);
-		if (MatchJson(json, jsonCompare, regex)) {
+		if (matcher.Matches(json, jsonCompare, regex)) {
 			ret = true;
 		}
 	}
@@ -63,7 +64,6 @@ didTransformOfAnySceneItemChange(const std::vector<OBSSceneItem> &items,
 {
 	bool ret = false;
 	std::string json;
-	RegexConfig regex;
 	auto numItems = items.size();
 	if (previousTransform.size() < numItems) {
 		ret = true;
@@ -72,7 +72,7 @@ didTransformOfAnySceneItemChange(const std::vector<OBSSceneItem> &items,
 	for (size_t idx = 0; idx < numItems; ++idx) {
 		auto const &item = items[idx];
 		json = GetSceneItemTransform(item);
-		if (!MatchJson(json, previousTransform[idx], regex)) {
+		if (json != previousTransform[idx]) {
 			ret = true;
 			previousTransform[idx] = json;
 		}
@@ -89,7 +89,8 @@ bool MacroConditionSceneTransform::CheckAllSettings(
 	switch (_condition) {
 	case Condition::MATCHES:
 		ret = doesTransformOfAnySceneItemMatch(items, _transformString,
-						       _regex, newVariable);
+						       _regex, _jsonMatcher,
+						       newVariable);
 		break;
 	case Condition::CHANGED:
 		ret = didTransformOfAnySceneItemChange(
@@ -1,5 +1,6 @@
 #pragma once
 #include "macro-condition-edit.hpp"
+#include "json-helpers.hpp"
 #include "regex-config.hpp"
 #include "scene-item-selection.hpp"
 #include "scene-selection.hpp"
@@ -53,6 +54,7 @@ private:
 	SettingsType _settingsType = SettingsType::SINGLE;
 	Condition _condition = Condition::MATCHES;
 
+	JsonMatcher _jsonMatcher;
 	std::vector<std::string> _previousTransform;
 	std::vector<std::string> _previousSettingValues;
 
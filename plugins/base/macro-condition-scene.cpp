@@ -1,4 +1,5 @@
 #include "macro-condition-scene.hpp"
+#include "frontend-state.hpp"
 #include "layout-helpers.hpp"
 #include "scene-switch-helpers.hpp"
 #include "source-helpers.hpp"
@@ -82,10 +83,7 @@ bool MacroConditionScene::CheckCondition()
 		return scene == _scene.GetScene(false);
 	}
 	case Type::PREVIEW: {
-		OBSSourceAutoRelease source =
-			obs_frontend_get_current_preview_scene();
-		OBSWeakSourceAutoRelease scene =
-			obs_source_get_weak_source(source);
+		const auto scene = FrontendPreviewScene();
 		SetVariableValue(GetWeakSourceName(scene));
 		SetTempVarValue("preview", GetWeakSourceName(scene));
 		return scene == _scene.GetScene(false);
@@ -113,13 +111,10 @@ bool MacroConditionScene::CheckCondition()
 		return sceneNameMatchesRegex(scene, _regex, _pattern);
 	}
 	case Type::PREVIEW_PATTERN: {
-		OBSSourceAutoRelease source =
-			obs_frontend_get_current_preview_scene();
-		OBSWeakSourceAutoRelease scene =
-			obs_source_get_weak_source(source);
+		const auto scene = FrontendPreviewScene();
 		SetVariableValue(GetWeakSourceName(scene));
 		SetTempVarValue("preview", GetWeakSourceName(scene));
-		return sceneNameMatchesRegex(scene.Get(), _regex, _pattern);
+		return sceneNameMatchesRegex(scene, _regex, _pattern);
 	}
 	}
 
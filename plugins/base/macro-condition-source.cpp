@@ -4,6 +4,7 @@
 #include "text-helpers.hpp"
 #include "selection-helpers.hpp"
 #include "source-settings-helpers.hpp"
+#include "source-settings-watcher.hpp"
 
 namespace advss {
 
@@ -78,24 +79,44 @@ bool MacroConditionSource::CheckCondition()
 		ret = obs_source_showing(s);
 		break;
 	case Condition::ALL_SETTINGS_MATCH: {
-		ret = CompareSourceSettings(_source.GetSource(), _settings,
-					    _regex);
-		const auto settings = GetSourceSettings(_source.GetSource());
+		const auto &source = _source.GetSource();
+		auto &watcher = SourceSettingsWatcher::Instance();
+		const std::string pattern = _settings;
+		if (!_settingsCache.IsValid(source, watcher.GetVersion(source),
+					    pattern)) {
+			uint64_t version = 0;
+			const auto settings =
+				watcher.GetSettings(source, version);
+			_settingsCache.Update(
+				source, version, pattern, settings,
+				_jsonMatcher.Matches(settings, pattern,
+						     _regex));
+		}
+		ret = _settingsCache.Result();
+		const auto settings = _settingsCache.Value().value_or("");
 		SetVariableValue(settings);
 		SetTempVarValue("settings", settings);
 		break;
 	}
 	case Condition::SETTINGS_CHANGED: {
-		const auto settings = GetSourceSettings(_source.GetSource());
-		ret = !_currentSettings.empty() && settings != _currentSettings;
-		_currentSettings = settings;
-		SetVariableValue(settings);
-		SetTempVarValue("settings", settings);
+		const auto &source = _source.GetSource();
+		auto &watcher = SourceSettingsWatcher::Instance();
+		if (!_settingsCache.IsValid(source,
+					    watcher.GetVersion(source))) {
+			uint64_t version = 0;
+			const auto settings =
+				watcher.GetSettings(source, version);
+			ret = !_currentSettings.empty() &&
+			      settings != _currentSettings;
+			_currentSettings = settings;
+			_settingsCache.Update(source, version, "", {}, ret);
+		}
+		SetVariableValue(_currentSettings);
+		SetTempVarValue("settings", _currentSettings);
 		break;
 	}
 	case Condition::INDIVIDUAL_SETTING_MATCH: {
-		const auto value =
-			GetSourceSettingValue(_source.GetSource(), _setting);
+		const auto value = GetSettingValue();
 		if (!value) {
 			return false;
 		}
@@ -106,8 +127,7 @@ bool MacroConditionSource::CheckCondition()
 		break;
 	}
 	case Condition::INDIVIDUAL_SETTING_CHANGED: {
-		const auto value =
-			GetSourceSettingValue(_source.GetSource(), _setting);
+		const auto value = GetSettingValue();
 		if (!value) {
 			return false;
 		}
@@ -140,6 +160,26 @@ bool MacroConditionSource::CheckCondition()
 	return ret;
 }
 
+std::optional<std::string> MacroConditionSource::GetSettingValue()
+{
+	const auto &source = _source.GetSource();
+	const auto version =
+		SourceSettingsWatcher::Instance().GetVersion(source);
+	if (_settingsCache.IsValid(source, version, _setting.GetID())) {
+		return _settingsCache.Value();
+	}
+
+	OBSSourceAutoRelease s = obs_weak_source_get_source(source);
+	auto value = LookupSourceSetting(s, _setting.GetID());
+	_settingsCache.Update(source, version, _setting.GetID(), value, false);
+	return value;
+}
+
+void MacroConditionSource::ResetSettingsCache()
+{
+	_settingsCache.Reset();
+}
+
 bool MacroConditionSource::Save(obs_data_t *obj) const
 {
 	MacroCondition::Save(obj);
@@ -147,6 +187,7 @@ bool MacroConditionSource::Save(obs_data_t *obj) const
 	obs_data_set_int(obj, "condition", static_cast<int>(_condition));
 	_settings.Save(obj, "settings");
 	_regex.Save(obj);
+	_jsonMatcher.Save(obj);
 	_setting.Save(obj);
 	_size.Save(obj, "size");
 	obs_data_set_int(obj, "sizeComparisionMethod",
@@ -167,6 +208,7 @@ bool MacroConditionSource::Load(obs_data_t *obj)
 		_regex.CreateBackwardsCompatibleRegex(
 			obs_data_get_bool(obj, "regex"));
 	}
+	_jsonMatcher.Load(obj);
 	_setting.Load(obj);
 	_size.Load(obj, "size");
 	_comparision = static_cast<SizeComparision>(
@@ -182,6 +224,7 @@ std::string MacroConditionSource::GetShortDesc() const
 void MacroConditionSource::SetCondition(Condition cond)
 {
 	_condition = cond;
+	_settingsCache.Reset();
 	SetupTempVars();
 }
 
@@ -238,6 +281,7 @@ MacroConditionSourceEdit::MacroConditionSourceEdit(
 		  "AdvSceneSwitcher.condition.source.getSettings"))),
 	  _settings(new VariableTextEdit(this)),
 	  _regex(new RegexConfigWidget(parent)),
+	  _jsonMatchMode(new QComboBox()),
 	  _settingSelection(new SourceSettingSelection()),
 	  _refreshSettingSelection(new QPushButton(obs_module_text(
 		  "AdvSceneSwitcher.condition.source.refresh"))),
@@ -246,6 +290,7 @@ MacroConditionSourceEdit::MacroConditionSourceEdit(
 {
 	populateSelection(_conditions, sourceConditionTypes);
 	populateSelection(_sizeCompareMethods, compareMethods);
+	PopulateJsonMatchModeSelection(_jsonMatchMode);
 	auto sources = GetSourceNames();
 	sources.sort();
 	auto scenes = GetSceneNames();
@@ -267,6 +312,8 @@ MacroConditionSourceEdit::MacroConditionSourceEdit(
 	QWidget::connect(_regex,
 			 SIGNAL(RegexConfigChanged(const RegexConfig &)), this,
 			 SLOT(RegexChanged(const RegexConfig &)));
+	QWidget::connect(_jsonMatchMode, SIGNAL(currentIndexChanged(int)),
+			 this, SLOT(JsonMatchModeChanged(int)));
 	QWidget::connect(_settingSelection,
 			 SIGNAL(SelectionChanged(const SourceSetting &)), this,
 			 SLOT(SettingSelectionChanged(const SourceSetting &)));
@@ -300,7 +347,9 @@ MacroConditionSourceEdit::MacroConditionSourceEdit(
 	PlaceWidgets(obs_module_text(
 			     "AdvSceneSwitcher.condition.source.entry.line3"),
 		     line3Layout,
-		     {{"{{getSettings}}", _getSettings}, {"{{regex}}", _regex}},
+		     {{"{{getSettings}}", _getSettings},
+		      {"{{regex}}", _regex},
+		      {"{{jsonMatchMode}}", _jsonMatchMode}},
 		     true);
 	auto mainLayout = new QVBoxLayout;
 	mainLayout->addLayout(line1Layout);
@@ -386,11 +435,24 @@ void MacroConditionSourceEdit::RegexChanged(const RegexConfig &conf)
 
 	auto lock = LockContext();
 	_entryData->_regex = conf;
+	_entryData->ResetSettingsCache();
 
 	adjustSize();
 	updateGeometry();
 }
 
+void MacroConditionSourceEdit::JsonMatchModeChanged(int index)
+{
+	if (_loading || !_entryData) {
+		return;
+	}
+
+	auto lock = LockContext();
+	_entryData->_jsonMatcher.SetMode(static_cast<JsonMatcher::Mode>(
+		_jsonMatchMode->itemData(index).toInt()));
+	_entryData->ResetSettingsCache();
+}
+
 void MacroConditionSourceEdit::SettingSelectionChanged(
 	const SourceSetting &setting)
 {
@@ -438,6 +500,9 @@ void MacroConditionSourceEdit::SetWidgetVisibility()
 	_settings->setVisible(settingsMatch);
 	_getSettings->setVisible(settingsMatch);
 	_regex->setVisible(settingsMatch);
+	_jsonMatchMode->setVisible(
+		_entryData->GetCondition() ==
+		MacroConditionSource::Condition::ALL_SETTINGS_MATCH);
 	_settingSelection->setVisible(
 		_entryData->GetCondition() ==
 			MacroConditionSource::Condition::INDIVIDUAL_SETTING_MATCH ||
@@ -483,6 +548,8 @@ void MacroConditionSourceEdit::UpdateEntryData()
 		static_cast<int>(_entryData->GetCondition()));
 	_settings->setPlainText(_entryData->_settings);
 	_regex->SetRegexConfig(_entryData->_regex);
+	_jsonMatchMode->setCurrentIndex(_jsonMatchMode->findData(
+		static_cast<int>(_entryData->_jsonMatcher.GetMode())));
 	_settingSelection->SetSource(_entryData->_source.GetSource());
 	_settingSelection->SetSetting(_entryData->_setting);
 	_size->SetValue(_entryData->_size);
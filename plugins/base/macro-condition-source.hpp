@@ -1,9 +1,11 @@
 #pragma once
 #include "macro-condition-edit.hpp"
 #include "variable-text-edit.hpp"
+#include "json-helpers.hpp"
 #include "regex-config.hpp"
 #include "source-selection.hpp"
 #include "source-setting.hpp"
+#include "source-settings-watcher.hpp"
 
 #include <QComboBox>
 #include <QPushButton>
@@ -36,6 +38,7 @@ public:
 	};
 	void SetCondition(Condition);
 	Condition GetCondition() const { return _condition; }
+	void ResetSettingsCache();
 
 	enum class SizeComparision { LESS, EQUAL, MORE };
 
@@ -43,15 +46,18 @@ public:
 	StringVariable _settings = "";
 	SourceSetting _setting;
 	RegexConfig _regex;
+	JsonMatcher _jsonMatcher;
 	IntVariable _size;
 	SizeComparision _comparision = SizeComparision::EQUAL;
 
 private:
 	void SetupTempVars();
+	std::optional<std::string> GetSettingValue();
 
 	Condition _condition = Condition::ACTIVE;
 	std::string _currentSettings;
 	std::string _currentSettingsValue;
+	SourceSettingsCache _settingsCache;
 
 	static bool _registered;
 	static const std::string id;
@@ -79,6 +85,7 @@ private slots:
 	void GetSettingsClicked();
 	void SettingsChanged();
 	void RegexChanged(const RegexConfig &);
+	void JsonMatchModeChanged(int);
 	void SettingSelectionChanged(const SourceSetting &);
 	void RefreshVariableSourceSelectionValue();
 	void SizeChanged(const NumberVariable<int> &value);
@@ -92,6 +99,7 @@ protected:
 	QPushButton *_getSettings;
 	VariableTextEdit *_settings;
 	RegexConfigWidget *_regex;
+	QComboBox *_jsonMatchMode;
 	SourceSettingSelection *_settingSelection;
 	QPushButton *_refreshSettingSelection;
 	VariableSpinBox *_size;
@@ -1,4 +1,5 @@
 #include "macro-condition-streaming.hpp"
+#include "frontend-state.hpp"
 #include "profile-helpers.hpp"
 #include "layout-helpers.hpp"
 #include "ui-helpers.hpp"
@@ -123,10 +124,10 @@ bool MacroConditionStream::CheckCondition()
 
 	switch (_condition) {
 	case Condition::STOP:
-		match = !obs_frontend_streaming_active();
+		match = !FrontendStreamingActive();
 		break;
 	case Condition::START:
-		match = obs_frontend_streaming_active();
+		match = FrontendStreamingActive();
 		break;
 	case Condition::STARTING:
 		match = streamStarting;
@@ -165,7 +166,7 @@ bool MacroConditionStream::CheckCondition()
 	const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(
 		std::chrono::high_resolution_clock::now() - streamStartTime);
 	const auto streamDurationSeconds =
-		obs_frontend_streaming_active() ? seconds.count() : 0;
+		FrontendStreamingActive() ? seconds.count() : 0;
 	SetTempVarValue("durationSeconds",
 			std::to_string(streamDurationSeconds));
 	SetTempVarValue("serviceName", serviceName);
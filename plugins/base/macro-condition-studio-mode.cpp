@@ -1,9 +1,8 @@
 #include "macro-condition-studio-mode.hpp"
+#include "frontend-state.hpp"
 #include "layout-helpers.hpp"
 #include "source-helpers.hpp"
 
-#include <obs-frontend-api.h>
-
 namespace advss {
 
 const std::string MacroConditionStudioMode::id = "studio_mode";
@@ -28,18 +27,15 @@ bool MacroConditionStudioMode::CheckCondition()
 	bool ret = false;
 	switch (_condition) {
 	case StudioModeCondition::STUDIO_MODE_ACTIVE:
-		ret = obs_frontend_preview_program_mode_active();
+		ret = FrontendStudioModeActive();
 		break;
 	case StudioModeCondition::STUDIO_MODE_NOT_ACTIVE:
-		ret = !obs_frontend_preview_program_mode_active();
+		ret = !FrontendStudioModeActive();
 		break;
 	case StudioModeCondition::PREVIEW_SCENE: {
-		auto s = obs_frontend_get_current_preview_scene();
-		auto scene = obs_source_get_weak_source(s);
+		const auto scene = FrontendPreviewScene();
 		ret = _scene.GetScene() == scene;
 		SetVariableValue(GetWeakSourceName(scene));
-		obs_weak_source_release(scene);
-		obs_source_release(s);
 		break;
 	}
 	default:
@@ -1,4 +1,5 @@
 #include "macro-condition-transition.hpp"
+#include "frontend-state.hpp"
 #include "layout-helpers.hpp"
 #include "scene-switch-helpers.hpp"
 
@@ -31,10 +32,7 @@ const static std::map<MacroConditionTransition::Condition, std::string>
 
 static bool isCurrentTransition(OBSWeakSource &transition)
 {
-	OBSSourceAutoRelease source = obs_frontend_get_current_transition();
-	OBSWeakSourceAutoRelease weakSource =
-		obs_source_get_weak_source(source);
-	return transition == weakSource;
+	return transition == FrontendCurrentTransition();
 }
 
 static bool isTargetScene(OBSWeakSource &targetScene)
@@ -144,7 +142,7 @@ void MacroConditionTransition::TransitionStarted(void *data, calldata_t *cd)
 	OBSSourceAutoRelease startSource = obs_transition_get_source(
 		transitionSource, OBS_TRANSITION_SOURCE_A);
 	OBSSourceAutoRelease endSource =
-		obs_frontend_preview_program_mode_active()
+		FrontendStudioModeActive()
 			? obs_frontend_get_current_scene()
 			: obs_transition_get_source(transitionSource,
 						    OBS_TRANSITION_SOURCE_B);
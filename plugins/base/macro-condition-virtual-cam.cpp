@@ -1,8 +1,7 @@
 #include "macro-condition-virtual-cam.hpp"
+#include "frontend-state.hpp"
 #include "layout-helpers.hpp"
 
-#include <obs-frontend-api.h>
-
 namespace advss {
 
 const std::string MacroConditionVCam::id = "virtual_cam";
@@ -25,10 +24,10 @@ bool MacroConditionVCam::CheckCondition()
 #if LIBOBS_API_VER >= MAKE_SEMANTIC_VERSION(27, 0, 0)
 	switch (_state) {
 	case VCamState::STOP:
-		stateMatch = !obs_frontend_virtualcam_active();
+		stateMatch = !FrontendVirtualCamActive();
 		break;
 	case VCamState::START:
-		stateMatch = obs_frontend_virtualcam_active();
+		stateMatch = FrontendVirtualCamActive();
 		break;
 	default:
 		break;
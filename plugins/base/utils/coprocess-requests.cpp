@@ -0,0 +1,97 @@
+#include "coprocess-requests.hpp"
+
+#include <algorithm>
+
+namespace advss {
+
+constexpr size_t maxErrorOutputSize = 64 * 1024;
+
+CoprocessRequest::CoprocessRequest(
+	const std::string &request,
+	std::optional<std::chrono::milliseconds> timeout)
+	: line(request)
+{
+	for (auto &c : line) {
+		if (c == '\n' || c == '\r') {
+			c = ' ';
+		}
+	}
+	line += '\n';
+	if (timeout) {
+		deadline = std::chrono::steady_clock::now() + *timeout;
+	}
+}
+
+void CoprocessRequests::Add(CoprocessRequest &&request)
+{
+	_requests.emplace_back(std::move(request));
+}
+
+void CoprocessRequests::AppendOutput(const std::string &output)
+{
+	_output += output;
+	size_t lineStart = 0;
+	while (!_requests.empty()) {
+		const auto lineEnd = _output.find('\n', lineStart);
+		if (lineEnd == std::string::npos) {
+			break;
+		}
+		auto line = _output.substr(lineStart, lineEnd - lineStart);
+		lineStart = lineEnd + 1;
+		if (!line.empty() && line.back() == '\r') {
+			line.pop_back();
+		}
+
+		CoprocessResponse response;
+		response.output = std::move(line);
+		response.errorOutput = std::move(_errorOutput);
+		response.processId = _processId;
+		_errorOutput.clear();
+		_requests.front().response.set_value(response);
+		_requests.pop_front();
+	}
+	_output.erase(0, lineStart);
+}
+
+void CoprocessRequests::AppendErrorOutput(const std::string &output)
+{
+	_errorOutput += output;
+	if (_errorOutput.size() > maxErrorOutputSize) {
+		_errorOutput.erase(0, _errorOutput.size() - maxErrorOutputSize);
+	}
+}
+
+std::optional<std::chrono::steady_clock::time_point>
+CoprocessRequests::NextDeadline() const
+{
+	std::optional<std::chrono::steady_clock::time_point> result;
+	for (const auto &request : _requests) {
+		if (request.deadline &&
+		    (!result || *request.deadline < *result)) {
+			result = request.deadline;
+		}
+	}
+	return result;
+}
+
+void CoprocessRequests::Fail(CoprocessError error)
+{
+	RespondToCoprocessRequests(_requests, error, _processId);
+	_output.clear();
+	_errorOutput.clear();
+}
+
+void RespondToCoprocessRequests(std::deque<CoprocessRequest> &requests,
+				CoprocessError error,
+				const std::string &processId)
+{
+	for (auto &request : requests) {
+		CoprocessResponse response;
+		response.error = error;
+		response.processId = processId;
+		request.response.set_value(response);
+	}
+	requests.clear();
+}
+
+} // namespace advss
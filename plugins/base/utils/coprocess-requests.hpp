@@ -0,0 +1,63 @@
+#pragma once
+#include <chrono>
+#include <deque>
+#include <future>
+#include <optional>
+#include <string>
+
+namespace advss {
+
+enum class CoprocessError {
+	NONE,
+	FAILED_TO_START,
+	TIMEOUT,
+	CRASH,
+};
+
+struct CoprocessResponse {
+	CoprocessError error = CoprocessError::NONE;
+	std::string output;
+	// Everything the process wrote to its error stream since the previous
+	// response
+	std::string errorOutput;
+	std::string processId;
+};
+
+struct CoprocessRequest {
+	CoprocessRequest(const std::string &request,
+			 std::optional<std::chrono::milliseconds> timeout);
+
+	// The request as a single line including the line break
+	std::string line;
+	// Requests nobody waits for never time out
+	std::optional<std::chrono::steady_clock::time_point> deadline;
+	std::promise<CoprocessResponse> response;
+};
+
+// Tracks the requests written to a coprocess and answers them in order with
+// the lines the process writes to its output stream.
+class CoprocessRequests {
+public:
+	void Add(CoprocessRequest &&);
+	bool Empty() const { return _requests.empty(); }
+	void AppendOutput(const std::string &output);
+	void AppendErrorOutput(const std::string &output);
+	// Earliest deadline of all requests, which are waited for
+	std::optional<std::chrono::steady_clock::time_point>
+	NextDeadline() const;
+	// Answers all requests with the given error and discards any output
+	// received so far, as it can no longer be assigned to a request
+	void Fail(CoprocessError);
+	void SetProcessId(const std::string &id) { _processId = id; }
+
+private:
+	std::deque<CoprocessRequest> _requests;
+	std::string _output;
+	std::string _errorOutput;
+	std::string _processId;
+};
+
+void RespondToCoprocessRequests(std::deque<CoprocessRequest> &,
+				CoprocessError, const std::string &processId);
+
+} // namespace advss
@@ -0,0 +1,255 @@
+#include "coprocess.hpp"
+#include "log-helper.hpp"
+#include "plugin-state-helpers.hpp"
+
+#include <QProcess>
+
+#include <algorithm>
+#include <vector>
+
+namespace advss {
+
+// Processes which did not receive any requests for this long are stopped to
+// not keep processes around, which are no longer in use
+constexpr std::chrono::minutes idleTimeout{10};
+// Determines how quickly new requests are sent to the process, while still
+// waiting for the responses of earlier requests
+constexpr std::chrono::milliseconds pollInterval{10};
+
+std::mutex Coprocess::_coprocessMutex;
+std::unordered_map<std::string, std::unique_ptr<Coprocess>>
+	Coprocess::_coprocesses;
+bool Coprocess::_setupDone = Coprocess::Setup();
+
+bool Coprocess::Setup()
+{
+	AddPluginCleanupStep([]() {
+		// The worker threads are joined without holding the lock
+		std::unique_lock<std::mutex> lock(_coprocessMutex);
+		auto coprocesses = std::move(_coprocesses);
+		_coprocesses.clear();
+		lock.unlock();
+	});
+	return true;
+}
+
+static std::string getKey(const Coprocess::Config &config)
+{
+	std::string key = config.path;
+	key += '\0';
+	key += config.workingDirectory;
+	for (const auto &arg : config.args) {
+		key += '\0';
+		key += arg.toStdString();
+	}
+	return key;
+}
+
+std::future<Coprocess::Response>
+Coprocess::Send(const Config &config, const std::string &request,
+		std::chrono::milliseconds timeout)
+{
+	return Dispatch(config, request, timeout);
+}
+
+void Coprocess::Post(const Config &config, const std::string &request)
+{
+	(void)Dispatch(config, request, {});
+}
+
+std::future<Coprocess::Response>
+Coprocess::Dispatch(const Config &config, const std::string &request,
+		    std::optional<std::chrono::milliseconds> timeout)
+{
+	CoprocessRequest entry(request, timeout);
+	auto response = entry.response.get_future();
+
+	// Destroying a coprocess joins its worker thread, which must not
+	// block other requests, so this only happens after unlocking
+	std::vector<std::unique_ptr<Coprocess>> exited;
+	std::lock_guard<std::mutex> lock(_coprocessMutex);
+	for (auto it = _coprocesses.begin(); it != _coprocesses.end();) {
+		if (it->second->HasExited()) {
+			exited.emplace_back(std::move(it->second));
+			it = _coprocesses.erase(it);
+		} else {
+			++it;
+		}
+	}
+
+	// The worker might still exit after the check above
+	auto &coprocess = _coprocesses[getKey(config)];
+	if (coprocess && !coprocess->Enqueue(entry)) {
+		exited.emplace_back(std::move(coprocess));
+	}
+	if (!coprocess) {
+		coprocess.reset(new Coprocess(config));
+		coprocess->Enqueue(entry);
+	}
+	return response;
+}
+
+Coprocess::Coprocess(const Config &config) : _config(config)
+{
+	_thread = std::thread(&Coprocess::Run, this);
+}
+
+Coprocess::~Coprocess()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop = true;
+	}
+	_cv.notify_all();
+	if (_thread.joinable()) {
+		_thread.join();
+	}
+}
+
+bool Coprocess::Enqueue(CoprocessRequest &request)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (_exited) {
+		return false;
+	}
+	_requests.emplace_back(std::move(request));
+	_cv.notify_one();
+	return true;
+}
+
+bool Coprocess::HasExited()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _exited;
+}
+
+static std::unique_ptr<QProcess> startProcess(const Coprocess::Config &config)
+{
+	auto process = std::make_unique<QProcess>();
+	process->setWorkingDirectory(
+		QString::fromStdString(config.workingDirectory));
+	process->start(QString::fromStdString(config.path), config.args);
+	if (!process->waitForStarted()) {
+		blog(LOG_WARNING, "failed to start coprocess \"%s\"",
+		     config.path.c_str());
+		return nullptr;
+	}
+	vblog(LOG_INFO, "started coprocess \"%s\"", config.path.c_str());
+	return process;
+}
+
+static void stopProcess(std::unique_ptr<QProcess> &process)
+{
+	if (!process) {
+		return;
+	}
+
+	// Closing the input stream gives the process the chance to exit on
+	// its own
+	process->closeWriteChannel();
+	if (!process->waitForFinished(500)) {
+		process->kill();
+		process->waitForFinished();
+	}
+	process.reset();
+}
+
+void Coprocess::Run()
+{
+	// The process is only ever accessed from this thread
+	std::unique_ptr<QProcess> process;
+	std::string processId;
+	CoprocessRequests inFlight;
+
+	while (true) {
+		std::deque<CoprocessRequest> newRequests;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			if (inFlight.Empty()) {
+				const bool hasWork = _cv.wait_for(
+					lock, idleTimeout, [this]() {
+						return _stop ||
+						       !_requests.empty();
+					});
+				if (!hasWork) {
+					_exited = true;
+					break;
+				}
+			}
+			if (_stop) {
+				RespondToCoprocessRequests(
+					_requests, Error::CRASH, processId);
+				break;
+			}
+			newRequests.swap(_requests);
+		}
+
+		if (process && process->state() != QProcess::Running) {
+			inFlight.Fail(Error::CRASH);
+			process.reset();
+		}
+		if (!newRequests.empty() && !process) {
+			process = startProcess(_config);
+			if (!process) {
+				RespondToCoprocessRequests(
+					newRequests, Error::FAILED_TO_START,
+					"");
+				continue;
+			}
+			processId = QString::number(process->processId())
+					    .toStdString();
+			inFlight.SetProcessId(processId);
+		}
+
+		for (auto &request : newRequests) {
+			process->write(request.line.data(),
+				       request.line.size());
+			inFlight.Add(std::move(request));
+		}
+		if (inFlight.Empty()) {
+			continue;
+		}
+
+		auto waitTime = pollInterval;
+		if (const auto deadline = inFlight.NextDeadline()) {
+			const auto timeLeft = std::chrono::duration_cast<
+				std::chrono::milliseconds>(
+				*deadline - std::chrono::steady_clock::now());
+			waitTime = std::clamp(timeLeft,
+					      std::chrono::milliseconds(0),
+					      pollInterval);
+		}
+		process->waitForReadyRead(waitTime.count());
+
+		// The error output is part of the response to the next request
+		inFlight.AppendErrorOutput(
+			process->readAllStandardError().toStdString());
+		inFlight.AppendOutput(
+			process->readAllStandardOutput().toStdString());
+
+		if (process->state() != QProcess::Running) {
+			vblog(LOG_INFO, "coprocess \"%s\" exited",
+			      _config.path.c_str());
+			inFlight.Fail(Error::CRASH);
+			process.reset();
+			continue;
+		}
+
+		const auto deadline = inFlight.NextDeadline();
+		if (deadline && std::chrono::steady_clock::now() >= *deadline) {
+			vblog(LOG_INFO,
+			      "timeout while waiting for coprocess \"%s\"\n"
+			      "Attempting to restart process!",
+			      _config.path.c_str());
+			// Requests which were already sent to the process can
+			// no longer be answered once it is stopped
+			inFlight.Fail(Error::TIMEOUT);
+			stopProcess(process);
+		}
+	}
+
+	inFlight.Fail(Error::CRASH);
+	stopProcess(process);
+}
+
+} // namespace advss
@@ -0,0 +1,81 @@
+#pragma once
+#include "coprocess-requests.hpp"
+
+#include <QStringList>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace advss {
+
+// A long-lived child process, which receives requests via its standard input
+// stream and answers them via its standard output stream.
+// This avoids having to start a new process for every request.
+//
+// Each request is written as a single line and each line written by the
+// process is treated as the response to the oldest unanswered request.
+// Line breaks within a request are replaced by spaces.
+// Multiple requests can be in flight at the same time, so the process is
+// expected to answer them in the order they were received.
+//
+// If the process exits it is restarted with the next request.
+// If a request, which is waited for, is not answered in time the process is
+// restarted, as the responses would otherwise no longer match the requests.
+class Coprocess {
+public:
+	struct Config {
+		std::string path;
+		QStringList args;
+		std::string workingDirectory;
+	};
+
+	using Error = CoprocessError;
+	using Response = CoprocessResponse;
+
+	// Processes are shared by all requests using the same configuration
+	static std::future<Response> Send(const Config &,
+					  const std::string &request,
+					  std::chrono::milliseconds timeout);
+	// Sends a request nobody waits for, so no timeout applies to it.
+	// The process is still expected to answer it.
+	static void Post(const Config &, const std::string &request);
+
+	~Coprocess();
+
+private:
+	Coprocess(const Config &);
+
+	static std::future<Response>
+	Dispatch(const Config &, const std::string &request,
+		 std::optional<std::chrono::milliseconds> timeout);
+	// Returns false if the worker thread exited after being idle for too
+	// long, in which case the request is left untouched
+	bool Enqueue(CoprocessRequest &);
+	bool HasExited();
+	void Run();
+
+	const Config _config;
+
+	std::mutex _mutex;
+	std::condition_variable _cv;
+	std::deque<CoprocessRequest> _requests;
+	std::thread _thread;
+	bool _stop = false;
+	bool _exited = false;
+
+	static std::mutex _coprocessMutex;
+	static std::unordered_map<std::string, std::unique_ptr<Coprocess>>
+		_coprocesses;
+	static bool _setupDone;
+	static bool Setup();
+};
+
+} // namespace advss
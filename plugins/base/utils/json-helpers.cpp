@@ -1,4 +1,5 @@
 #include "json-helpers.hpp"
+#include "obs-module-helper.hpp"
 
 #include <QJsonDocument>
 
@@ -18,23 +19,210 @@ QString FormatJsonString(QString json)
 	return QString::fromUtf8(doc.toJson(QJsonDocument::Indented));
 }
 
+static std::string formatJsonOrKeepInput(const std::string &json)
+{
+	auto result = FormatJsonString(json).toStdString();
+	if (result.empty()) {
+		return json;
+	}
+	return result;
+}
+
+static bool matchFormattedJson(const std::string &json,
+			       const std::string &formattedPattern,
+			       const RegexConfig &regex)
+{
+	const auto formattedJson = formatJsonOrKeepInput(json);
+	if (regex.Enabled()) {
+		return regex.Matches(formattedJson, formattedPattern);
+	}
+	return formattedJson == formattedPattern;
+}
+
+void PopulateJsonMatchModeSelection(QComboBox *list)
+{
+	list->addItem(obs_module_text("AdvSceneSwitcher.jsonMatchMode.text"),
+		      static_cast<int>(JsonMatcher::Mode::TEXT));
+	list->addItem(obs_module_text("AdvSceneSwitcher.jsonMatchMode.equal"),
+		      static_cast<int>(JsonMatcher::Mode::EQUAL));
+	list->addItem(obs_module_text("AdvSceneSwitcher.jsonMatchMode.subset"),
+		      static_cast<int>(JsonMatcher::Mode::SUBSET));
+	list->setToolTip(
+		obs_module_text("AdvSceneSwitcher.jsonMatchMode.tooltip"));
+}
+
 bool MatchJson(const std::string &json1, const std::string &json2,
 	       const RegexConfig &regex)
 {
-	auto j1 = FormatJsonString(json1).toStdString();
-	auto j2 = FormatJsonString(json2).toStdString();
+	return matchFormattedJson(json1, formatJsonOrKeepInput(json2), regex);
+}
+
+void JsonMatcher::Save(obs_data_t *obj, const char *name) const
+{
+	obs_data_set_int(obj, name, static_cast<int>(_mode));
+}
+
+void JsonMatcher::Load(obs_data_t *obj, const char *name)
+{
+	SetMode(static_cast<Mode>(obs_data_get_int(obj, name)));
+}
+
+void JsonMatcher::SetMode(Mode mode)
+{
+	_mode = mode;
+	_patternIsCached = false;
+	_resultIsCached = false;
+}
+
+bool JsonMatcher::Matches(const std::string &json, const std::string &pattern,
+			  const RegexConfig &regex)
+{
+	if (!_patternIsCached || pattern != _pattern || !(regex == _regex)) {
+		UpdatePattern(pattern, regex);
+	}
 
-	if (j1.empty()) {
-		j1 = json1;
+	const auto hash = std::hash<std::string>{}(json);
+	if (_resultIsCached && hash == _lastInputHash && json == _lastInput) {
+		return _lastResult;
 	}
-	if (j2.empty()) {
-		j2 = json2;
+
+	_lastResult = MatchesHelper(json);
+	_lastInputHash = hash;
+	_lastInput = json;
+	_resultIsCached = true;
+	return _lastResult;
+}
+
+void JsonMatcher::UpdatePattern(const std::string &pattern,
+				const RegexConfig &regex)
+{
+	_pattern = pattern;
+	_regex = regex;
+	_formattedPattern.clear();
+	_parsedPattern.reset();
+
+	if (_mode == Mode::TEXT) {
+		_formattedPattern = formatJsonOrKeepInput(pattern);
+	} else {
+		try {
+			_parsedPattern = nlohmann::json::parse(pattern);
+		} catch (const nlohmann::json::exception &) {
+		}
 	}
 
-	if (regex.Enabled()) {
-		return regex.Matches(j1, j2);
+	_patternIsCached = true;
+	_resultIsCached = false;
+}
+
+static std::optional<nlohmann::json::json_pointer>
+keyToJsonPointer(const std::string &key)
+{
+	try {
+		if (key.rfind("/", 0) == 0) {
+			return nlohmann::json::json_pointer(key);
+		}
+		if (key.rfind("$.", 0) != 0) {
+			return {};
+		}
+
+		// Convert paths like "$.a.b[0]" to "/a/b/0"
+		std::string pointer = "/";
+		for (const char c : key.substr(2)) {
+			switch (c) {
+			case '.':
+			case '[':
+				pointer += '/';
+				break;
+			case ']':
+				break;
+			case '~':
+				pointer += "~0";
+				break;
+			case '/':
+				pointer += "~1";
+				break;
+			default:
+				pointer += c;
+			}
+		}
+		return nlohmann::json::json_pointer(pointer);
+	} catch (const nlohmann::json::exception &) {
+	}
+	return {};
+}
+
+static const nlohmann::json *findValue(const nlohmann::json &json,
+				       const std::string &key)
+{
+	auto it = json.find(key);
+	if (it != json.end()) {
+		return &*it;
+	}
+
+	const auto pointer = keyToJsonPointer(key);
+	if (!pointer) {
+		return nullptr;
+	}
+
+	try {
+		return &json.at(*pointer);
+	} catch (const nlohmann::json::exception &) {
+	}
+	return nullptr;
+}
+
+static bool isSubset(const nlohmann::json &pattern, const nlohmann::json &json,
+		     const RegexConfig &regex)
+{
+	if (pattern.is_string() && regex.Enabled()) {
+		return regex.Matches(json.is_string() ? json.get<std::string>()
+						      : json.dump(),
+				     pattern.get<std::string>());
+	}
+
+	if (!pattern.is_object()) {
+		return pattern == json;
+	}
+
+	if (!json.is_object()) {
+		return false;
+	}
+
+	for (const auto &[key, value] : pattern.items()) {
+		const auto jsonValue = findValue(json, key);
+		if (!jsonValue || !isSubset(value, *jsonValue, regex)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool JsonMatcher::MatchesHelper(const std::string &json) const
+{
+	if (_mode == Mode::TEXT) {
+		return matchFormattedJson(json, _formattedPattern, _regex);
+	}
+
+	if (!_parsedPattern) {
+		return false;
+	}
+
+	nlohmann::json parsedJson;
+	try {
+		parsedJson = nlohmann::json::parse(json);
+	} catch (const nlohmann::json::exception &) {
+		return false;
+	}
+
+	switch (_mode) {
+	case Mode::EQUAL:
+		return parsedJson == *_parsedPattern;
+	case Mode::SUBSET:
+		return isSubset(*_parsedPattern, parsedJson, _regex);
+	default:
+		break;
 	}
-	return j1 == j2;
+	return false;
 }
 
 } // namespace advss
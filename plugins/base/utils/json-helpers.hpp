@@ -1,5 +1,9 @@
 #pragma once
+#include <QComboBox>
 #include <QString>
+#include <nlohmann/json.hpp>
+#include <obs-data.h>
+#include <optional>
 #include <string>
 #include <regex-config.hpp>
 
@@ -10,4 +14,56 @@ QString FormatJsonString(QString);
 bool MatchJson(const std::string &json1, const std::string &json2,
 	       const RegexConfig &regex);
 
+// Matches JSON strings against a pattern, which usually does not change
+// between checks.
+//
+// The normalized representation of the pattern is only calculated again if
+// the pattern changes and the result of the previous check is reused if the
+// same input is checked again.
+class JsonMatcher {
+public:
+	enum class Mode {
+		// Compare the formatted JSON strings or match them using the
+		// regular expression
+		TEXT,
+		// Compare the parsed JSON structures
+		EQUAL,
+		// Every key of the pattern must be present in the input with a
+		// matching value.
+		// Keys starting with "/" are interpreted as JSON pointers and
+		// keys starting with "$." as JSONPath-style paths.
+		// If regular expressions are enabled string values of the
+		// pattern are used as expressions.
+		SUBSET,
+	};
+
+	void Save(obs_data_t *obj, const char *name = "jsonMatchMode") const;
+	void Load(obs_data_t *obj, const char *name = "jsonMatchMode");
+
+	void SetMode(Mode);
+	Mode GetMode() const { return _mode; }
+	bool Matches(const std::string &json, const std::string &pattern,
+		     const RegexConfig &regex);
+
+private:
+	void UpdatePattern(const std::string &pattern,
+			   const RegexConfig &regex);
+	bool MatchesHelper(const std::string &json) const;
+
+	Mode _mode = Mode::TEXT;
+
+	bool _patternIsCached = false;
+	std::string _pattern;
+	RegexConfig _regex;
+	std::string _formattedPattern;
+	std::optional<nlohmann::json> _parsedPattern;
+
+	bool _resultIsCached = false;
+	size_t _lastInputHash = 0;
+	std::string _lastInput;
+	bool _lastResult = false;
+};
+
+void PopulateJsonMatchModeSelection(QComboBox *);
+
 } // namespace advss
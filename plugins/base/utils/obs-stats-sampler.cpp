@@ -0,0 +1,262 @@
+#include "obs-stats-sampler.hpp"
+#include "plugin-state-helpers.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <obs-frontend-api.h>
+#include <obs.hpp>
+#include <util/config-file.h>
+#include <vector>
+
+namespace advss {
+
+bool OBSStatsSampler::_setupDone = OBSStatsSampler::Setup();
+
+bool OBSStatsSampler::Setup()
+{
+	AddPluginCleanupStep([]() { OBSStatsSampler::Instance().Stop(); });
+	return true;
+}
+
+OBSStatsSampler &OBSStatsSampler::Instance()
+{
+	static OBSStatsSampler sampler;
+	return sampler;
+}
+
+OBSStatsSampler::~OBSStatsSampler()
+{
+	Stop();
+}
+
+void OBSStatsSampler::History::Add(double value)
+{
+	_values[_next] = value;
+	_next = (_next + 1) % _values.size();
+	_size = std::min(_size + 1, _values.size());
+}
+
+double OBSStatsSampler::History::Get(size_t age) const
+{
+	return _values[(_next + _values.size() - 1 - age) % _values.size()];
+}
+
+std::optional<double>
+OBSStatsSampler::Query(Stat stat, Aggregation aggregation,
+		       std::chrono::milliseconds window, double percentile)
+{
+	std::vector<double> values;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (_stop) {
+			return {};
+		}
+		if (!_thread.joinable()) {
+			Start();
+		}
+
+		const auto &history = _history[static_cast<size_t>(stat)];
+		if (history.Size() == 0) {
+			return {};
+		}
+		if (aggregation == Aggregation::CURRENT) {
+			return history.Get(0);
+		}
+
+		const size_t count = std::clamp<size_t>(
+			window / sampleInterval, 1, history.Size());
+		values.reserve(count);
+		for (size_t i = 0; i < count; ++i) {
+			values.push_back(history.Get(i));
+		}
+	}
+
+	switch (aggregation) {
+	case Aggregation::AVERAGE:
+		return std::accumulate(values.begin(), values.end(), 0.) /
+		       values.size();
+	case Aggregation::MIN:
+		return *std::min_element(values.begin(), values.end());
+	case Aggregation::MAX:
+		return *std::max_element(values.begin(), values.end());
+	case Aggregation::PERCENTILE: {
+		const double rank = std::clamp(percentile, 0., 100.) / 100. *
+				    (values.size() - 1);
+		auto nth = values.begin() + std::lround(rank);
+		std::nth_element(values.begin(), nth, values.end());
+		return *nth;
+	}
+	default:
+		break;
+	}
+	return values.front();
+}
+
+void OBSStatsSampler::Start()
+{
+	_cpuInfo = os_cpu_usage_info_start();
+
+	// The first sample is taken right away, so there is a value to return
+	// for the first query
+	Store(Sample());
+	_thread = std::thread(&OBSStatsSampler::Run, this);
+}
+
+void OBSStatsSampler::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop = true;
+	}
+	_cv.notify_all();
+	if (_thread.joinable()) {
+		_thread.join();
+	}
+	if (_cpuInfo) {
+		os_cpu_usage_info_destroy(_cpuInfo);
+		_cpuInfo = nullptr;
+	}
+}
+
+void OBSStatsSampler::Run()
+{
+	auto nextSample = std::chrono::steady_clock::now() + sampleInterval;
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (true) {
+		_cv.wait_until(lock, nextSample, [this]() { return _stop; });
+		if (_stop) {
+			return;
+		}
+		nextSample += sampleInterval;
+
+		lock.unlock();
+		const auto values = Sample();
+		lock.lock();
+		Store(values);
+	}
+}
+
+void OBSStatsSampler::Store(const Values &values)
+{
+	for (size_t i = 0; i < values.size(); ++i) {
+		_history[i].Add(values[i]);
+	}
+}
+
+static double getPercentage(uint32_t part, uint32_t total)
+{
+	return total ? static_cast<double>(part) / total * 100. : 0.;
+}
+
+// Based on OBSBasic::GetCurrentOutputPath()
+static const char *getCurrentOutputPath()
+{
+	const char *path = nullptr;
+	auto config = obs_frontend_get_profile_config();
+	if (!config) {
+		return path;
+	}
+
+	const char *mode = config_get_string(config, "Output", "Mode");
+
+	if (strcmp(mode, "Advanced") == 0) {
+		const char *advanced_mode =
+			config_get_string(config, "AdvOut", "RecType");
+
+		if (strcmp(advanced_mode, "FFmpeg") == 0) {
+			path = config_get_string(config, "AdvOut",
+						 "FFFilePath");
+		} else {
+			path = config_get_string(config, "AdvOut",
+						 "RecFilePath");
+		}
+	} else {
+		path = config_get_string(config, "SimpleOutput", "FilePath");
+	}
+
+	return path;
+}
+
+OBSStatsSampler::Values OBSStatsSampler::Sample()
+{
+	Values values{};
+	auto set = [&values](Stat stat, double value) {
+		values[static_cast<size_t>(stat)] = value;
+	};
+
+	set(Stat::FPS, obs_get_active_fps());
+	set(Stat::CPU_USAGE, os_cpu_usage_info_query(_cpuInfo));
+	set(Stat::MEMORY_USAGE,
+	    static_cast<double>(os_get_proc_resident_size()) /
+		    (1024. * 1024.));
+	set(Stat::AVG_FRAMETIME,
+	    static_cast<double>(obs_get_average_frame_time_ns()) / 1000000.);
+	set(Stat::DISK_SPACE_AVAILABLE,
+	    static_cast<double>(os_get_free_disk_space(getCurrentOutputPath()) /
+				(1024ULL * 1024ULL)));
+
+	// Frame lag is reported relative to the point in time sampling
+	// started, or the counters were reset
+	const uint32_t rendered = obs_get_total_frames();
+	const uint32_t lagged = obs_get_lagged_frames();
+	video_t *video = obs_get_video();
+	const uint32_t encoded = video_output_get_total_frames(video);
+	const uint32_t skipped = video_output_get_skipped_frames(video);
+	if (!_frameCountersSet || rendered < _firstRendered ||
+	    lagged < _firstLagged) {
+		_firstRendered = rendered;
+		_firstLagged = lagged;
+	}
+	if (!_frameCountersSet || encoded < _firstEncoded ||
+	    skipped < _firstSkipped) {
+		_firstEncoded = encoded;
+		_firstSkipped = skipped;
+	}
+	_frameCountersSet = true;
+	set(Stat::RENDER_LAG, getPercentage(lagged - _firstLagged,
+					    rendered - _firstRendered));
+	set(Stat::ENCODE_LAG, getPercentage(skipped - _firstSkipped,
+					    encoded - _firstEncoded));
+
+	OBSOutputAutoRelease stream = obs_frontend_get_streaming_output();
+	SampleOutput(stream, _stream, values, Stat::STREAM_DROPPED_FRAMES,
+		     Stat::STREAM_BITRATE, Stat::STREAM_MB_SENT);
+	OBSOutputAutoRelease recording = obs_frontend_get_recording_output();
+	SampleOutput(recording, _recording, values,
+		     Stat::RECORDING_DROPPED_FRAMES, Stat::RECORDING_BITRATE,
+		     Stat::RECORDING_MB_SENT);
+	return values;
+}
+
+void OBSStatsSampler::SampleOutput(obs_output_t *output,
+				   OutputCounters &counters, Values &values,
+				   Stat droppedFrames, Stat bitrate,
+				   Stat megabytesSent)
+{
+	const uint64_t bytesSent =
+		output ? obs_output_get_total_bytes(output) : 0;
+	const uint64_t time = os_gettime_ns();
+	const double seconds =
+		static_cast<double>(time - counters.sampleTime) / 1000000000.;
+
+	double kbps = 0.;
+	if (bytesSent >= counters.bytesSent && counters.sampleTime != 0 &&
+	    seconds >= 0.01) {
+		kbps = static_cast<double>(bytesSent - counters.bytesSent) *
+		       8. / seconds / 1000.;
+	}
+	counters.bytesSent = bytesSent;
+	counters.sampleTime = time;
+
+	const int total = output ? obs_output_get_total_frames(output) : 0;
+	const int dropped = output ? obs_output_get_frames_dropped(output) : 0;
+
+	values[static_cast<size_t>(droppedFrames)] =
+		total > 0 ? static_cast<double>(dropped) / total * 100. : 0.;
+	values[static_cast<size_t>(bitrate)] = kbps;
+	values[static_cast<size_t>(megabytesSent)] =
+		static_cast<double>(bytesSent) / (1024. * 1024.);
+}
+
+} // namespace advss
@@ -0,0 +1,113 @@
+#pragma once
+#include <obs.h>
+#include <util/platform.h>
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace advss {
+
+// Samples the OBS stats at a fixed interval and keeps the recent history of
+// each value, so users do not have to query the stats themselves and the
+// results do not depend on how often they are queried.
+//
+// Sampling only starts once a value is queried for the first time.
+class OBSStatsSampler {
+public:
+	enum class Stat {
+		FPS,
+		CPU_USAGE,
+		DISK_SPACE_AVAILABLE,
+		MEMORY_USAGE,
+		AVG_FRAMETIME,
+		RENDER_LAG,
+		ENCODE_LAG,
+		STREAM_DROPPED_FRAMES,
+		STREAM_BITRATE,
+		STREAM_MB_SENT,
+		RECORDING_DROPPED_FRAMES,
+		RECORDING_BITRATE,
+		RECORDING_MB_SENT,
+		COUNT,
+	};
+
+	enum class Aggregation {
+		CURRENT,
+		AVERAGE,
+		MIN,
+		MAX,
+		PERCENTILE,
+	};
+
+	static constexpr std::chrono::milliseconds sampleInterval{500};
+	static constexpr size_t historySize = 600;
+
+	static OBSStatsSampler &Instance();
+
+	// Combines all samples taken within the given time window.
+	// The percentile is only used for the PERCENTILE aggregation and is
+	// expected to be in the range 0..100.
+	std::optional<double> Query(Stat, Aggregation,
+				    std::chrono::milliseconds window,
+				    double percentile = 50.);
+
+private:
+	OBSStatsSampler() = default;
+	~OBSStatsSampler();
+
+	// Fixed size buffer, which overwrites the oldest sample once it is full
+	class History {
+	public:
+		void Add(double value);
+		size_t Size() const { return _size; }
+		// Returns the sample, which was added "age" samples ago
+		double Get(size_t age) const;
+
+	private:
+		std::array<double, historySize> _values{};
+		size_t _next = 0;
+		size_t _size = 0;
+	};
+
+	using Values = std::array<double, static_cast<size_t>(Stat::COUNT)>;
+
+	struct OutputCounters {
+		uint64_t bytesSent = 0;
+		uint64_t sampleTime = 0;
+	};
+
+	void Start();
+	void Stop();
+	void Run();
+	Values Sample();
+	void SampleOutput(obs_output_t *, OutputCounters &, Values &,
+			  Stat droppedFrames, Stat bitrate,
+			  Stat megabytesSent);
+	void Store(const Values &);
+
+	std::mutex _mutex;
+	std::condition_variable _cv;
+	std::thread _thread;
+	bool _stop = false;
+	std::array<History, static_cast<size_t>(Stat::COUNT)> _history;
+
+	// Only accessed while sampling
+	os_cpu_usage_info_t *_cpuInfo = nullptr;
+	bool _frameCountersSet = false;
+	uint32_t _firstRendered = 0;
+	uint32_t _firstLagged = 0;
+	uint32_t _firstEncoded = 0;
+	uint32_t _firstSkipped = 0;
+	OutputCounters _stream;
+	OutputCounters _recording;
+
+	static bool _setupDone;
+	static bool Setup();
+};
+
+} // namespace advss
@@ -166,6 +166,77 @@ void OSCNull::Save(obs_data_t *obj, const char *name) const
 }
 
 std::optional<std::vector<char>> OSCMessage::GetBuffer() const
+{
+	std::lock_guard<std::mutex> lock(_cache.mutex);
+	if (CachedBufferIsValid()) {
+		return _cache.buffer;
+	}
+
+	// The dependencies are determined first, so changes to the variables
+	// while the message is being encoded are not missed
+	UpdateCacheDependencies();
+	_cache.buffer = CreateBuffer();
+	return _cache.buffer;
+}
+
+static void addVariableDependencies(const StringVariable &value,
+				    VariableDependencies &deps)
+{
+	deps.Add(value.UnresolvedValue());
+}
+
+template<typename T>
+static void addVariableDependencies(const NumberVariable<T> &value,
+				    VariableDependencies &deps)
+{
+	if (!value.IsFixedType()) {
+		deps.Add(value.GetVariable());
+	}
+}
+
+// Types without any variables
+template<typename T>
+static void addVariableDependencies(const T &, VariableDependencies &)
+{
+}
+
+bool OSCMessage::CachedBufferIsValid() const
+{
+	return _cache.buffer && !_cache.dependencies.Changed();
+}
+
+void OSCMessage::UpdateCacheDependencies() const
+{
+	auto &deps = _cache.dependencies;
+	deps.Reset();
+	deps.Add(_address.UnresolvedValue());
+	for (const auto &e : _elements) {
+		if (auto blob = std::get_if<OSCBlob>(&e._value)) {
+			addVariableDependencies(blob->_stringRep, deps);
+			continue;
+		}
+		std::visit(
+			[&deps](auto &&arg) {
+				addVariableDependencies(arg, deps);
+			},
+			e._value);
+	}
+}
+
+OSCMessage::BufferCache &
+OSCMessage::BufferCache::operator=(const BufferCache &)
+{
+	Reset();
+	return *this;
+}
+
+void OSCMessage::BufferCache::Reset()
+{
+	buffer.reset();
+	dependencies.Reset();
+}
+
+std::optional<std::vector<char>> OSCMessage::CreateBuffer() const
 {
 	if (std::string(_address).empty()) {
 		return {};
@@ -208,6 +279,8 @@ std::optional<std::vector<char>> OSCMessage::GetBuffer() const
 
 void OSCMessage::ResolveVariables()
 {
+	std::lock_guard<std::mutex> lock(_cache.mutex);
+	_cache.Reset();
 	_address.ResolveVariables();
 	for (auto &element : _elements) {
 		element.ResolveVariables();
@@ -349,6 +422,8 @@ void OSCMessage::Save(obs_data_t *obj) const
 
 void OSCMessage::Load(obs_data_t *obj)
 {
+	std::lock_guard<std::mutex> lock(_cache.mutex);
+	_cache.Reset();
 
 	auto data = obs_data_get_obj(obj, "oscMessage");
 	_address.Load(data, "address");
@@ -4,7 +4,10 @@
 #include "variable-number.hpp"
 #include "variable-line-edit.hpp"
 #include "variable-spinbox.hpp"
+#include "variable-dependencies.hpp"
 
+#include <chrono>
+#include <mutex>
 #include <variant>
 #include <unordered_map>
 
@@ -23,6 +26,8 @@ public:
 
 private:
 	StringVariable _stringRep;
+
+	friend class OSCMessage;
 };
 
 class OSCTrue {
@@ -97,11 +102,31 @@ public:
 	void ResolveVariables();
 
 private:
+	std::optional<std::vector<char>> CreateBuffer() const;
+	bool CachedBufferIsValid() const;
+	void UpdateCacheDependencies() const;
+
 	StringVariable _address = "/address";
 	std::vector<OSCMessageElement> _elements = {
 		OSCMessageElement("example"),
 		OSCMessageElement(IntVariable(3))};
 
+	// The encoded message is reused as long as none of the variables it
+	// references have changed
+	struct BufferCache {
+		BufferCache() = default;
+		// Copies are usually modified afterwards, so the cached buffer
+		// is not carried over
+		BufferCache(const BufferCache &) {}
+		BufferCache &operator=(const BufferCache &);
+		void Reset();
+
+		std::optional<std::vector<char>> buffer;
+		VariableDependencies dependencies;
+		std::mutex mutex;
+	};
+	mutable BufferCache _cache;
+
 	friend class OSCMessageEdit;
 };
 
@@ -0,0 +1,393 @@
+#include "osc-parser.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+namespace advss {
+
+// Nested bundles are not expected to be used much in practice, so the depth
+// is limited to not be at the mercy of malicious packets
+constexpr int maxBundleDepth = 16;
+constexpr std::string_view bundleTag("#bundle\0", 8);
+
+static size_t align4(size_t value)
+{
+	return (value + 3) & ~static_cast<size_t>(3);
+}
+
+static std::optional<uint32_t> readUInt32(std::string_view data,
+					  size_t &offset)
+{
+	if (offset + 4 > data.size()) {
+		return {};
+	}
+	auto bytes = reinterpret_cast<const unsigned char *>(data.data()) +
+		     offset;
+	offset += 4;
+	return (uint32_t(bytes[0]) << 24) | (uint32_t(bytes[1]) << 16) |
+	       (uint32_t(bytes[2]) << 8) | uint32_t(bytes[3]);
+}
+
+static std::optional<uint64_t> readUInt64(std::string_view data,
+					  size_t &offset)
+{
+	auto high = readUInt32(data, offset);
+	auto low = readUInt32(data, offset);
+	if (!high || !low) {
+		return {};
+	}
+	return (uint64_t(*high) << 32) | *low;
+}
+
+// Reads a null terminated string, which is padded to a multiple of four bytes
+static std::optional<std::string_view> readString(std::string_view data,
+						  size_t &offset)
+{
+	const auto end = data.find('\0', offset);
+	if (offset >= data.size() || end == std::string_view::npos) {
+		return {};
+	}
+	auto result = data.substr(offset, end - offset);
+	// Some implementations omit the padding at the end of the packet
+	offset = std::min(align4(end + 1), data.size());
+	return result;
+}
+
+static std::string toHexString(std::string_view bytes)
+{
+	// Matches the string representation of binary blobs used when sending
+	// OSC messages
+	std::string result;
+	result.reserve(bytes.size() * 4);
+	char hex[5];
+	for (unsigned char byte : bytes) {
+		snprintf(hex, sizeof(hex), "\\x%02x", byte);
+		result += hex;
+	}
+	return result;
+}
+
+static std::string toString(double value)
+{
+	char buffer[32];
+	snprintf(buffer, sizeof(buffer), "%g", value);
+	return buffer;
+}
+
+OSCMessageView::OSCMessageView(std::string_view address,
+			       std::string_view typeTags,
+			       std::string_view arguments)
+	: _address(address),
+	  _typeTags(typeTags),
+	  _arguments(arguments)
+{
+}
+
+std::optional<std::vector<std::string>> OSCMessageView::GetArguments() const
+{
+	std::vector<std::string> result;
+	size_t offset = 0;
+	for (const char tag : _typeTags) {
+		switch (tag) {
+		case 'i': {
+			auto value = readUInt32(_arguments, offset);
+			if (!value) {
+				return {};
+			}
+			result.emplace_back(
+				std::to_string(static_cast<int32_t>(*value)));
+			break;
+		}
+		case 'f': {
+			auto value = readUInt32(_arguments, offset);
+			if (!value) {
+				return {};
+			}
+			float f;
+			memcpy(&f, &*value, sizeof(f));
+			result.emplace_back(toString(f));
+			break;
+		}
+		case 'h':
+		case 't': {
+			auto value = readUInt64(_arguments, offset);
+			if (!value) {
+				return {};
+			}
+			if (tag == 'h') {
+				result.emplace_back(std::to_string(
+					static_cast<int64_t>(*value)));
+			} else {
+				result.emplace_back(std::to_string(*value));
+			}
+			break;
+		}
+		case 'd': {
+			auto value = readUInt64(_arguments, offset);
+			if (!value) {
+				return {};
+			}
+			double d;
+			memcpy(&d, &*value, sizeof(d));
+			result.emplace_back(toString(d));
+			break;
+		}
+		case 's':
+		case 'S': {
+			auto value = readString(_arguments, offset);
+			if (!value) {
+				return {};
+			}
+			result.emplace_back(*value);
+			break;
+		}
+		case 'c': {
+			auto value = readUInt32(_arguments, offset);
+			if (!value) {
+				return {};
+			}
+			result.emplace_back(1, static_cast<char>(*value));
+			break;
+		}
+		case 'r':
+		case 'm': {
+			if (offset + 4 > _arguments.size()) {
+				return {};
+			}
+			result.emplace_back(
+				toHexString(_arguments.substr(offset, 4)));
+			offset += 4;
+			break;
+		}
+		case 'b': {
+			auto size = readUInt32(_arguments, offset);
+			if (!size || offset + *size > _arguments.size()) {
+				return {};
+			}
+			result.emplace_back(
+				toHexString(_arguments.substr(offset, *size)));
+			offset = std::min(align4(offset + *size),
+					  _arguments.size());
+			break;
+		}
+		case 'T':
+			result.emplace_back("true");
+			break;
+		case 'F':
+			result.emplace_back("false");
+			break;
+		case 'N':
+			result.emplace_back("null");
+			break;
+		case 'I':
+			result.emplace_back("infinity");
+			break;
+		case '[':
+		case ']':
+			// Arrays are flattened
+			break;
+		default:
+			return {};
+		}
+	}
+	return result;
+}
+
+static bool parsePacket(std::string_view packet,
+			const std::function<void(const OSCMessageView &)> &cb,
+			int depth)
+{
+	if (packet.empty()) {
+		return false;
+	}
+
+	if (packet[0] == '/') {
+		size_t offset = 0;
+		auto address = readString(packet, offset);
+		if (!address) {
+			return false;
+		}
+
+		std::string_view typeTags;
+		if (offset < packet.size() && packet[offset] == ',') {
+			auto tags = readString(packet, offset);
+			if (!tags) {
+				return false;
+			}
+			typeTags = tags->substr(1);
+		}
+
+		cb(OSCMessageView(*address, typeTags, packet.substr(offset)));
+		return true;
+	}
+
+	if (packet.substr(0, bundleTag.size()) != bundleTag ||
+	    depth >= maxBundleDepth) {
+		return false;
+	}
+
+	// The time tag is ignored, as messages are processed immediately
+	size_t offset = bundleTag.size() + 8;
+	if (offset > packet.size()) {
+		return false;
+	}
+
+	while (offset < packet.size()) {
+		auto size = readUInt32(packet, offset);
+		if (!size || offset + *size > packet.size()) {
+			return false;
+		}
+		if (!parsePacket(packet.substr(offset, *size), cb, depth + 1)) {
+			return false;
+		}
+		offset += *size;
+	}
+	return true;
+}
+
+bool ParseOSCPacket(std::string_view packet,
+		    const std::function<void(const OSCMessageView &)> &cb)
+{
+	return parsePacket(packet, cb, 0);
+}
+
+static void appendUInt32(std::vector<char> &data, uint32_t value)
+{
+	data.push_back(char(value >> 24));
+	data.push_back(char(value >> 16));
+	data.push_back(char(value >> 8));
+	data.push_back(char(value));
+}
+
+std::vector<char>
+CreateOSCBundle(const std::vector<std::vector<char>> &messages)
+{
+	// The special time tag value of 1 means "immediately"
+	constexpr uint64_t timeTag = 1;
+
+	size_t size = bundleTag.size() + sizeof(timeTag);
+	for (const auto &message : messages) {
+		size += 4 + message.size();
+	}
+
+	std::vector<char> bundle;
+	bundle.reserve(size);
+	bundle.insert(bundle.end(), bundleTag.begin(), bundleTag.end());
+	appendUInt32(bundle, uint32_t(timeTag >> 32));
+	appendUInt32(bundle, uint32_t(timeTag));
+	for (const auto &message : messages) {
+		appendUInt32(bundle, uint32_t(message.size()));
+		bundle.insert(bundle.end(), message.begin(), message.end());
+	}
+	return bundle;
+}
+
+static bool matchesCharacterSet(std::string_view set, char c)
+{
+	bool negate = false;
+	if (!set.empty() && set[0] == '!') {
+		negate = true;
+		set.remove_prefix(1);
+	}
+
+	bool found = false;
+	for (size_t i = 0; i < set.size(); ++i) {
+		if (i + 2 < set.size() && set[i + 1] == '-') {
+			found = found || (c >= set[i] && c <= set[i + 2]);
+			i += 2;
+			continue;
+		}
+		found = found || c == set[i];
+	}
+	return found != negate;
+}
+
+bool OSCAddressPartMatches(std::string_view pattern, std::string_view part)
+{
+	while (!pattern.empty()) {
+		switch (pattern[0]) {
+		case '*': {
+			pattern.remove_prefix(1);
+			for (size_t i = 0; i <= part.size(); ++i) {
+				if (OSCAddressPartMatches(pattern,
+							  part.substr(i))) {
+					return true;
+				}
+			}
+			return false;
+		}
+		case '?':
+			if (part.empty()) {
+				return false;
+			}
+			break;
+		case '[': {
+			const auto end = pattern.find(']');
+			if (end == std::string_view::npos || part.empty() ||
+			    !matchesCharacterSet(pattern.substr(1, end - 1),
+						 part[0])) {
+				return false;
+			}
+			pattern.remove_prefix(end + 1);
+			part.remove_prefix(1);
+			continue;
+		}
+		case '{': {
+			const auto end = pattern.find('}');
+			if (end == std::string_view::npos) {
+				return false;
+			}
+			auto alternatives = pattern.substr(1, end - 1);
+			const auto rest = pattern.substr(end + 1);
+			while (true) {
+				const auto separator = alternatives.find(',');
+				const auto alternative =
+					alternatives.substr(0, separator);
+				if (part.substr(0, alternative.size()) ==
+					    alternative &&
+				    OSCAddressPartMatches(
+					    rest,
+					    part.substr(alternative.size()))) {
+					return true;
+				}
+				if (separator == std::string_view::npos) {
+					return false;
+				}
+				alternatives.remove_prefix(separator + 1);
+			}
+		}
+		default:
+			if (part.empty() || part[0] != pattern[0]) {
+				return false;
+			}
+			break;
+		}
+		pattern.remove_prefix(1);
+		part.remove_prefix(1);
+	}
+	return part.empty();
+}
+
+namespace detail {
+
+bool IsOSCPatternPart(std::string_view part)
+{
+	return part.find_first_of("*?[{") != std::string_view::npos;
+}
+
+std::pair<std::string_view, std::string_view>
+SplitOSCAddress(std::string_view address)
+{
+	if (!address.empty() && address[0] == '/') {
+		address.remove_prefix(1);
+	}
+	const auto end = address.find('/');
+	if (end == std::string_view::npos) {
+		return {address, {}};
+	}
+	return {address.substr(0, end), address.substr(end)};
+}
+
+} // namespace detail
+
+} // namespace advss
@@ -0,0 +1,188 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace advss {
+
+// Refers to a single OSC message within a received packet without copying any
+// of its data, so the packet must outlive the view.
+class OSCMessageView {
+public:
+	OSCMessageView(std::string_view address, std::string_view typeTags,
+		       std::string_view arguments);
+	std::string_view Address() const { return _address; }
+	std::string_view TypeTags() const { return _typeTags; }
+	// Converts the arguments to their string representation.
+	// Returns nothing if the message contains unsupported types.
+	std::optional<std::vector<std::string>> GetArguments() const;
+
+private:
+	std::string_view _address;
+	std::string_view _typeTags;
+	std::string_view _arguments;
+};
+
+// Parses the given OSC packet in place and calls the callback for each
+// message it contains including the messages of nested bundles.
+// Returns false if the packet is malformed.
+bool ParseOSCPacket(std::string_view packet,
+		    const std::function<void(const OSCMessageView &)> &);
+
+// Combines the given encoded OSC messages into a bundle, which is to be
+// processed immediately by the receiver
+std::vector<char>
+CreateOSCBundle(const std::vector<std::vector<char>> &messages);
+
+// Matches a single address part against a pattern part using the OSC pattern
+// syntax, which supports "?", "*", "[]" character sets and "{}" alternatives
+bool OSCAddressPartMatches(std::string_view pattern, std::string_view part);
+
+// Stores values for OSC address patterns, which can be looked up quickly using
+// the address of a received message.
+// Literal address parts are looked up directly, so only the parts containing
+// wildcards have to be matched one by one.
+template<class T> class OSCAddressTrie {
+public:
+	void Insert(std::string_view pattern, const T &value);
+	// Removes all values for which the predicate returns true
+	void RemoveIf(const std::function<bool(const T &)> &);
+	void ForEachMatch(std::string_view address,
+			  const std::function<void(const T &)> &) const;
+	bool Empty() const;
+
+private:
+	struct Node {
+		std::map<std::string, Node, std::less<>> literals;
+		std::vector<std::pair<std::string, Node>> patterns;
+		std::vector<T> values;
+
+		bool Empty() const;
+		void RemoveIf(const std::function<bool(const T &)> &);
+		void ForEachMatch(std::string_view address,
+				  const std::function<void(const T &)> &) const;
+	};
+
+	Node _root;
+};
+
+namespace detail {
+
+bool IsOSCPatternPart(std::string_view part);
+// Splits "/a/b" into "a" and "/b"
+std::pair<std::string_view, std::string_view>
+SplitOSCAddress(std::string_view address);
+
+} // namespace detail
+
+template<class T>
+inline void OSCAddressTrie<T>::Insert(std::string_view pattern, const T &value)
+{
+	auto node = &_root;
+	while (!pattern.empty()) {
+		auto [part, rest] = detail::SplitOSCAddress(pattern);
+		pattern = rest;
+		if (!detail::IsOSCPatternPart(part)) {
+			auto it = node->literals.find(part);
+			if (it == node->literals.end()) {
+				it = node->literals
+					     .emplace(std::string(part), Node())
+					     .first;
+			}
+			node = &it->second;
+			continue;
+		}
+
+		auto it = std::find_if(node->patterns.begin(),
+				       node->patterns.end(),
+				       [part](const auto &entry) {
+					       return entry.first == part;
+				       });
+		if (it == node->patterns.end()) {
+			node->patterns.emplace_back(std::string(part), Node());
+			it = std::prev(node->patterns.end());
+		}
+		node = &it->second;
+	}
+	node->values.emplace_back(value);
+}
+
+template<class T>
+inline void
+OSCAddressTrie<T>::RemoveIf(const std::function<bool(const T &)> &predicate)
+{
+	_root.RemoveIf(predicate);
+}
+
+template<class T>
+inline void OSCAddressTrie<T>::ForEachMatch(
+	std::string_view address, const std::function<void(const T &)> &f) const
+{
+	_root.ForEachMatch(address, f);
+}
+
+template<class T> inline bool OSCAddressTrie<T>::Empty() const
+{
+	return _root.Empty();
+}
+
+template<class T> inline bool OSCAddressTrie<T>::Node::Empty() const
+{
+	return values.empty() && literals.empty() && patterns.empty();
+}
+
+template<class T>
+inline void OSCAddressTrie<T>::Node::RemoveIf(
+	const std::function<bool(const T &)> &predicate)
+{
+	values.erase(std::remove_if(values.begin(), values.end(), predicate),
+		     values.end());
+	for (auto it = literals.begin(); it != literals.end();) {
+		it->second.RemoveIf(predicate);
+		if (it->second.Empty()) {
+			it = literals.erase(it);
+		} else {
+			++it;
+		}
+	}
+	for (auto &[_, node] : patterns) {
+		node.RemoveIf(predicate);
+	}
+	patterns.erase(std::remove_if(patterns.begin(), patterns.end(),
+				      [](const auto &entry) {
+					      return entry.second.Empty();
+				      }),
+		       patterns.end());
+}
+
+template<class T>
+inline void OSCAddressTrie<T>::Node::ForEachMatch(
+	std::string_view address, const std::function<void(const T &)> &f) const
+{
+	if (address.empty()) {
+		for (const auto &value : values) {
+			f(value);
+		}
+		return;
+	}
+
+	auto [part, rest] = detail::SplitOSCAddress(address);
+	auto it = literals.find(part);
+	if (it != literals.end()) {
+		it->second.ForEachMatch(rest, f);
+	}
+	for (const auto &[pattern, node] : patterns) {
+		if (OSCAddressPartMatches(pattern, part)) {
+			node.ForEachMatch(rest, f);
+		}
+	}
+}
+
+} // namespace advss
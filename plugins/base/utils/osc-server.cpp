@@ -0,0 +1,444 @@
+#include "osc-server.hpp"
+#include "log-helper.hpp"
+#include "network-runtime.hpp"
+#include "plugin-state-helpers.hpp"
+
+#include <algorithm>
+#include <array>
+#include <asio.hpp>
+#include <chrono>
+#include <optional>
+#include <set>
+
+namespace advss {
+
+// Large enough for any UDP datagram
+constexpr size_t udpBufferSize = 65536;
+// Protects against allocating huge buffers due to garbage being received
+constexpr uint32_t maxTCPPacketSize = 1024 * 1024;
+// Bursts of messages should not cause the macro conditions to be checked
+// over and over again, so waking up the main loop is rate limited
+constexpr std::chrono::milliseconds minWakeInterval(10);
+// The port might still be in use by a server, which is being stopped, or by
+// another application
+constexpr std::chrono::seconds listenRetryDelay(2);
+
+using WeakMessageBuffer = std::weak_ptr<MessageBuffer<OSCReceivedMessage>>;
+
+std::mutex OSCServer::_serverMutex;
+std::vector<std::weak_ptr<OSCServer>> OSCServer::_servers;
+
+// All socket operations are performed on the listener's strand, as the sockets
+// are shared between the network threads and the thread stopping the server
+class OSCServer::Listener : public std::enable_shared_from_this<Listener> {
+public:
+	Listener(Protocol, int port);
+	void Start();
+	void Stop();
+	OSCMessageBuffer Subscribe(const std::string &pattern);
+	std::string GetError() const;
+
+private:
+	struct TCPConnection {
+		TCPConnection(asio::io_context &context) : socket(context) {}
+		asio::ip::tcp::socket socket;
+		std::array<unsigned char, 4> header;
+		std::string packet;
+	};
+
+	void Listen();
+	void ListenFailed(const std::string &error);
+	void ListenSucceeded();
+	bool StartUDP();
+	void ReceiveUDP();
+	bool StartTCP();
+	void AcceptTCP();
+	void ReadTCPHeader(const std::shared_ptr<TCPConnection> &);
+	void ReadTCPPacket(const std::shared_ptr<TCPConnection> &);
+	void CloseTCPConnection(const std::shared_ptr<TCPConnection> &);
+	void Dispatch(std::string_view packet);
+	void WakeMacroEngine();
+	void ScheduleWake(std::chrono::steady_clock::time_point);
+
+	const Protocol _protocol;
+	const int _port;
+
+	asio::strand<asio::io_context::executor_type> _strand;
+	asio::ip::udp::socket _udpSocket;
+	asio::ip::udp::endpoint _udpSender;
+	std::vector<char> _udpBuffer;
+	asio::ip::tcp::acceptor _acceptor;
+	std::set<std::shared_ptr<TCPConnection>> _tcpConnections;
+	asio::steady_timer _wakeTimer;
+	std::chrono::steady_clock::time_point _lastWake{};
+	bool _wakeScheduled = false;
+	asio::steady_timer _retryTimer;
+	bool _stopped = false;
+
+	mutable std::mutex _errorMutex;
+	std::string _error;
+
+	std::mutex _subscriberMutex;
+	OSCAddressTrie<WeakMessageBuffer> _subscribers;
+};
+
+OSCServer::Listener::Listener(Protocol protocol, int port)
+	: _protocol(protocol),
+	  _port(port),
+	  _strand(asio::make_strand(NetworkRuntime::Instance().Context())),
+	  _udpSocket(_strand),
+	  _acceptor(_strand),
+	  _wakeTimer(_strand),
+	  _retryTimer(_strand)
+{
+}
+
+static const char *protocolName(OSCServer::Protocol protocol)
+{
+	return protocol == OSCServer::Protocol::UDP ? "UDP" : "TCP";
+}
+
+void OSCServer::Listener::Start()
+{
+	asio::post(_strand, [self = shared_from_this()]() { self->Listen(); });
+}
+
+void OSCServer::Listener::Stop()
+{
+	asio::post(_strand, [self = shared_from_this()]() {
+		self->_stopped = true;
+		self->_retryTimer.cancel();
+		asio::error_code ec;
+		self->_udpSocket.close(ec);
+		self->_acceptor.close(ec);
+		for (const auto &connection : self->_tcpConnections) {
+			connection->socket.close(ec);
+		}
+		self->_tcpConnections.clear();
+		self->_wakeTimer.cancel();
+	});
+}
+
+OSCMessageBuffer OSCServer::Listener::Subscribe(const std::string &pattern)
+{
+	std::lock_guard<std::mutex> lock(_subscriberMutex);
+	_subscribers.RemoveIf(
+		[](const WeakMessageBuffer &ptr) { return ptr.expired(); });
+	auto buffer = std::make_shared<MessageBuffer<OSCReceivedMessage>>();
+	_subscribers.Insert(pattern, buffer);
+	return buffer;
+}
+
+std::string OSCServer::Listener::GetError() const
+{
+	std::lock_guard<std::mutex> lock(_errorMutex);
+	return _error;
+}
+
+void OSCServer::Listener::Listen()
+{
+	if (_stopped) {
+		return;
+	}
+	const bool listening = _protocol == Protocol::UDP ? StartUDP()
+							  : StartTCP();
+	if (listening) {
+		ListenSucceeded();
+	}
+}
+
+void OSCServer::Listener::ListenFailed(const std::string &error)
+{
+	{
+		std::lock_guard<std::mutex> lock(_errorMutex);
+		// Only log the first of the repeated attempts
+		if (error != _error) {
+			blog(LOG_WARNING,
+			     "failed to listen for OSC on %s port %d: %s",
+			     protocolName(_protocol), _port, error.c_str());
+		}
+		_error = error;
+	}
+
+	_retryTimer.expires_after(listenRetryDelay);
+	_retryTimer.async_wait(
+		[self = shared_from_this()](const asio::error_code &ec) {
+			if (!ec) {
+				self->Listen();
+			}
+		});
+}
+
+void OSCServer::Listener::ListenSucceeded()
+{
+	blog(LOG_INFO, "listening for OSC messages on %s port %d",
+	     protocolName(_protocol), _port);
+	std::lock_guard<std::mutex> lock(_errorMutex);
+	_error.clear();
+}
+
+bool OSCServer::Listener::StartUDP()
+{
+	try {
+		_udpSocket.open(asio::ip::udp::v4());
+		_udpSocket.set_option(asio::socket_base::reuse_address(true));
+		_udpSocket.bind(asio::ip::udp::endpoint(asio::ip::udp::v4(),
+							_port));
+	} catch (const std::exception &e) {
+		asio::error_code ec;
+		_udpSocket.close(ec);
+		ListenFailed(e.what());
+		return false;
+	}
+	_udpBuffer.resize(udpBufferSize);
+	ReceiveUDP();
+	return true;
+}
+
+void OSCServer::Listener::ReceiveUDP()
+{
+	if (!_udpSocket.is_open()) {
+		return;
+	}
+	_udpSocket.async_receive_from(
+		asio::buffer(_udpBuffer), _udpSender,
+		[self = shared_from_this()](const asio::error_code &ec,
+					    size_t size) {
+			if (ec == asio::error::operation_aborted) {
+				return;
+			}
+			if (!ec) {
+				self->Dispatch(std::string_view(
+					self->_udpBuffer.data(), size));
+			}
+			self->ReceiveUDP();
+		});
+}
+
+bool OSCServer::Listener::StartTCP()
+{
+	try {
+		asio::ip::tcp::endpoint endpoint(asio::ip::tcp::v4(), _port);
+		_acceptor.open(endpoint.protocol());
+		_acceptor.set_option(asio::socket_base::reuse_address(true));
+		_acceptor.bind(endpoint);
+		_acceptor.listen();
+	} catch (const std::exception &e) {
+		asio::error_code ec;
+		_acceptor.close(ec);
+		ListenFailed(e.what());
+		return false;
+	}
+	AcceptTCP();
+	return true;
+}
+
+void OSCServer::Listener::AcceptTCP()
+{
+	auto connection = std::make_shared<TCPConnection>(
+		NetworkRuntime::Instance().Context());
+	_acceptor.async_accept(
+		connection->socket,
+		asio::bind_executor(_strand, [self = shared_from_this(),
+					      connection](const auto &ec) {
+			if (ec == asio::error::operation_aborted) {
+				return;
+			}
+			if (!ec) {
+				self->_tcpConnections.insert(connection);
+				self->ReadTCPHeader(connection);
+			}
+			self->AcceptTCP();
+		}));
+}
+
+void OSCServer::Listener::ReadTCPHeader(
+	const std::shared_ptr<TCPConnection> &connection)
+{
+	asio::async_read(
+		connection->socket, asio::buffer(connection->header),
+		asio::bind_executor(_strand, [self = shared_from_this(),
+					      connection](
+						     const asio::error_code &ec,
+						     size_t) {
+			if (ec) {
+				self->CloseTCPConnection(connection);
+				return;
+			}
+			self->ReadTCPPacket(connection);
+		}));
+}
+
+void OSCServer::Listener::ReadTCPPacket(
+	const std::shared_ptr<TCPConnection> &connection)
+{
+	const auto &header = connection->header;
+	const uint32_t size = (uint32_t(header[0]) << 24) |
+			      (uint32_t(header[1]) << 16) |
+			      (uint32_t(header[2]) << 8) | uint32_t(header[3]);
+	if (size > maxTCPPacketSize) {
+		blog(LOG_WARNING,
+		     "closing OSC connection on TCP port %d: "
+		     "packet size %u exceeds limit",
+		     _port, size);
+		CloseTCPConnection(connection);
+		return;
+	}
+
+	connection->packet.resize(size);
+	asio::async_read(
+		connection->socket, asio::buffer(connection->packet),
+		asio::bind_executor(_strand, [self = shared_from_this(),
+					      connection](
+						     const asio::error_code &ec,
+						     size_t) {
+			if (ec) {
+				self->CloseTCPConnection(connection);
+				return;
+			}
+			self->Dispatch(connection->packet);
+			self->ReadTCPHeader(connection);
+		}));
+}
+
+void OSCServer::Listener::CloseTCPConnection(
+	const std::shared_ptr<TCPConnection> &connection)
+{
+	asio::error_code ec;
+	connection->socket.close(ec);
+	_tcpConnections.erase(connection);
+}
+
+static OSCReceivedMessage toReceivedMessage(const OSCMessageView &msg)
+{
+	std::string address(msg.Address());
+	auto arguments = msg.GetArguments();
+	if (!arguments) {
+		vblog(LOG_INFO,
+		      "OSC message \"%s\" contains unsupported argument types",
+		      address.c_str());
+		return {address, {}};
+	}
+	return {address, *arguments};
+}
+
+void OSCServer::Listener::Dispatch(std::string_view packet)
+{
+	bool dispatched = false;
+	auto forwardMessage = [this, &dispatched](const OSCMessageView &msg) {
+		// The message is only copied once it is known that there is
+		// a subscriber interested in it
+		std::optional<OSCReceivedMessage> message;
+		auto forward = [&](const WeakMessageBuffer &weakBuffer) {
+			auto buffer = weakBuffer.lock();
+			if (!buffer) {
+				return;
+			}
+			if (!message) {
+				message = toReceivedMessage(msg);
+			}
+			buffer->AppendMessage(*message);
+			dispatched = true;
+		};
+		std::lock_guard<std::mutex> lock(_subscriberMutex);
+		_subscribers.ForEachMatch(msg.Address(), forward);
+	};
+
+	if (!ParseOSCPacket(packet, forwardMessage)) {
+		vblog(LOG_INFO, "received malformed OSC packet on %s port %d",
+		      protocolName(_protocol), _port);
+	}
+	if (dispatched) {
+		WakeMacroEngine();
+	}
+}
+
+void OSCServer::Listener::WakeMacroEngine()
+{
+	if (_wakeScheduled) {
+		return;
+	}
+
+	const auto now = std::chrono::steady_clock::now();
+	const auto nextWake = _lastWake + minWakeInterval;
+	if (now < nextWake) {
+		ScheduleWake(nextWake);
+		return;
+	}
+
+	_lastWake = now;
+	if (!RequestMacroCheck()) {
+		ScheduleWake(now + minWakeInterval);
+	}
+}
+
+void OSCServer::Listener::ScheduleWake(
+	std::chrono::steady_clock::time_point time)
+{
+	_wakeScheduled = true;
+	_wakeTimer.expires_at(time);
+	_wakeTimer.async_wait(
+		[self = shared_from_this()](const asio::error_code &ec) {
+			self->_wakeScheduled = false;
+			if (ec) {
+				return;
+			}
+			self->WakeMacroEngine();
+		});
+}
+
+std::shared_ptr<OSCServer> OSCServer::Find(Protocol protocol, int port)
+{
+	for (const auto &weakServer : _servers) {
+		auto server = weakServer.lock();
+		if (server && server->_protocol == protocol &&
+		    server->_port == port) {
+			return server;
+		}
+	}
+	return {};
+}
+
+std::shared_ptr<OSCServer> OSCServer::Get(Protocol protocol, int port)
+{
+	std::lock_guard<std::mutex> lock(_serverMutex);
+	_servers.erase(std::remove_if(_servers.begin(), _servers.end(),
+				      [](const std::weak_ptr<OSCServer> &ptr) {
+					      return ptr.expired();
+				      }),
+		       _servers.end());
+	if (auto server = Find(protocol, port)) {
+		return server;
+	}
+
+	auto server = std::shared_ptr<OSCServer>(new OSCServer(protocol, port));
+	_servers.emplace_back(server);
+	return server;
+}
+
+std::string OSCServer::GetError(Protocol protocol, int port)
+{
+	std::lock_guard<std::mutex> lock(_serverMutex);
+	auto server = Find(protocol, port);
+	return server ? server->_listener->GetError() : "";
+}
+
+OSCServer::OSCServer(Protocol protocol, int port)
+	: _protocol(protocol),
+	  _port(port),
+	  _listener(std::make_shared<Listener>(protocol, port))
+{
+	_listener->Start();
+}
+
+OSCServer::~OSCServer()
+{
+	_listener->Stop();
+}
+
+OSCMessageBuffer OSCServer::Subscribe(const std::string &pattern)
+{
+	return _listener->Subscribe(pattern);
+}
+
+} // namespace advss
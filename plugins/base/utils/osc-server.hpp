@@ -0,0 +1,63 @@
+#pragma once
+#include "message-buffer.hpp"
+#include "osc-parser.hpp"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace advss {
+
+struct OSCReceivedMessage {
+	std::string address;
+	std::vector<std::string> arguments;
+};
+
+using OSCMessageBuffer = std::shared_ptr<MessageBuffer<OSCReceivedMessage>>;
+
+// Listens for OSC packets on a given port and forwards the contained messages
+// to the subscribers, whose address pattern matches the message address.
+//
+// Packets are parsed directly from the receive buffer and the messages are
+// only copied for the subscribers interested in them.
+// The main loop is woken up as soon as a message was forwarded, so conditions
+// do not have to wait for the end of the current interval.
+//
+// TCP packets are expected to be prefixed with their size as a 32-bit big
+// endian integer, as described in the OSC 1.0 specification.
+//
+// If the port cannot be bound, the attempt is repeated periodically until the
+// server is stopped.
+class OSCServer {
+public:
+	enum class Protocol {
+		TCP,
+		UDP,
+	};
+
+	// Servers are shared by all users of the same protocol and port and are
+	// stopped once the last user releases its reference
+	static std::shared_ptr<OSCServer> Get(Protocol, int port);
+	// Returns the reason why the server for the given protocol and port is
+	// currently not listening or an empty string otherwise
+	static std::string GetError(Protocol, int port);
+	~OSCServer();
+
+	[[nodiscard]] OSCMessageBuffer Subscribe(const std::string &pattern);
+
+private:
+	OSCServer(Protocol, int port);
+	static std::shared_ptr<OSCServer> Find(Protocol, int port);
+
+	class Listener;
+
+	const Protocol _protocol;
+	const int _port;
+	std::shared_ptr<Listener> _listener;
+
+	static std::mutex _serverMutex;
+	static std::vector<std::weak_ptr<OSCServer>> _servers;
+};
+
+} // namespace advss
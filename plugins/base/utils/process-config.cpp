@@ -13,6 +13,8 @@ bool ProcessConfig::Save(obs_data_t *obj) const
 	_path.Save(data, "path");
 	_workingDirectory.Save(data, "workingDirectory");
 	_args.Save(data, "args", "arg");
+	obs_data_set_bool(data, "coprocess", _coprocess);
+	_coprocessInput.Save(data, "coprocessInput");
 	obs_data_set_obj(obj, "processConfig", data);
 	obs_data_release(data);
 
@@ -35,6 +37,8 @@ bool ProcessConfig::Load(obs_data_t *obj)
 	_path.Load(data, "path");
 	_workingDirectory.Load(data, "workingDirectory");
 	_args.Load(data, "args", "arg");
+	_coprocess = obs_data_get_bool(data, "coprocess");
+	_coprocessInput.Load(data, "coprocessInput");
 	obs_data_release(data);
 
 	return true;
@@ -61,6 +65,7 @@ void ProcessConfig::ResolveVariables()
 	_path.ResolveVariables();
 	_workingDirectory.ResolveVariables();
 	_args.ResolveVariables();
+	_coprocessInput.ResolveVariables();
 }
 
 std::variant<int, ProcessConfig::ProcStartError>
@@ -68,6 +73,10 @@ ProcessConfig::StartProcessAndWait(int timeout)
 {
 	ResetFinishedProcessData();
 
+	if (_coprocess) {
+		return SetCoprocessResponse(SendToCoprocess(timeout).get());
+	}
+
 	QProcess process;
 	process.setWorkingDirectory(QString::fromStdString(WorkingDir()));
 	process.start(QString::fromStdString(Path()), Args());
@@ -102,6 +111,46 @@ ProcessConfig::StartProcessAndWait(int timeout)
 	return ProcStartError::CRASH;
 }
 
+std::future<Coprocess::Response>
+ProcessConfig::SendToCoprocess(int timeoutInMs) const
+{
+	vblog(LOG_INFO, "send \"%s\" to coprocess \"%s\"",
+	      std::string(_coprocessInput).c_str(), Path().c_str());
+	return Coprocess::Send({Path(), Args(), WorkingDir()}, _coprocessInput,
+			       std::chrono::milliseconds(timeoutInMs));
+}
+
+void ProcessConfig::PostToCoprocess() const
+{
+	vblog(LOG_INFO, "post \"%s\" to coprocess \"%s\"",
+	      std::string(_coprocessInput).c_str(), Path().c_str());
+	Coprocess::Post({Path(), Args(), WorkingDir()}, _coprocessInput);
+}
+
+std::variant<int, ProcessConfig::ProcStartError>
+ProcessConfig::SetCoprocessResponse(const Coprocess::Response &response)
+{
+	// There is no exit code as the process keeps running
+	_processExitCode = "";
+	_processId = response.processId;
+	_processOutputStream = response.output;
+	_processErrorStream = response.errorOutput;
+
+	switch (response.error) {
+	case Coprocess::Error::NONE:
+		return 0;
+	case Coprocess::Error::FAILED_TO_START:
+		return ProcStartError::FAILED_TO_START;
+	case Coprocess::Error::TIMEOUT:
+		return ProcStartError::TIMEOUT;
+	case Coprocess::Error::CRASH:
+		return ProcStartError::CRASH;
+	default:
+		break;
+	}
+	return ProcStartError::CRASH;
+}
+
 void ProcessConfig::SetFinishedProcessData(QProcess &process)
 {
 	static const QRegularExpression regex("(\\r\\n|\\r|\\n)$");
@@ -133,8 +182,15 @@ ProcessConfigEdit::ProcessConfigEdit(QWidget *parent)
 		  obs_module_text(
 			  "AdvSceneSwitcher.process.addArgumentDescription"),
 		  4096, true)),
-	  _workingDirectory(new FileSelection(FileSelection::Type::FOLDER))
+	  _workingDirectory(new FileSelection(FileSelection::Type::FOLDER)),
+	  _coprocess(new QCheckBox(
+		  obs_module_text("AdvSceneSwitcher.process.coprocess"))),
+	  _coprocessInputLayout(new QHBoxLayout()),
+	  _coprocessInput(new VariableLineEdit(this))
 {
+	_coprocess->setToolTip(
+		obs_module_text("AdvSceneSwitcher.process.coprocess.tooltip"));
+
 	_advancedSettingsLayout->setContentsMargins(0, 0, 0, 0);
 
 	QWidget::connect(_filePath, SIGNAL(PathChanged(const QString &)), this,
@@ -147,12 +203,17 @@ ProcessConfigEdit::ProcessConfigEdit(QWidget *parent)
 	QWidget::connect(_workingDirectory,
 			 SIGNAL(PathChanged(const QString &)), this,
 			 SLOT(WorkingDirectoryChanged(const QString &)));
+	QWidget::connect(_coprocess, SIGNAL(stateChanged(int)), this,
+			 SLOT(CoprocessChanged(int)));
+	QWidget::connect(_coprocessInput, SIGNAL(editingFinished()), this,
+			 SLOT(CoprocessInputChanged()));
 
 	auto *entryLayout = new QHBoxLayout;
 	std::unordered_map<std::string, QWidget *> widgetPlaceholders = {
 		{"{{filePath}}", _filePath},
 		{"{{workingDirectory}}", _workingDirectory},
 		{"{{advancedSettings}}", _showAdvancedSettings},
+		{"{{coprocessInput}}", _coprocessInput},
 	};
 	PlaceWidgets(obs_module_text("AdvSceneSwitcher.process.entry"),
 		     entryLayout, widgetPlaceholders, false);
@@ -166,6 +227,11 @@ ProcessConfigEdit::ProcessConfigEdit(QWidget *parent)
 		obs_module_text("AdvSceneSwitcher.process.arguments")));
 	_advancedSettingsLayout->addWidget(_argList);
 	_advancedSettingsLayout->addLayout(workingDirectoryLayout);
+	PlaceWidgets(obs_module_text(
+			     "AdvSceneSwitcher.process.entry.coprocessInput"),
+		     _coprocessInputLayout, widgetPlaceholders, false);
+	_advancedSettingsLayout->addWidget(_coprocess);
+	_advancedSettingsLayout->addLayout(_coprocessInputLayout);
 
 	auto mainLayout = new QVBoxLayout;
 	mainLayout->setContentsMargins(0, 0, 0, 0);
@@ -182,9 +248,12 @@ void ProcessConfigEdit::SetProcessConfig(const ProcessConfig &conf)
 	_filePath->SetPath(conf._path);
 	_argList->SetStringList(conf._args);
 	_workingDirectory->SetPath(conf._workingDirectory);
+	_coprocess->setChecked(conf._coprocess);
+	_coprocessInput->setText(conf._coprocessInput);
 	ShowAdvancedSettings(
 		!_conf._args.empty() ||
-		!_conf._workingDirectory.UnresolvedValue().empty());
+		!_conf._workingDirectory.UnresolvedValue().empty() ||
+		_conf._coprocess);
 }
 
 void ProcessConfigEdit::PathChanged(const QString &text)
@@ -213,9 +282,26 @@ void ProcessConfigEdit::ArgsChanged(const StringList &args)
 	emit ConfigChanged(_conf);
 }
 
+void ProcessConfigEdit::CoprocessChanged(int value)
+{
+	_conf._coprocess = value;
+	SetLayoutVisible(_coprocessInputLayout, value);
+	adjustSize();
+	updateGeometry();
+	emit ConfigChanged(_conf);
+}
+
+void ProcessConfigEdit::CoprocessInputChanged()
+{
+	_conf._coprocessInput = _coprocessInput->text().toStdString();
+	emit ConfigChanged(_conf);
+}
+
 void ProcessConfigEdit::ShowAdvancedSettings(bool showAdvancedSettings)
 {
 	SetLayoutVisible(_advancedSettingsLayout, showAdvancedSettings);
+	SetLayoutVisible(_coprocessInputLayout,
+			 showAdvancedSettings && _conf._coprocess);
 	_showAdvancedSettings->setVisible(!showAdvancedSettings);
 	adjustSize();
 	updateGeometry();
@@ -1,10 +1,13 @@
 #pragma once
+#include "coprocess.hpp"
 #include "file-selection.hpp"
 #include "string-list.hpp"
+#include "variable-line-edit.hpp"
 
 #include <obs-data.h>
 #include <obs-module-helper.hpp>
 
+#include <QCheckBox>
 #include <QListWidget>
 #include <QProcess>
 #include <QPushButton>
@@ -23,6 +26,7 @@ public:
 	std::string UnresolvedPath() const { return _path.UnresolvedValue(); }
 	std::string WorkingDir() const { return _workingDirectory; }
 	QStringList Args() const; // Resolves variables
+	bool IsCoprocess() const { return _coprocess; }
 
 	void SetProcessId(std::string processId) { _processId = processId; }
 	std::string GetProcessId() const { return _processId; }
@@ -45,8 +49,14 @@ public:
 		CRASH,
 	};
 
+	// When using the coprocess mode the process is kept running and the
+	// input is sent to it as a request instead of starting a new process
 	std::variant<int, ProcStartError> StartProcessAndWait(int timeoutInMs);
 	bool StartProcessDetached() const;
+	std::future<Coprocess::Response> SendToCoprocess(int timeoutInMs) const;
+	void PostToCoprocess() const;
+	std::variant<int, ProcStartError>
+	SetCoprocessResponse(const Coprocess::Response &);
 
 	void ResolveVariables();
 
@@ -54,6 +64,8 @@ private:
 	StringVariable _path = obs_module_text("AdvSceneSwitcher.enterPath");
 	StringVariable _workingDirectory = "";
 	StringList _args;
+	bool _coprocess = false;
+	StringVariable _coprocessInput = "";
 
 	std::string _processId;
 	std::string _processExitCode;
@@ -75,6 +87,8 @@ private slots:
 	void ShowAdvancedSettingsClicked();
 	void WorkingDirectoryChanged(const QString &);
 	void ArgsChanged(const StringList &);
+	void CoprocessChanged(int);
+	void CoprocessInputChanged();
 signals:
 	void ConfigChanged(const ProcessConfig &);
 	void AdvancedSettingsEnabled();
@@ -89,6 +103,9 @@ private:
 	QVBoxLayout *_advancedSettingsLayout;
 	StringListEdit *_argList;
 	FileSelection *_workingDirectory;
+	QCheckBox *_coprocess;
+	QHBoxLayout *_coprocessInputLayout;
+	VariableLineEdit *_coprocessInput;
 };
 
 } // namespace advss
@@ -0,0 +1,243 @@
+#include "source-settings-watcher.hpp"
+#include "plugin-state-helpers.hpp"
+#include "source-settings-helpers.hpp"
+
+#include <nlohmann/json.hpp>
+
+namespace advss {
+
+bool SourceSettingsWatcher::_setupDone = SourceSettingsWatcher::Setup();
+
+bool SourceSettingsWatcher::Setup()
+{
+	AddPluginInitStep(
+		[]() { SourceSettingsWatcher::Instance().Connect(); });
+	AddPluginCleanupStep(
+		[]() { SourceSettingsWatcher::Instance().Disconnect(); });
+	return true;
+}
+
+SourceSettingsWatcher &SourceSettingsWatcher::Instance()
+{
+	static SourceSettingsWatcher watcher;
+	return watcher;
+}
+
+void SourceSettingsWatcher::Connect()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_destroySignal.Connect(obs_get_signal_handler(), "source_destroy",
+			       SourceDestroyed, this);
+	_connected = true;
+}
+
+void SourceSettingsWatcher::Disconnect()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_connected = false;
+	_entries.clear();
+	_destroySignal.Disconnect();
+}
+
+SourceSettingsWatcher::Entry *
+SourceSettingsWatcher::GetEntry(const OBSWeakSource &weakSource,
+				obs_source_t *source)
+{
+	if (!_connected) {
+		return nullptr;
+	}
+
+	auto it = _entries.find(weakSource.Get());
+	if (it != _entries.end()) {
+		return it->second.get();
+	}
+
+	auto entry = std::make_unique<Entry>();
+	entry->key = weakSource.Get();
+	entry->updateSignal.Connect(obs_source_get_signal_handler(source),
+				    "update", SourceUpdated, entry.get());
+	auto result = entry.get();
+	_entries.emplace(entry->key, std::move(entry));
+	return result;
+}
+
+// The strong references to the sources are acquired and released without
+// holding the lock, as releasing the last reference of a source will emit the
+// "source_destroy" signal, which is handled by SourceDestroyed() on the same
+// thread.
+// Holding a strong reference also guarantees the source cannot be destroyed
+// while its "update" signal is being connected.
+
+uint64_t SourceSettingsWatcher::GetVersion(const OBSWeakSource &weakSource)
+{
+	OBSSourceAutoRelease source = obs_weak_source_get_source(weakSource);
+	if (!source) {
+		return 0;
+	}
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto entry = GetEntry(weakSource, source);
+	if (!entry) {
+		return 0;
+	}
+	return entry->version;
+}
+
+std::string SourceSettingsWatcher::GetSettings(const OBSWeakSource &weakSource,
+					       uint64_t &version)
+{
+	OBSSourceAutoRelease source = obs_weak_source_get_source(weakSource);
+	if (!source) {
+		version = 0;
+		return GetSourceSettings(weakSource);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		auto entry = GetEntry(weakSource, source);
+		if (!entry) {
+			version = 0;
+		} else {
+			version = entry->version;
+			if (entry->cachedVersion == version) {
+				return entry->json;
+			}
+		}
+	}
+
+	auto json = GetSourceSettings(weakSource);
+	if (version == 0) {
+		return json;
+	}
+
+	// The entry might have been removed in the meantime
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto it = _entries.find(weakSource.Get());
+	if (it != _entries.end() && it->second->cachedVersion < version) {
+		it->second->json = json;
+		it->second->cachedVersion = version;
+	}
+	return json;
+}
+
+void SourceSettingsWatcher::SourceUpdated(void *data, calldata_t *)
+{
+	auto entry = static_cast<Entry *>(data);
+	++entry->version;
+}
+
+void SourceSettingsWatcher::SourceDestroyed(void *data, calldata_t *cd)
+{
+	auto watcher = static_cast<SourceSettingsWatcher *>(data);
+	auto source = static_cast<obs_source_t *>(calldata_ptr(cd, "source"));
+	if (!source) {
+		return;
+	}
+
+	OBSWeakSourceAutoRelease weakSource =
+		obs_source_get_weak_source(source);
+	std::lock_guard<std::mutex> lock(watcher->_mutex);
+	watcher->_entries.erase(weakSource.Get());
+}
+
+static std::optional<std::string> arrayToJson(obs_data_array_t *array)
+{
+	try {
+		auto result = nlohmann::json::array();
+		const auto count = obs_data_array_count(array);
+		for (size_t i = 0; i < count; i++) {
+			OBSDataAutoRelease item = obs_data_array_item(array, i);
+			auto json = obs_data_get_json(item);
+			result.push_back(json ? nlohmann::json::parse(json)
+					      : nlohmann::json::object());
+		}
+		return result.dump();
+	} catch (const nlohmann::json::exception &) {
+		return {};
+	}
+}
+
+static std::optional<std::string> objectToJson(obs_data_t *data)
+{
+	auto json = obs_data_get_json(data);
+	if (!json) {
+		return {};
+	}
+
+	// Reformat to match the compact representation of GetJsonField()
+	try {
+		return nlohmann::json::parse(json).dump();
+	} catch (const nlohmann::json::exception &) {
+		return json;
+	}
+}
+
+std::optional<std::string> LookupSourceSetting(obs_source_t *source,
+					       const std::string &id)
+{
+	OBSDataAutoRelease data = obs_source_get_settings(source);
+	if (!data) {
+		return {};
+	}
+
+	// Items only holding a default value are returned as well
+	OBSDataItemAutoRelease item = obs_data_item_byname(data, id.c_str());
+	if (!item) {
+		return {};
+	}
+
+	switch (obs_data_item_gettype(item)) {
+	case OBS_DATA_STRING: {
+		auto value = obs_data_item_get_string(item);
+		return value ? value : "";
+	}
+	case OBS_DATA_NUMBER:
+		if (obs_data_item_numtype(item) == OBS_DATA_NUM_INT) {
+			return std::to_string(obs_data_item_get_int(item));
+		}
+		return nlohmann::json(obs_data_item_get_double(item)).dump();
+	case OBS_DATA_BOOLEAN:
+		return obs_data_item_get_bool(item) ? "true" : "false";
+	case OBS_DATA_OBJECT: {
+		OBSDataAutoRelease obj = obs_data_item_get_obj(item);
+		return objectToJson(obj);
+	}
+	case OBS_DATA_ARRAY: {
+		OBSDataArrayAutoRelease array = obs_data_item_get_array(item);
+		return arrayToJson(array);
+	}
+	case OBS_DATA_NULL:
+	default:
+		break;
+	}
+	return {};
+}
+
+bool SourceSettingsCache::IsValid(const OBSWeakSource &source,
+				  uint64_t version,
+				  const std::string &key) const
+{
+	// A version of 0 means the source is not being watched, so we have no
+	// way of knowing if the cached state is still up to date
+	return version != 0 && _version == version && _source == source &&
+	       _key == key;
+}
+
+void SourceSettingsCache::Update(const OBSWeakSource &source, uint64_t version,
+				 const std::string &key,
+				 const std::optional<std::string> &value,
+				 bool result)
+{
+	_source = source;
+	_version = version;
+	_key = key;
+	_value = value;
+	_result = result;
+}
+
+void SourceSettingsCache::Reset()
+{
+	_version = 0;
+}
+
+} // namespace advss
@@ -0,0 +1,86 @@
+#pragma once
+#include <obs.hpp>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace advss {
+
+// Keeps track of modifications of source settings using the "update" signal of
+// each watched source.
+//
+// Every watched source is assigned a version number, which is incremented
+// whenever its settings are updated, so users only have to serialize or query
+// the settings again once the version changes.
+class SourceSettingsWatcher {
+public:
+	static SourceSettingsWatcher &Instance();
+
+	// Returns 0 if the source is invalid or cannot be watched
+	uint64_t GetVersion(const OBSWeakSource &);
+	// Returns the settings of the source as JSON string and the settings
+	// version it corresponds to
+	std::string GetSettings(const OBSWeakSource &, uint64_t &version);
+
+private:
+	SourceSettingsWatcher() = default;
+
+	struct Entry {
+		obs_weak_source_t *key = nullptr;
+		std::atomic<uint64_t> version{1};
+		uint64_t cachedVersion = 0;
+		std::string json;
+		OBSSignal updateSignal;
+	};
+
+	void Connect();
+	void Disconnect();
+	Entry *GetEntry(const OBSWeakSource &, obs_source_t *);
+
+	static void SourceUpdated(void *, calldata_t *);
+	static void SourceDestroyed(void *, calldata_t *);
+
+	std::mutex _mutex;
+	std::unordered_map<obs_weak_source_t *, std::unique_ptr<Entry>>
+		_entries;
+	OBSSignal _destroySignal;
+	bool _connected = false;
+
+	static bool _setupDone;
+	static bool Setup();
+};
+
+// Reads a single setting value (including its default value) directly from the
+// settings data of the source without serializing the full settings first
+std::optional<std::string> LookupSourceSetting(obs_source_t *,
+					       const std::string &id);
+
+// Remembers the source settings version a condition was last evaluated for.
+// Values derived from the settings, like the result of a comparison, only have
+// to be recalculated if the source, its settings version, or the lookup key
+// (e.g. the setting id or match pattern) changed.
+class SourceSettingsCache {
+public:
+	bool IsValid(const OBSWeakSource &, uint64_t version,
+		     const std::string &key = "") const;
+	void Update(const OBSWeakSource &, uint64_t version,
+		    const std::string &key,
+		    const std::optional<std::string> &value, bool result);
+	void Reset();
+
+	const std::optional<std::string> &Value() const { return _value; }
+	bool Result() const { return _result; }
+
+private:
+	OBSWeakSource _source;
+	uint64_t _version = 0;
+	std::string _key;
+	std::optional<std::string> _value;
+	bool _result = false;
+};
+
+} // namespace advss
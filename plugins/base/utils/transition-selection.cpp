@@ -1,10 +1,9 @@
 #include "transition-selection.hpp"
+#include "frontend-state.hpp"
 #include "obs-module-helper.hpp"
 #include "selection-helpers.hpp"
 #include "source-helpers.hpp"
 
-#include <obs-frontend-api.h>
-
 namespace advss {
 
 void TransitionSelection::Save(obs_data_t *obj, const char *name,
@@ -41,13 +40,8 @@ OBSWeakSource TransitionSelection::GetTransition() const
 	switch (_type) {
 	case Type::TRANSITION:
 		return _transition;
-	case Type::CURRENT: {
-		auto source = obs_frontend_get_current_transition();
-		auto weakSource = obs_source_get_weak_source(source);
-		obs_weak_source_release(weakSource);
-		obs_source_release(source);
-		return weakSource;
-	}
+	case Type::CURRENT:
+		return FrontendCurrentTransition();
 	default:
 		break;
 	}
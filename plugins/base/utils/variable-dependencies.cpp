@@ -0,0 +1,65 @@
+#include "variable-dependencies.hpp"
+
+namespace advss {
+
+void VariableDependencies::Reset()
+{
+	_dependencies.clear();
+	_lastVariableChange = GetLastVariableChangeTime();
+}
+
+void VariableDependencies::Add(const std::string &text)
+{
+	size_t begin = 0;
+	while ((begin = text.find("${", begin)) != std::string::npos) {
+		const auto end = text.find('}', begin);
+		if (end == std::string::npos) {
+			return;
+		}
+		auto name = text.substr(begin + 2, end - begin - 2);
+		auto variable = GetWeakVariableByName(name);
+		auto lockedVariable = variable.lock();
+		_dependencies.push_back(
+			{name, variable, !!lockedVariable,
+			 lockedVariable ? lockedVariable->GetValueChangeCount()
+					: 0});
+		begin = end + 1;
+	}
+}
+
+void VariableDependencies::Add(const std::weak_ptr<Variable> &variable)
+{
+	auto lockedVariable = variable.lock();
+	_dependencies.push_back(
+		{"", variable, !!lockedVariable,
+		 lockedVariable ? lockedVariable->GetValueChangeCount() : 0});
+}
+
+bool VariableDependencies::Changed()
+{
+	// Checking each dependency can be skipped if no variable was modified
+	// at all
+	const auto lastVariableChange = GetLastVariableChangeTime();
+	if (_lastVariableChange == lastVariableChange) {
+		return false;
+	}
+
+	for (const auto &dependency : _dependencies) {
+		auto variable = dependency.variable.lock();
+		if (!dependency.name.empty() &&
+		    GetWeakVariableByName(dependency.name).lock() != variable) {
+			return true;
+		}
+		if (!!variable != dependency.existed) {
+			return true;
+		}
+		if (variable &&
+		    variable->GetValueChangeCount() != dependency.changeCount) {
+			return true;
+		}
+	}
+	_lastVariableChange = lastVariableChange;
+	return false;
+}
+
+} // namespace advss
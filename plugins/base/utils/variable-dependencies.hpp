@@ -0,0 +1,38 @@
+#pragma once
+#include "variable.hpp"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace advss {
+
+// Tracks the variables a value was derived from, so the value only has to be
+// determined again if one of these variables changed.
+class VariableDependencies {
+public:
+	// Removes all dependencies and remembers the current state of the
+	// variables, so it should be called before adding new dependencies
+	void Reset();
+	// Adds the variables referenced using the "${name}" syntax
+	void Add(const std::string &text);
+	void Add(const std::weak_ptr<Variable> &);
+	// Returns true if one of the variables changed its value or was
+	// removed, or if a variable with a referenced name was added or renamed
+	bool Changed();
+
+private:
+	struct Dependency {
+		// Empty for variables, which are not referenced by name
+		std::string name;
+		std::weak_ptr<Variable> variable;
+		bool existed = false;
+		int changeCount = 0;
+	};
+
+	std::vector<Dependency> _dependencies;
+	std::chrono::high_resolution_clock::time_point _lastVariableChange{};
+};
+
+} // namespace advss
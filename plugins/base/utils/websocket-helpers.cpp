@@ -64,13 +64,16 @@ WSClientConnection::WSClientConnection(bool useOBSProtocol) : QObject(nullptr)
 		websocketpp::log::alevel::frame_header |
 		websocketpp::log::alevel::frame_payload |
 		websocketpp::log::alevel::control);
-	_client.init_asio();
+	// All connections share the same event loop instead of running their
+	// own in a separate thread
+	_client.init_asio(&NetworkRuntime::Instance().Context());
 #ifndef _WIN32
 	_client.set_reuse_addr(true);
 #endif
 
 	UseOBSWebsocketProtocol(useOBSProtocol);
 	_client.set_close_handler(bind(&WSClientConnection::OnClose, this, _1));
+	_client.set_fail_handler(bind(&WSClientConnection::OnFail, this, _1));
 }
 
 WSClientConnection::~WSClientConnection()
@@ -78,42 +81,39 @@ WSClientConnection::~WSClientConnection()
 	Disconnect();
 }
 
-void WSClientConnection::ConnectThread()
+void WSClientConnection::StartConnection()
 {
-	do {
-		std::unique_lock<std::mutex> lck(_waitMtx);
-		_client.reset();
-		_status = Status::CONNECTING;
-		// Create a connection to the given URI and queue it for connection once
-		// the event loop starts
-		websocketpp::lib::error_code ec;
-		client::connection_ptr con = _client.get_connection(_uri, ec);
-		if (ec) {
-			_failMsg = ec.message();
-			blog(LOG_INFO, "connect to '%s' failed: %s",
-			     _uri.c_str(), _failMsg.c_str());
-		} else {
-			_failMsg = "";
-			_client.connect(con);
-			_connection = connection_hdl(con);
-
-			// Start the ASIO io_service run loop
-			vblog(LOG_INFO, "connect io thread started for '%s'",
-			      _uri.c_str());
-			_client.run();
-			vblog(LOG_INFO, "connect: io thread exited '%s'",
-			      _uri.c_str());
-		}
+	_status = Status::CONNECTING;
+	websocketpp::lib::error_code ec;
+	client::connection_ptr con = _client.get_connection(_uri, ec);
+	if (ec) {
+		_failMsg = ec.message();
+		blog(LOG_INFO, "connect to '%s' failed: %s", _uri.c_str(),
+		     _failMsg.c_str());
+		_status = Status::DISCONNECTED;
+		ScheduleReconnect();
+		return;
+	}
+
+	_failMsg = "";
+	_connection = connection_hdl(con);
+	_client.connect(con);
+	vblog(LOG_INFO, "connecting to '%s'", _uri.c_str());
+}
+
+void WSClientConnection::ScheduleReconnect()
+{
+	if (!_reconnect || _disconnect) {
+		return;
+	}
 
-		if (_reconnect) {
-			blog(LOG_INFO,
-			     "trying to reconnect to %s in %d seconds.",
-			     _uri.c_str(), _reconnectDelay);
-			_cv.wait_for(lck,
-				     std::chrono::seconds(_reconnectDelay));
+	blog(LOG_INFO, "trying to reconnect to %s in %d seconds.",
+	     _uri.c_str(), _reconnectDelay);
+	_reconnectTimer.Start(std::chrono::seconds(_reconnectDelay), [this]() {
+		if (!_disconnect) {
+			StartConnection();
 		}
-	} while (_reconnect && !_disconnect);
-	_status = Status::DISCONNECTED;
+	});
 }
 
 void WSClientConnection::Connect(const std::string &uri,
@@ -126,15 +126,14 @@ void WSClientConnection::Connect(const std::string &uri,
 		     uri.c_str());
 		return;
 	}
+	_disconnect = true;
+	_reconnectTimer.Cancel();
 	_uri = uri;
 	_password = pass;
 	_reconnect = reconnect;
 	_reconnectDelay = reconnectDelay;
 	_disconnect = false;
-	if (_thread.joinable()) {
-		_thread.join();
-	}
-	_thread = std::thread(&WSClientConnection::ConnectThread, this);
+	StartConnection();
 	blog(LOG_INFO, "connect to '%s' started", uri.c_str());
 }
 
@@ -142,23 +141,24 @@ void WSClientConnection::Disconnect()
 {
 	std::lock_guard<std::mutex> lock(_connectMtx);
 	_disconnect = true;
+	_reconnectTimer.Cancel();
 	websocketpp::lib::error_code ec;
 	_client.close(_connection, websocketpp::close::status::normal,
 		      "Client stopping", ec);
-	{
-		std::unique_lock<std::mutex> waitLck(_waitMtx);
-		_cv.notify_all();
-	}
 
-	while (_status != Status::DISCONNECTED) {
+	// Connections which are still being established cannot be closed yet.
+	// The handlers are bound to this object, so wait until the connection
+	// was released, which only happens once its last handler has returned.
+	while (!_connection.expired() &&
+	       !NetworkRuntime::Instance().Stopped()) {
 		std::this_thread::sleep_for(std::chrono::milliseconds(10));
 		_client.close(_connection, websocketpp::close::status::normal,
 			      "Client stopping", ec);
 	}
 
-	if (_thread.joinable()) {
-		_thread.join();
-	}
+	// The close handler might have scheduled a reconnect before it noticed
+	// that the connection is being stopped
+	_reconnectTimer.Cancel();
 	_status = Status::DISCONNECTED;
 }
 
@@ -387,6 +387,20 @@ void WSClientConnection::OnClose(connection_hdl)
 {
 	blog(LOG_INFO, "client-connection to %s closed.", _uri.c_str());
 	_status = Status::DISCONNECTED;
+	ScheduleReconnect();
+}
+
+void WSClientConnection::OnFail(connection_hdl hdl)
+{
+	websocketpp::lib::error_code ec;
+	auto con = _client.get_con_from_hdl(hdl, ec);
+	if (con) {
+		_failMsg = con->get_ec().message();
+	}
+	blog(LOG_INFO, "client-connection to %s failed: %s", _uri.c_str(),
+	     _failMsg.c_str());
+	_status = Status::DISCONNECTED;
+	ScheduleReconnect();
 }
 
 } // namespace advss
@@ -1,6 +1,7 @@
 #pragma once
 #include "message-buffer.hpp"
 #include "message-dispatcher.hpp"
+#include "network-runtime.hpp"
 
 #include <set>
 #include <QtCore/QObject>
@@ -60,8 +61,10 @@ private:
 	void OnGenericMessage(connection_hdl hdl, client::message_ptr message);
 	void OnOBSMessage(connection_hdl hdl, client::message_ptr message);
 	void OnClose(connection_hdl hdl);
+	void OnFail(connection_hdl hdl);
 	void Send(const std::string &);
-	void ConnectThread();
+	void StartConnection();
+	void ScheduleReconnect();
 	void HandleHello(obs_data_t *helloMsg);
 	void HandleEvent(obs_data_t *event);
 	void HandleResponse(obs_data_t *response);
@@ -70,12 +73,10 @@ private:
 	std::string _uri = "";
 	std::string _password = "";
 	connection_hdl _connection;
-	std::thread _thread;
+	NetworkTimer _reconnectTimer;
 	bool _reconnect = false;
 	int _reconnectDelay = 10;
-	std::mutex _waitMtx;
 	std::mutex _connectMtx;
-	std::condition_variable _cv;
 	std::string _failMsg = "";
 	std::atomic<Status> _status = {Status::DISCONNECTED};
 	std::atomic_bool _disconnect{false};
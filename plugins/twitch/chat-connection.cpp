@@ -322,7 +322,9 @@ TwitchChatConnection::TwitchChatConnection(const TwitchToken &token,
 		websocketpp::log::alevel::frame_header |
 		websocketpp::log::alevel::frame_payload |
 		websocketpp::log::alevel::control);
-	_client.init_asio();
+	// All connections share the same event loop instead of running their
+	// own in a separate thread
+	_client.init_asio(&NetworkRuntime::Instance().Context());
 #ifndef _WIN32
 	_client.set_reuse_addr(true);
 #endif
@@ -370,34 +372,37 @@ TwitchChatConnection::GetChatConnection(const TwitchToken &token_,
 	return connection;
 }
 
-void TwitchChatConnection::ConnectThread()
+void TwitchChatConnection::StartConnection()
 {
-	while (!_stop) {
-		_state = State::CONNECTING;
-		_client.reset();
-		websocketpp::lib::error_code ec;
-		websocketpp::client<websocketpp::config::asio_tls_client>::
-			connection_ptr con = _client.get_connection(_url, ec);
-		if (ec) {
-			blog(LOG_INFO, "TwitchChatConnection failed: %s",
-			     ec.message().c_str());
-		} else {
-			_client.connect(con);
-			_connection = connection_hdl(con);
-			_client.run();
-		}
-
-		if (_stop) {
-			break;
-		}
+	_state = State::CONNECTING;
+	websocketpp::lib::error_code ec;
+	websocketpp::client<websocketpp::config::asio_tls_client>::connection_ptr
+		con = _client.get_connection(_url, ec);
+	if (ec) {
+		blog(LOG_INFO, "TwitchChatConnection failed: %s",
+		     ec.message().c_str());
+		ScheduleReconnect();
+		return;
+	}
+	_connection = connection_hdl(con);
+	_client.connect(con);
+}
 
-		blog(LOG_INFO,
-		     "TwitchChatConnection trying to reconnect to in %ld seconds.",
-		     (long int)reconnectDelay.count());
-		std::unique_lock<std::mutex> lock(_waitMtx);
-		_cv.wait_for(lock, std::chrono::seconds(reconnectDelay));
+void TwitchChatConnection::ScheduleReconnect()
+{
+	if (_stop) {
+		_state = State::DISCONNECTED;
+		return;
 	}
-	_state = State::DISCONNECTED;
+
+	blog(LOG_INFO,
+	     "TwitchChatConnection trying to reconnect to in %ld seconds.",
+	     (long int)reconnectDelay.count());
+	_reconnectTimer.Start(reconnectDelay, [this]() {
+		if (!_stop) {
+			StartConnection();
+		}
+	});
 }
 
 void TwitchChatConnection::Connect()
@@ -409,46 +414,41 @@ void TwitchChatConnection::Connect()
 		return;
 	}
 
-	if (_thread.joinable()) {
-		_thread.join();
-	}
-
+	_stop = true;
+	_reconnectTimer.Cancel();
 	_stop = false;
-	_state = State::CONNECTING;
-	_thread = std::thread(&TwitchChatConnection::ConnectThread, this);
+	StartConnection();
 }
 
 void TwitchChatConnection::Disconnect()
 {
 	std::lock_guard<std::mutex> lock(_connectMtx);
-	if (_state == State::DISCONNECTED) {
+	if (_state == State::DISCONNECTED && _connection.expired()) {
 		vblog(LOG_INFO, "TwitchChatConnection already disconnected");
 		return;
 	}
 
 	_stop = true;
+	_reconnectTimer.Cancel();
 
 	websocketpp::lib::error_code ec;
 	_client.close(_connection, websocketpp::close::status::normal,
 		      "Twitch chat connection stopping", ec);
-	if (ec) {
-		blog(LOG_INFO, "TwitchChatConnection close failed: %s",
-		     ec.message().c_str());
 
-		// TODO: avoid using stop()
-		_stop = true;
-		std::this_thread::sleep_for(3s);
-		_client.stop();
+	// Connections which are still being established cannot be closed yet.
+	// The handlers are bound to this object, so wait until the connection
+	// was released, which only happens once its last handler has returned.
+	while (!_connection.expired() &&
+	       !NetworkRuntime::Instance().Stopped()) {
+		std::this_thread::sleep_for(10ms);
+		_client.close(_connection, websocketpp::close::status::normal,
+			      "Twitch chat connection stopping", ec);
 	}
 
-	{
-		std::unique_lock<std::mutex> waitLock(_waitMtx);
-		_cv.notify_all();
-	}
-
-	if (_thread.joinable()) {
-		_thread.join();
-	}
+	// The close handler might have scheduled a reconnect before it noticed
+	// that the connection is being stopped
+	_reconnectTimer.Cancel();
+	_state = State::DISCONNECTED;
 }
 
 static std::string toLowerCase(const std::string &str)
@@ -651,6 +651,7 @@ void TwitchChatConnection::OnClose(connection_hdl hdl)
 		con = _client.get_con_from_hdl(hdl);
 	auto msg = con->get_ec().message();
 	blog(LOG_INFO, "Twitch chat connection closed: %s", msg.c_str());
+	ScheduleReconnect();
 }
 
 void TwitchChatConnection::OnFail(connection_hdl hdl)
@@ -659,6 +660,7 @@ void TwitchChatConnection::OnFail(connection_hdl hdl)
 		con = _client.get_con_from_hdl(hdl);
 	auto msg = con->get_ec().message();
 	blog(LOG_INFO, "Twitch chat connection failed: %s", msg.c_str());
+	ScheduleReconnect();
 }
 
 void TwitchChatConnection::Send(const std::string &msg)
@@ -5,6 +5,7 @@
 #include <condition_variable>
 #include <mutex>
 #include <message-buffer.hpp>
+#include <network-runtime.hpp>
 #include <QObject>
 #include <websocketpp/client.hpp>
 #include <websocketpp/config/asio.hpp>
@@ -92,7 +93,8 @@ private:
 	void OnClose(connection_hdl hdl);
 	void OnFail(connection_hdl hdl);
 	void Send(const std::string &msg);
-	void ConnectThread();
+	void StartConnection();
+	void ScheduleReconnect();
 
 	void Authenticate();
 	void JoinChannel(const std::string &);
@@ -117,10 +119,8 @@ private:
 
 	websocketpp::client<websocketpp::config::asio_tls_client> _client;
 	connection_hdl _connection;
-	std::thread _thread;
-	std::mutex _waitMtx;
+	NetworkTimer _reconnectTimer;
 	std::mutex _connectMtx;
-	std::condition_variable _cv;
 
 	enum class State { DISCONNECTED, CONNECTING, CONNECTED };
 	std::atomic<State> _state = {State::DISCONNECTED};
@@ -34,7 +34,9 @@ EventSub::EventSub() : QObject(nullptr)
 		websocketpp::log::alevel::frame_header |
 		websocketpp::log::alevel::frame_payload |
 		websocketpp::log::alevel::control);
-	_client.init_asio();
+	// All connections share the same event loop instead of running their
+	// own in a separate thread
+	_client.init_asio(&NetworkRuntime::Instance().Context());
 #ifndef _WIN32
 	_client.set_reuse_addr(true);
 #endif
@@ -76,30 +78,35 @@ void EventSub::UnregisterInstance()
 	_instances.erase(it, _instances.end());
 }
 
-void EventSub::ConnectThread()
+void EventSub::StartConnection()
 {
-	while (!_disconnect) {
-		std::unique_lock<std::mutex> lock(_waitMtx);
-		_client.reset();
-		_connected = true;
-		websocketpp::lib::error_code ec;
-		EventSubWSClient::connection_ptr con =
-			_client.get_connection(_url, ec);
-		if (ec) {
-			blog(LOG_INFO, "Twitch EventSub failed: %s",
-			     ec.message().c_str());
-		} else {
-			_client.connect(con);
-			_connection = connection_hdl(con);
-			_client.run();
-		}
+	_connected = true;
+	websocketpp::lib::error_code ec;
+	EventSubWSClient::connection_ptr con = _client.get_connection(_url, ec);
+	if (ec) {
+		blog(LOG_INFO, "Twitch EventSub failed: %s",
+		     ec.message().c_str());
+		_connected = false;
+		ScheduleReconnect();
+		return;
+	}
+	_connection = connection_hdl(con);
+	_client.connect(con);
+}
 
-		blog(LOG_INFO,
-		     "Twitch EventSub trying to reconnect to in %d seconds.",
-		     reconnectDelay);
-		_cv.wait_for(lock, std::chrono::seconds(reconnectDelay));
+void EventSub::ScheduleReconnect()
+{
+	if (_disconnect) {
+		return;
 	}
-	_connected = false;
+
+	blog(LOG_INFO, "Twitch EventSub trying to reconnect to in %d seconds.",
+	     reconnectDelay);
+	_reconnectTimer.Start(std::chrono::seconds(reconnectDelay), [this]() {
+		if (!_disconnect) {
+			StartConnection();
+		}
+	});
 }
 
 void EventSub::Connect()
@@ -110,11 +117,9 @@ void EventSub::Connect()
 		return;
 	}
 	_disconnect = true;
-	if (_thread.joinable()) {
-		_thread.join();
-	}
+	_reconnectTimer.Cancel();
 	_disconnect = false;
-	_thread = std::thread(&EventSub::ConnectThread, this);
+	StartConnection();
 }
 
 void EventSub::ClearActiveSubscriptions()
@@ -127,23 +132,24 @@ void EventSub::Disconnect()
 {
 	std::lock_guard<std::mutex> lock(_connectMtx);
 	_disconnect = true;
+	_reconnectTimer.Cancel();
 	websocketpp::lib::error_code ec;
 	_client.close(_connection, websocketpp::close::status::normal,
 		      "Twitch EventSub stopping", ec);
-	{
-		std::unique_lock<std::mutex> waitLock(_waitMtx);
-		_cv.notify_all();
-	}
 
-	while (_connected) {
+	// Connections which are still being established cannot be closed yet.
+	// The handlers are bound to this object, so wait until the connection
+	// was released, which only happens once its last handler has returned.
+	while (!_connection.expired() &&
+	       !NetworkRuntime::Instance().Stopped()) {
 		std::this_thread::sleep_for(std::chrono::milliseconds(10));
 		_client.close(_connection, websocketpp::close::status::normal,
 			      "Twitch EventSub stopping", ec);
 	}
 
-	if (_thread.joinable()) {
-		_thread.join();
-	}
+	// The close handler might have scheduled a reconnect before it noticed
+	// that the connection is being stopped
+	_reconnectTimer.Cancel();
 	_connected = false;
 	ClearActiveSubscriptions();
 }
@@ -392,6 +398,7 @@ void EventSub::OnClose(connection_hdl hdl)
 	blog(LOG_INFO, "Twitch EventSub connection closed: %s", msg.c_str());
 	ClearActiveSubscriptions();
 	_connected = false;
+	ScheduleReconnect();
 }
 
 void EventSub::OnFail(connection_hdl hdl)
@@ -401,6 +408,7 @@ void EventSub::OnFail(connection_hdl hdl)
 	blog(LOG_INFO, "Twitch EventSub connection failed: %s", msg.c_str());
 	ClearActiveSubscriptions();
 	_connected = false;
+	ScheduleReconnect();
 }
 
 bool Subscription::operator<(const Subscription &other) const
@@ -1,5 +1,6 @@
 #pragma once
 #include "message-dispatcher.hpp"
+#include "network-runtime.hpp"
 
 #include <obs.hpp>
 #include <websocketpp/client.hpp>
@@ -65,7 +66,8 @@ private:
 		       EventSubWSClient::message_ptr message);
 	void OnClose(connection_hdl hdl);
 	void OnFail(connection_hdl hdl);
-	void ConnectThread();
+	void StartConnection();
+	void ScheduleReconnect();
 
 	bool IsValidMessageID(const std::string &);
 	bool IsValidID(const std::string &);
@@ -81,10 +83,8 @@ private:
 
 	EventSubWSClient _client;
 	connection_hdl _connection;
-	std::thread _thread;
-	std::mutex _waitMtx;
+	NetworkTimer _reconnectTimer;
 	std::mutex _connectMtx;
-	std::condition_variable _cv;
 	std::atomic_bool _connected{false};
 	std::atomic_bool _disconnect{false};
 	std::string _url;
@@ -2,11 +2,31 @@
 #include "token.hpp"
 
 #include <log-helper.hpp>
+#include <plugin-state-helpers.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
 
 namespace advss {
 
 static constexpr std::string_view clientID = "ds5tt4ogliifsqc04mz3d3etnck3e5";
 static const int cacheTimeoutSeconds = 10;
+static const int unusedCacheEntryTimeoutSeconds = 60;
+// Outdated results are no longer served once refreshing them failed for this
+// long, so conditions do not keep acting on data, which might be wrong by now
+static const int maxStaleResultSeconds = 60;
+static const size_t maxCacheEntries = 256;
+static const size_t maxIdleClientsPerURI = 4;
+static const int requestTimeoutSeconds = 10;
+static const int minRateLimitReserve = 10;
+static const int rateLimitReserveDivisor = 10;
 
 const char *GetClientID()
 {
@@ -27,15 +47,16 @@ public:
 	}
 	bool operator<(const Args &other) const
 	{
-		bool ret = true;
-		ret = ret && _uri < other._uri;
-		ret = ret && _path < other._path;
-		ret = ret && _params < other._params;
-		ret = ret && _data < other._data;
-		ret = ret && _headers < other._headers;
-		return ret;
+		return std::tie(_uri, _path, _params, _data, _headers) <
+		       std::tie(other._uri, other._path, other._params,
+				other._data, other._headers);
 	}
 
+	const std::string &URI() const { return _uri; }
+	const std::string &Path() const { return _path; }
+	const httplib::Params &Params() const { return _params; }
+	const httplib::Headers &Headers() const { return _headers; }
+
 private:
 	std::string _uri;
 	std::string _path;
@@ -64,6 +85,122 @@ static bool cacheIsValid(const std::map<Args, CacheEntry> &cache,
 	return it != cache.end() && !cacheIsTooOld(it->second);
 }
 
+// Connections to the Twitch API are kept open and reused for following
+// requests, so not every request has to perform a new TLS handshake.
+// httplib::Client does not support concurrent requests, so each client is
+// only ever used by a single request at a time.
+static std::mutex clientPoolMutex;
+static std::map<std::string, std::vector<std::unique_ptr<httplib::Client>>>
+	clientPool;
+
+static std::unique_ptr<httplib::Client> acquireClient(const std::string &uri)
+{
+	{
+		std::lock_guard<std::mutex> lock(clientPoolMutex);
+		auto &clients = clientPool[uri];
+		if (!clients.empty()) {
+			auto client = std::move(clients.back());
+			clients.pop_back();
+			return client;
+		}
+	}
+
+	auto client = std::make_unique<httplib::Client>(uri);
+	client->set_keep_alive(true);
+	client->set_connection_timeout(requestTimeoutSeconds);
+	client->set_read_timeout(requestTimeoutSeconds);
+	return client;
+}
+
+static void releaseClient(const std::string &uri,
+			  std::unique_ptr<httplib::Client> client)
+{
+	std::lock_guard<std::mutex> lock(clientPoolMutex);
+	auto &clients = clientPool[uri];
+	if (clients.size() < maxIdleClientsPerURI) {
+		clients.emplace_back(std::move(client));
+	}
+}
+
+template<typename Func>
+static httplib::Result sendRequest(const std::string &uri, Func &&send)
+{
+	auto client = acquireClient(uri);
+	auto response = send(*client);
+
+	// The connection might be broken, so the client is discarded
+	if (response) {
+		releaseClient(uri, std::move(client));
+	}
+	return response;
+}
+
+// The Twitch API reports the state of the rate limit bucket of each token in
+// the response headers.
+// See: https://dev.twitch.tv/docs/api/guide/#twitch-rate-limits
+struct RateLimit {
+	int limit = 0;
+	int remaining = 0;
+	std::chrono::system_clock::time_point reset;
+};
+
+static std::mutex rateLimitMutex;
+static std::map<std::string, RateLimit> rateLimits;
+
+static std::string getTokenFromHeaders(const httplib::Headers &headers)
+{
+	auto it = headers.find("Authorization");
+	if (it == headers.end()) {
+		return "";
+	}
+	return it->second;
+}
+
+static void updateRateLimit(const httplib::Headers &requestHeaders,
+			    const httplib::Result &response)
+{
+	if (!response || !response->has_header("Ratelimit-Remaining") ||
+	    !response->has_header("Ratelimit-Reset")) {
+		return;
+	}
+
+	RateLimit rateLimit;
+	try {
+		rateLimit.limit = std::stoi(
+			response->get_header_value("Ratelimit-Limit"));
+		rateLimit.remaining = std::stoi(
+			response->get_header_value("Ratelimit-Remaining"));
+		rateLimit.reset = std::chrono::system_clock::from_time_t(
+			std::stoll(response->get_header_value(
+				"Ratelimit-Reset")));
+	} catch (const std::exception &) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(rateLimitMutex);
+	rateLimits[getTokenFromHeaders(requestHeaders)] = rateLimit;
+}
+
+// Background refreshes are postponed until the rate limit bucket is refilled
+// if it is running low, so requests triggered by actions are not rejected
+static std::chrono::system_clock::time_point
+getNextRefreshTime(const httplib::Headers &requestHeaders)
+{
+	std::lock_guard<std::mutex> lock(rateLimitMutex);
+	auto it = rateLimits.find(getTokenFromHeaders(requestHeaders));
+	if (it == rateLimits.end()) {
+		return {};
+	}
+
+	const auto &rateLimit = it->second;
+	const int reserve = std::max(minRateLimitReserve,
+				     rateLimit.limit / rateLimitReserveDivisor);
+	if (rateLimit.remaining > reserve) {
+		return {};
+	}
+	return rateLimit.reset;
+}
+
 static httplib::Headers getTokenRequestHeaders(const std::string &token)
 {
 	return {
@@ -78,9 +215,12 @@ static std::string getRequestBody(const OBSData &data)
 	return json ? json : "";
 }
 
-static RequestResult processResult(const httplib::Result &response,
+static RequestResult processResult(const httplib::Headers &requestHeaders,
+				   const httplib::Result &response,
 				   const char *funcName)
 {
+	updateRateLimit(requestHeaders, response);
+
 	if (!response) {
 		auto err = response.error();
 		blog(LOG_WARNING, "Twitch request failed in %s with error: %s",
@@ -107,7 +247,6 @@ RequestResult SendGetRequest(const TwitchToken &token, const std::string &uri,
 			     const std::string &path,
 			     const httplib::Params &params)
 {
-	httplib::Client cli(uri);
 	auto tokenStr = token.GetToken();
 
 	if (!tokenStr) {
@@ -118,36 +257,266 @@ RequestResult SendGetRequest(const TwitchToken &token, const std::string &uri,
 	vblog(LOG_INFO, "Twitch GET request to %s began", url.c_str());
 
 	auto headers = getTokenRequestHeaders(*tokenStr);
-	auto response = cli.Get(path, params, headers);
+	auto response = sendRequest(uri, [&](httplib::Client &cli) {
+		return cli.Get(path, params, headers);
+	});
+
+	return processResult(headers, response, __func__);
+}
+
+// Cached GET requests are served from the cache even if the cached result is
+// outdated, while it is refreshed in the background.
+// So only the very first request for each set of arguments has to wait for the
+// Twitch API to respond.
+class GetRequestCache {
+public:
+	static GetRequestCache &Instance();
+	RequestResult Get(const Args &);
+
+private:
+	struct Entry {
+		RequestResult result;
+		// Time the result was received successfully
+		std::chrono::system_clock::time_point cacheTime;
+		// Time of the last attempt to refresh the result
+		std::chrono::system_clock::time_point refreshTime;
+		std::chrono::system_clock::time_point lastAccess;
+		bool refreshQueued = false;
+	};
+
+	GetRequestCache() = default;
+	~GetRequestCache();
+
+	RequestResult Fetch(const Args &);
+	void Store(const Args &, const RequestResult &);
+	void QueueRefresh(const Args &, Entry &);
+	void RemoveUnusedEntries();
+	void Stop();
+	void Worker();
+
+	std::mutex _mutex;
+	std::condition_variable _cv;
+	std::map<Args, Entry> _entries;
+	std::map<Args, std::shared_future<RequestResult>> _pendingRequests;
+	std::deque<Args> _refreshQueue;
+	std::thread _thread;
+	bool _stop = false;
+
+	static bool _setupDone;
+	static bool Setup();
+};
+
+bool GetRequestCache::_setupDone = GetRequestCache::Setup();
+
+bool GetRequestCache::Setup()
+{
+	AddPluginCleanupStep([]() {
+		GetRequestCache::Instance().Stop();
+		std::lock_guard<std::mutex> lock(clientPoolMutex);
+		clientPool.clear();
+	});
+	return true;
+}
+
+GetRequestCache &GetRequestCache::Instance()
+{
+	static GetRequestCache cache;
+	return cache;
+}
 
-	return processResult(response, __func__);
+GetRequestCache::~GetRequestCache()
+{
+	Stop();
+}
+
+RequestResult GetRequestCache::Get(const Args &args)
+{
+	std::promise<RequestResult> promise;
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		auto it = _entries.find(args);
+		if (it != _entries.end()) {
+			auto &entry = it->second;
+			entry.lastAccess = std::chrono::system_clock::now();
+			if (entry.lastAccess - entry.refreshTime >=
+			    std::chrono::seconds(cacheTimeoutSeconds)) {
+				QueueRefresh(args, entry);
+			}
+			return entry.result;
+		}
+
+		// Identical requests, which are already in progress, are not
+		// sent again
+		auto pending = _pendingRequests.find(args);
+		if (pending != _pendingRequests.end()) {
+			auto pendingResult = pending->second;
+			lock.unlock();
+			return pendingResult.get();
+		}
+		_pendingRequests[args] = promise.get_future().share();
+	}
+
+	auto result = Fetch(args);
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		Store(args, result);
+		_pendingRequests.erase(args);
+	}
+	promise.set_value(result);
+	return result;
+}
+
+RequestResult GetRequestCache::Fetch(const Args &args)
+{
+	auto url = httplib::append_query_params(args.URI() + args.Path(),
+						args.Params());
+	vblog(LOG_INFO, "Twitch GET request to %s began", url.c_str());
+
+	const auto &headers = args.Headers();
+	auto response = sendRequest(args.URI(), [&](httplib::Client &cli) {
+		return cli.Get(args.Path(), args.Params(), headers);
+	});
+	return processResult(headers, response, "SendGetRequest");
+}
+
+void GetRequestCache::Store(const Args &args, const RequestResult &result)
+{
+	const auto now = std::chrono::system_clock::now();
+	auto it = _entries.find(args);
+	if (it == _entries.end()) {
+		Entry entry;
+		entry.result = result;
+		entry.cacheTime = now;
+		entry.refreshTime = now;
+		entry.lastAccess = now;
+		_entries.emplace(args, entry);
+	} else {
+		auto &entry = it->second;
+		entry.refreshTime = now;
+		entry.refreshQueued = false;
+		// Keep serving the previous result for a while if the request
+		// failed entirely, e.g. due to a network error
+		if (result.status != 0) {
+			entry.result = result;
+			entry.cacheTime = now;
+		} else if (now - entry.cacheTime >=
+			   std::chrono::seconds(maxStaleResultSeconds)) {
+			entry.result = result;
+		}
+	}
+	RemoveUnusedEntries();
+}
+
+void GetRequestCache::QueueRefresh(const Args &args, Entry &entry)
+{
+	if (entry.refreshQueued || _stop) {
+		return;
+	}
+	entry.refreshQueued = true;
+	_refreshQueue.emplace_back(args);
+	if (!_thread.joinable()) {
+		_thread = std::thread(&GetRequestCache::Worker, this);
+	}
+	_cv.notify_one();
+}
+
+void GetRequestCache::RemoveUnusedEntries()
+{
+	const auto now = std::chrono::system_clock::now();
+	for (auto it = _entries.begin(); it != _entries.end();) {
+		const auto &entry = it->second;
+		const auto unused = now - entry.lastAccess >=
+				    std::chrono::seconds(
+					    unusedCacheEntryTimeoutSeconds);
+		if (unused && !entry.refreshQueued) {
+			it = _entries.erase(it);
+		} else {
+			++it;
+		}
+	}
+
+	while (_entries.size() > maxCacheEntries) {
+		auto oldest = std::min_element(
+			_entries.begin(), _entries.end(),
+			[](const auto &a, const auto &b) {
+				return a.second.lastAccess <
+				       b.second.lastAccess;
+			});
+		_entries.erase(oldest);
+	}
+}
+
+void GetRequestCache::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop = true;
+		_refreshQueue.clear();
+	}
+	_cv.notify_all();
+	if (_thread.joinable()) {
+		_thread.join();
+	}
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	_entries.clear();
+}
+
+void GetRequestCache::Worker()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (true) {
+		_cv.wait(lock, [this]() {
+			return _stop || !_refreshQueue.empty();
+		});
+		if (_stop) {
+			return;
+		}
+
+		auto args = _refreshQueue.front();
+		_refreshQueue.pop_front();
+		if (_entries.find(args) == _entries.end()) {
+			continue;
+		}
+
+		auto nextRefresh = getNextRefreshTime(args.Headers());
+		if (nextRefresh > std::chrono::system_clock::now()) {
+			vblog(LOG_INFO, "postponing Twitch cache refresh due "
+					"to rate limit");
+			_cv.wait_until(lock, nextRefresh,
+				       [this]() { return _stop; });
+			if (_stop) {
+				return;
+			}
+		}
+
+		lock.unlock();
+		auto result = Fetch(args);
+		lock.lock();
+
+		// The entry might have been removed in the meantime
+		if (_entries.find(args) != _entries.end()) {
+			Store(args, result);
+		}
+	}
 }
 
 RequestResult SendGetRequest(const TwitchToken &token, const std::string &uri,
 			     const std::string &path,
 			     const httplib::Params &params, bool useCache)
 {
-	static std::map<Args, CacheEntry> cache;
-	static std::mutex mtx;
-	std::lock_guard<std::mutex> lock(mtx);
-	auto tokenStr = token.GetToken();
+	if (!useCache) {
+		return SendGetRequest(token, uri, path, params);
+	}
 
+	auto tokenStr = token.GetToken();
 	if (!tokenStr) {
 		return {};
 	}
 
 	auto headers = getTokenRequestHeaders(*tokenStr);
 	Args args(uri, path, "", params, headers);
-
-	if (useCache && cacheIsValid(cache, args)) {
-		auto it = cache.find(args);
-		return it->second.result;
-	}
-
-	auto result = SendGetRequest(token, uri, path, params);
-	cache[args] = {result};
-
-	return result;
+	return GetRequestCache::Instance().Get(args);
 }
 
 RequestResult SendPostRequest(const TwitchToken &token, const std::string &uri,
@@ -155,7 +524,6 @@ RequestResult SendPostRequest(const TwitchToken &token, const std::string &uri,
 			      const httplib::Params &params,
 			      const OBSData &data)
 {
-	httplib::Client cli(uri);
 	auto tokenStr = token.GetToken();
 
 	if (!tokenStr) {
@@ -168,10 +536,12 @@ RequestResult SendPostRequest(const TwitchToken &token, const std::string &uri,
 
 	auto headers = getTokenRequestHeaders(*tokenStr);
 	auto body = getRequestBody(data);
-	auto response =
-		cli.Post(pathWithParams, headers, body, "application/json");
+	auto response = sendRequest(uri, [&](httplib::Client &cli) {
+		return cli.Post(pathWithParams, headers, body,
+				"application/json");
+	});
 
-	return processResult(response, __func__);
+	return processResult(headers, response, __func__);
 }
 
 RequestResult SendPostRequest(const TwitchToken &token, const std::string &uri,
@@ -207,7 +577,6 @@ RequestResult SendPutRequest(const TwitchToken &token, const std::string &uri,
 			     const std::string &path,
 			     const httplib::Params &params, const OBSData &data)
 {
-	httplib::Client cli(uri);
 	auto tokenStr = token.GetToken();
 
 	if (!tokenStr) {
@@ -220,10 +589,12 @@ RequestResult SendPutRequest(const TwitchToken &token, const std::string &uri,
 
 	auto headers = getTokenRequestHeaders(*tokenStr);
 	auto body = getRequestBody(data);
-	auto response =
-		cli.Put(pathWithParams, headers, body, "application/json");
+	auto response = sendRequest(uri, [&](httplib::Client &cli) {
+		return cli.Put(pathWithParams, headers, body,
+			       "application/json");
+	});
 
-	return processResult(response, __func__);
+	return processResult(headers, response, __func__);
 }
 
 RequestResult SendPutRequest(const TwitchToken &token, const std::string &uri,
@@ -260,7 +631,6 @@ RequestResult SendPatchRequest(const TwitchToken &token, const std::string &uri,
 			       const httplib::Params &params,
 			       const OBSData &data)
 {
-	httplib::Client cli(uri);
 	auto tokenStr = token.GetToken();
 
 	if (!tokenStr) {
@@ -273,10 +643,12 @@ RequestResult SendPatchRequest(const TwitchToken &token, const std::string &uri,
 
 	auto headers = getTokenRequestHeaders(*tokenStr);
 	auto body = getRequestBody(data);
-	auto response =
-		cli.Patch(pathWithParams, headers, body, "application/json");
+	auto response = sendRequest(uri, [&](httplib::Client &cli) {
+		return cli.Patch(pathWithParams, headers, body,
+				 "application/json");
+	});
 
-	return processResult(response, __func__);
+	return processResult(headers, response, __func__);
 }
 
 RequestResult SendPatchRequest(const TwitchToken &token, const std::string &uri,
@@ -312,7 +684,6 @@ RequestResult SendDeleteRequest(const TwitchToken &token,
 				const std::string &uri, const std::string &path,
 				const httplib::Params &params)
 {
-	httplib::Client cli(uri);
 	auto tokenStr = token.GetToken();
 
 	if (!tokenStr) {
@@ -324,10 +695,12 @@ RequestResult SendDeleteRequest(const TwitchToken &token,
 	vblog(LOG_INFO, "Twitch DELETE request to %s began", url.c_str());
 
 	auto headers = getTokenRequestHeaders(*tokenStr);
-	auto response =
-		cli.Delete(pathWithParams, headers, "", "application/json");
+	auto response = sendRequest(uri, [&](httplib::Client &cli) {
+		return cli.Delete(pathWithParams, headers, "",
+				  "application/json");
+	});
 
-	return processResult(response, __func__);
+	return processResult(headers, response, __func__);
 }
 
 } // namespace advss
@@ -36,7 +36,12 @@ RequestResult SendDeleteRequest(const TwitchToken &token,
 				const httplib::Params &params = {});
 
 // These functions will cache the RequestResult for 10s
-// Note that the cache will be reported as a "memory leak" on OBS shutdown
+// Note that the POST, PUT and PATCH caches will be reported as a "memory leak"
+// on OBS shutdown
+//
+// Cached GET requests return outdated results immediately while the result is
+// refreshed in the background, so only the first request using a given set of
+// arguments will block
 RequestResult SendGetRequest(const TwitchToken &token, const std::string &uri,
 			     const std::string &path,
 			     const httplib::Params &params, bool useCache);
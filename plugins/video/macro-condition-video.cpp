@@ -1,4 +1,5 @@
 #include "macro-condition-video.hpp"
+#include "ocr-service.hpp"
 #include "screenshot-dialog.hpp"
 
 #include <layout-helpers.hpp>
@@ -123,6 +124,84 @@ bool MacroConditionVideo::CheckShouldBeSkipped()
 	return false;
 }
 
+static bool supportsFrameGating(VideoCondition condition)
+{
+	return condition == VideoCondition::PATTERN ||
+	       condition == VideoCondition::OBJECT ||
+	       condition == VideoCondition::OCR;
+}
+
+std::string MacroConditionVideo::GetAnalysisSettingsKey() const
+{
+	const auto &area = _areaParameters.area;
+	std::string key = std::to_string(static_cast<int>(_condition)) + ";" +
+			  _video.ToString(true) + ";" +
+			  std::to_string(_areaParameters.enable) + ";" +
+			  std::to_string(static_cast<int>(area.x)) + ";" +
+			  std::to_string(static_cast<int>(area.y)) + ";" +
+			  std::to_string(static_cast<int>(area.width)) + ";" +
+			  std::to_string(static_cast<int>(area.height)) + ";";
+
+	switch (_condition) {
+	case VideoCondition::PATTERN: {
+		const auto &params = _patternMatchParameters;
+		return key + std::to_string(_matchImage.cacheKey()) + ";" +
+		       std::to_string(static_cast<double>(params.threshold)) +
+		       ";" + std::to_string(params.matchMode) + ";" +
+		       std::to_string(params.useAlphaAsMask) + ";" +
+		       std::to_string(params.useCoarseToFine);
+	}
+	case VideoCondition::OBJECT: {
+		const auto &params = _objMatchParameters;
+		return key + params.modelPath + ";" +
+		       std::to_string(static_cast<double>(params.scaleFactor)) +
+		       ";" + std::to_string(params.minNeighbors) + ";" +
+		       std::to_string(static_cast<int>(params.minSize.width)) +
+		       ";" +
+		       std::to_string(static_cast<int>(params.minSize.height)) +
+		       ";" +
+		       std::to_string(static_cast<int>(params.maxSize.width)) +
+		       ";" +
+		       std::to_string(static_cast<int>(params.maxSize.height));
+	}
+	case VideoCondition::OCR: {
+		const auto &params = _ocrParameters;
+		return key + params.color.name(QColor::HexArgb).toStdString() +
+		       ";" +
+		       std::to_string(
+			       static_cast<double>(params.colorThreshold)) +
+		       ";" + params.GetLanguageCode() + ";" +
+		       std::to_string(static_cast<int>(params.GetPageMode()));
+	}
+	default:
+		break;
+	}
+	return key;
+}
+
+bool MacroConditionVideo::CanReuseAnalysisResult()
+{
+	if (!_skipUnchangedFrames || !supportsFrameGating(_condition)) {
+		return false;
+	}
+
+	// The previous result is only valid for the settings it was
+	// determined with
+	auto settingsKey = GetAnalysisSettingsKey();
+	if (settingsKey != _analysisSettingsKey) {
+		_frameChangeDetector.Reset();
+		_analysisSettingsKey = std::move(settingsKey);
+	}
+
+	if (_frameChangeDetector.Changed(_screenshotData.GetImage(),
+					 _frameChangeThreshold)) {
+		++_analyzedFrames;
+		return false;
+	}
+	++_skippedFrames;
+	return true;
+}
+
 MacroConditionVideo::MacroConditionVideo(Macro *m)
 	: QObject(),
 	  MacroCondition(m, true)
@@ -181,6 +260,9 @@ bool MacroConditionVideo::Save(obs_data_t *obj) const
 	_colorParameters.Save(obj);
 	obs_data_set_bool(obj, "throttleEnabled", _throttleEnabled);
 	obs_data_set_int(obj, "throttleCount", _throttleCount);
+	obs_data_set_bool(obj, "skipUnchangedFrames", _skipUnchangedFrames);
+	obs_data_set_double(obj, "frameChangeThreshold",
+			    _frameChangeThreshold);
 	_areaParameters.Save(obj);
 	return true;
 }
@@ -206,6 +288,11 @@ bool MacroConditionVideo::Load(obs_data_t *obj)
 	_colorParameters.Load(obj);
 	_throttleEnabled = obs_data_get_bool(obj, "throttleEnabled");
 	_throttleCount = obs_data_get_int(obj, "throttleCount");
+	_skipUnchangedFrames = obs_data_get_bool(obj, "skipUnchangedFrames");
+	if (obs_data_has_user_value(obj, "frameChangeThreshold")) {
+		_frameChangeThreshold =
+			obs_data_get_double(obj, "frameChangeThreshold");
+	}
 	_areaParameters.Load(obj);
 	if (requiresFileInput(_condition)) {
 		(void)LoadImageFromFile();
@@ -293,18 +380,19 @@ void MacroConditionVideo::SetCondition(VideoCondition condition)
 
 bool MacroConditionVideo::ScreenshotContainsPattern()
 {
-	cv::Mat result;
-	MatchPattern(_screenshotData.GetImage(), _patternImageData,
-		     _patternMatchParameters.threshold, result, nullptr,
-		     _patternMatchParameters.useAlphaAsMask,
-		     _patternMatchParameters.matchMode);
-	if (result.total() == 0) {
-		SetTempVarValue("patternCount", "0");
-		return false;
+	if (!CanReuseAnalysisResult()) {
+		cv::Mat result;
+		MatchPattern(_screenshotData.GetImage(), _patternImageData,
+			     _patternMatchParameters.threshold, result, nullptr,
+			     _patternMatchParameters.useAlphaAsMask,
+			     _patternMatchParameters.matchMode,
+			     _patternMatchParameters.useCoarseToFine);
+		_analysisResult = result.total() == 0
+					  ? "0"
+					  : std::to_string(countNonZero(result));
 	}
-	const auto count = countNonZero(result);
-	SetTempVarValue("patternCount", std::to_string(count));
-	return count > 0;
+	SetTempVarValue("patternCount", _analysisResult);
+	return _analysisResult != "0";
 }
 
 bool MacroConditionVideo::FileInputIsUpToDate() const
@@ -323,12 +411,15 @@ bool MacroConditionVideo::OutputChanged()
 		return _screenshotData.GetImage() != _matchImage;
 	}
 
+	// Only the existence of a match is relevant here, so there is no need
+	// to search for all of them
 	cv::Mat result;
 	_patternImageData = CreatePatternData(_matchImage);
 	MatchPattern(_screenshotData.GetImage(), _patternImageData,
 		     _patternMatchParameters.threshold, result, nullptr,
 		     _patternMatchParameters.useAlphaAsMask,
-		     _patternMatchParameters.matchMode);
+		     _patternMatchParameters.matchMode,
+		     _patternMatchParameters.useCoarseToFine, true);
 	if (result.total() == 0) {
 		return false;
 	}
@@ -337,15 +428,17 @@ bool MacroConditionVideo::OutputChanged()
 
 bool MacroConditionVideo::ScreenshotContainsObject()
 {
-	auto objects = MatchObject(_screenshotData.GetImage(),
-				   _objMatchParameters.cascade,
-				   _objMatchParameters.scaleFactor,
-				   _objMatchParameters.minNeighbors,
-				   _objMatchParameters.minSize.CV(),
-				   _objMatchParameters.maxSize.CV());
-	const auto count = objects.size();
-	SetTempVarValue("objectCount", std::to_string(count));
-	return count > 0;
+	if (!CanReuseAnalysisResult()) {
+		auto objects = MatchObject(_screenshotData.GetImage(),
+					   _objMatchParameters.cascade,
+					   _objMatchParameters.scaleFactor,
+					   _objMatchParameters.minNeighbors,
+					   _objMatchParameters.minSize.CV(),
+					   _objMatchParameters.maxSize.CV());
+		_analysisResult = std::to_string(objects.size());
+	}
+	SetTempVarValue("objectCount", _analysisResult);
+	return _analysisResult != "0";
 }
 
 bool MacroConditionVideo::CheckBrightnessThreshold()
@@ -362,8 +455,24 @@ bool MacroConditionVideo::CheckOCR()
 		return false;
 	}
 
-	auto text = RunOCR(_ocrParameters.GetOCR(), _screenshotData.GetImage(),
-			   _ocrParameters.color, _ocrParameters.colorThreshold);
+	// The text is recognized in the background, so the result is usually
+	// only available during one of the following checks
+	if (_ocrResult.valid() &&
+	    _ocrResult.wait_for(std::chrono::seconds(0)) ==
+		    std::future_status::ready) {
+		_analysisResult = _ocrResult.get();
+	}
+
+	// Only a single screenshot is analyzed at a time, as analyzing more
+	// screenshots than can be processed would only delay the results
+	if (!_ocrResult.valid() && !CanReuseAnalysisResult()) {
+		_ocrResult = OCRService::Instance().Submit(
+			_screenshotData.GetImage(), _ocrParameters);
+		if (_blockUntilScreenshotDone) {
+			_analysisResult = _ocrResult.get();
+		}
+	}
+	const auto &text = _analysisResult;
 	SetVariableValue(text);
 	SetTempVarValue("text", text);
 	if (!_ocrParameters.regex.Enabled()) {
@@ -1110,6 +1219,8 @@ MacroConditionVideoEdit::MacroConditionVideoEdit(
 			  "AdvSceneSwitcher.condition.video.patternThresholdDescription"))),
 	  _useAlphaAsMask(new QCheckBox(obs_module_text(
 		  "AdvSceneSwitcher.condition.video.patternThresholdUseAlphaAsMask"))),
+	  _useCoarseToFine(new QCheckBox(obs_module_text(
+		  "AdvSceneSwitcher.condition.video.patternUseCoarseToFine"))),
 	  _patternMatchModeLayout(new QHBoxLayout()),
 	  _patternMatchMode(new QComboBox()),
 	  _showMatch(new QPushButton(obs_module_text(
@@ -1122,13 +1233,19 @@ MacroConditionVideoEdit::MacroConditionVideoEdit(
 	  _area(new AreaEdit(this, &_previewDialog, entryData)),
 	  _throttleControlLayout(new QHBoxLayout),
 	  _throttleEnable(new QCheckBox()),
-	  _throttleCount(new QSpinBox())
+	  _throttleCount(new QSpinBox()),
+	  _frameGateLayout(new QHBoxLayout),
+	  _skipUnchangedFrames(new QCheckBox()),
+	  _frameChangeThreshold(new QDoubleSpinBox()),
+	  _frameGateStats(new QLabel())
 {
 	_reduceLatency->setToolTip(obs_module_text(
 		"AdvSceneSwitcher.condition.video.reduceLatency.tooltip"));
 	_imagePath->Button()->disconnect();
 	_usePatternForChangedCheck->setToolTip(obs_module_text(
 		"AdvSceneSwitcher.condition.video.usePatternForChangedCheck.tooltip"));
+	_useCoarseToFine->setToolTip(obs_module_text(
+		"AdvSceneSwitcher.condition.video.patternUseCoarseToFine.tooltip"));
 	_patternMatchMode->setToolTip(obs_module_text(
 		"AdvSceneSwitcher.condition.video.patternMatchMode.tip"));
 	populatePatternMatchModeSelection(_patternMatchMode);
@@ -1137,6 +1254,13 @@ MacroConditionVideoEdit::MacroConditionVideoEdit(
 	_throttleCount->setMaximum(10 * GetIntervalValue());
 	_throttleCount->setSingleStep(GetIntervalValue());
 
+	_frameChangeThreshold->setMinimum(0.);
+	_frameChangeThreshold->setMaximum(100.);
+	_frameChangeThreshold->setDecimals(1);
+	_frameChangeThreshold->setSuffix("%");
+	_skipUnchangedFrames->setToolTip(obs_module_text(
+		"AdvSceneSwitcher.condition.video.skipUnchangedFrames.tooltip"));
+
 	_brightness->setSizePolicy(QSizePolicy::MinimumExpanding,
 				   QSizePolicy::Preferred);
 	_ocr->setSizePolicy(QSizePolicy::MinimumExpanding,
@@ -1176,6 +1300,8 @@ MacroConditionVideoEdit::MacroConditionVideoEdit(
 		SLOT(PatternThresholdChanged(const NumberVariable<double> &)));
 	QWidget::connect(_useAlphaAsMask, SIGNAL(stateChanged(int)), this,
 			 SLOT(UseAlphaAsMaskChanged(int)));
+	QWidget::connect(_useCoarseToFine, SIGNAL(stateChanged(int)), this,
+			 SLOT(UseCoarseToFineChanged(int)));
 	QWidget::connect(_patternMatchMode, SIGNAL(currentIndexChanged(int)),
 			 this, SLOT(PatternMatchModeChanged(int)));
 
@@ -1183,6 +1309,12 @@ MacroConditionVideoEdit::MacroConditionVideoEdit(
 			 SLOT(ThrottleEnableChanged(int)));
 	QWidget::connect(_throttleCount, SIGNAL(valueChanged(int)), this,
 			 SLOT(ThrottleCountChanged(int)));
+	QWidget::connect(_skipUnchangedFrames, SIGNAL(stateChanged(int)), this,
+			 SLOT(SkipUnchangedFramesChanged(int)));
+	QWidget::connect(_frameChangeThreshold, SIGNAL(valueChanged(double)),
+			 this, SLOT(FrameChangeThresholdChanged(double)));
+	QWidget::connect(&_frameGateStatsTimer, SIGNAL(timeout()), this,
+			 SLOT(UpdateFrameGateStats()));
 	QWidget::connect(_showMatch, SIGNAL(clicked()), this,
 			 SLOT(ShowMatchClicked()));
 	QWidget::connect(this,
@@ -1205,6 +1337,7 @@ MacroConditionVideoEdit::MacroConditionVideoEdit(
 
 	_patternMatchModeLayout->setContentsMargins(0, 0, 0, 0);
 	_throttleControlLayout->setContentsMargins(0, 0, 0, 0);
+	_frameGateLayout->setContentsMargins(0, 0, 0, 0);
 
 	QHBoxLayout *entryLine1Layout = new QHBoxLayout;
 	std::unordered_map<std::string, QWidget *> widgetPlaceholders = {
@@ -1216,6 +1349,8 @@ MacroConditionVideoEdit::MacroConditionVideoEdit(
 		{"{{imagePath}}", _imagePath},
 		{"{{throttleEnable}}", _throttleEnable},
 		{"{{throttleCount}}", _throttleCount},
+		{"{{skipUnchangedFrames}}", _skipUnchangedFrames},
+		{"{{frameChangeThreshold}}", _frameChangeThreshold},
 		{"{{patternMatchingModes}}", _patternMatchMode},
 	};
 	PlaceWidgets(obs_module_text("AdvSceneSwitcher.condition.video.entry"),
@@ -1227,6 +1362,12 @@ MacroConditionVideoEdit::MacroConditionVideoEdit(
 	PlaceWidgets(obs_module_text(
 			     "AdvSceneSwitcher.condition.video.entry.throttle"),
 		     _throttleControlLayout, widgetPlaceholders);
+	PlaceWidgets(
+		obs_module_text(
+			"AdvSceneSwitcher.condition.video.entry.skipUnchangedFrames"),
+		_frameGateLayout, widgetPlaceholders, false);
+	_frameGateLayout->addWidget(_frameGateStats);
+	_frameGateLayout->addStretch();
 
 	QHBoxLayout *showMatchLayout = new QHBoxLayout;
 	showMatchLayout->addWidget(_showMatch);
@@ -1236,12 +1377,14 @@ MacroConditionVideoEdit::MacroConditionVideoEdit(
 	mainLayout->addWidget(_usePatternForChangedCheck);
 	mainLayout->addWidget(_patternThreshold);
 	mainLayout->addWidget(_useAlphaAsMask);
+	mainLayout->addWidget(_useCoarseToFine);
 	mainLayout->addLayout(_patternMatchModeLayout);
 	mainLayout->addWidget(_brightness);
 	mainLayout->addWidget(_ocr);
 	mainLayout->addWidget(_objectDetect);
 	mainLayout->addWidget(_color);
 	mainLayout->addLayout(_throttleControlLayout);
+	mainLayout->addLayout(_frameGateLayout);
 	mainLayout->addWidget(_area);
 	mainLayout->addWidget(_reduceLatency);
 	mainLayout->addLayout(showMatchLayout);
@@ -1250,6 +1393,8 @@ MacroConditionVideoEdit::MacroConditionVideoEdit(
 	_entryData = entryData;
 	UpdateEntryData();
 	_loading = false;
+
+	_frameGateStatsTimer.start(1000);
 }
 
 void MacroConditionVideoEdit::UpdatePreviewTooltip()
@@ -1475,6 +1620,14 @@ void MacroConditionVideoEdit::UseAlphaAsMaskChanged(int value)
 		_entryData->_patternMatchParameters);
 }
 
+void MacroConditionVideoEdit::UseCoarseToFineChanged(int value)
+{
+	GUARD_LOADING_AND_LOCK();
+	_entryData->_patternMatchParameters.useCoarseToFine = value;
+	_previewDialog.PatternMatchParametersChanged(
+		_entryData->_patternMatchParameters);
+}
+
 void MacroConditionVideoEdit::PatternMatchModeChanged(int idx)
 {
 	GUARD_LOADING_AND_LOCK();
@@ -1498,6 +1651,36 @@ void MacroConditionVideoEdit::ThrottleCountChanged(int value)
 	_entryData->_throttleCount = value / GetIntervalValue();
 }
 
+void MacroConditionVideoEdit::SkipUnchangedFramesChanged(int value)
+{
+	GUARD_LOADING_AND_LOCK();
+	_entryData->_skipUnchangedFrames = value;
+	_frameChangeThreshold->setEnabled(value);
+	UpdateFrameGateStats();
+}
+
+void MacroConditionVideoEdit::FrameChangeThresholdChanged(double value)
+{
+	GUARD_LOADING_AND_LOCK();
+	_entryData->_frameChangeThreshold = value / 100.;
+}
+
+void MacroConditionVideoEdit::UpdateFrameGateStats()
+{
+	if (!_entryData || !_entryData->_skipUnchangedFrames) {
+		_frameGateStats->clear();
+		return;
+	}
+
+	const uint64_t skipped = _entryData->_skippedFrames;
+	const uint64_t total = skipped + _entryData->_analyzedFrames;
+	_frameGateStats->setText(
+		QString(obs_module_text(
+				"AdvSceneSwitcher.condition.video.skipUnchangedFrames.stats"))
+			.arg(skipped)
+			.arg(total));
+}
+
 void MacroConditionVideoEdit::ShowMatchClicked()
 {
 	_previewDialog.show();
@@ -1550,6 +1733,8 @@ void MacroConditionVideoEdit::SetWidgetVisibility()
 		needsThreshold(_entryData->GetCondition()));
 	_useAlphaAsMask->setVisible(_entryData->GetCondition() ==
 				    VideoCondition::PATTERN);
+	_useCoarseToFine->setVisible(_entryData->GetCondition() ==
+				     VideoCondition::PATTERN);
 	SetLayoutVisible(_patternMatchModeLayout,
 			 _entryData->GetCondition() == VideoCondition::PATTERN);
 	_brightness->setVisible(_entryData->GetCondition() ==
@@ -1561,6 +1746,8 @@ void MacroConditionVideoEdit::SetWidgetVisibility()
 	_color->setVisible(_entryData->GetCondition() == VideoCondition::COLOR);
 	SetLayoutVisible(_throttleControlLayout,
 			 needsThrottleControls(_entryData->GetCondition()));
+	SetLayoutVisible(_frameGateLayout,
+			 supportsFrameGating(_entryData->GetCondition()));
 	_area->setVisible(needsAreaControls(_entryData->GetCondition()));
 
 	if (_entryData->GetCondition() == VideoCondition::HAS_CHANGED ||
@@ -1570,6 +1757,8 @@ void MacroConditionVideoEdit::SetWidgetVisibility()
 		SetLayoutVisible(
 			_patternMatchModeLayout,
 			_entryData->_patternMatchParameters.useForChangedCheck);
+		_useCoarseToFine->setVisible(
+			_entryData->_patternMatchParameters.useForChangedCheck);
 	}
 	Resize();
 }
@@ -1613,11 +1802,18 @@ void MacroConditionVideoEdit::UpdateEntryData()
 		_entryData->_patternMatchParameters.threshold);
 	_useAlphaAsMask->setChecked(
 		_entryData->_patternMatchParameters.useAlphaAsMask);
+	_useCoarseToFine->setChecked(
+		_entryData->_patternMatchParameters.useCoarseToFine);
 	_patternMatchMode->setCurrentIndex(_patternMatchMode->findData(
 		_entryData->_patternMatchParameters.matchMode));
 	_throttleEnable->setChecked(_entryData->_throttleEnabled);
 	_throttleCount->setValue(_entryData->_throttleCount *
 				 GetIntervalValue());
+	_skipUnchangedFrames->setChecked(_entryData->_skipUnchangedFrames);
+	_frameChangeThreshold->setValue(_entryData->_frameChangeThreshold *
+					100.);
+	_frameChangeThreshold->setEnabled(_entryData->_skipUnchangedFrames);
+	UpdateFrameGateStats();
 	UpdatePreviewTooltip();
 	SetupPreviewDialogParams();
 	SetWidgetVisibility();
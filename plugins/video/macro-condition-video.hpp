@@ -14,12 +14,16 @@
 #include <QCheckBox>
 #include <QComboBox>
 #include <QDateTime>
+#include <QDoubleSpinBox>
 #include <QGridLayout>
 #include <QHBoxLayout>
 #include <QLabel>
 #include <QObject>
 #include <QRect>
+#include <QTimer>
 #include <QWidget>
+#include <atomic>
+#include <future>
 
 namespace advss {
 
@@ -69,6 +73,11 @@ public:
 	AreaParameters _areaParameters;
 	bool _throttleEnabled = false;
 	int _throttleCount = 3;
+	// Reuse the result of the previous analysis if the video did not change
+	bool _skipUnchangedFrames = false;
+	double _frameChangeThreshold = 0.02;
+	std::atomic<uint64_t> _analyzedFrames = {0};
+	std::atomic<uint64_t> _skippedFrames = {0};
 
 signals:
 	void InputFileChanged();
@@ -84,6 +93,8 @@ private:
 	bool CheckColor();
 	bool Compare();
 	bool CheckShouldBeSkipped();
+	bool CanReuseAnalysisResult();
+	std::string GetAnalysisSettingsKey() const;
 
 	void SetupTempVars();
 
@@ -97,6 +108,11 @@ private:
 	bool _lastMatchResult = false;
 	int _runCount = 0;
 
+	FrameChangeDetector _frameChangeDetector;
+	std::string _analysisSettingsKey;
+	std::string _analysisResult;
+	std::future<std::string> _ocrResult;
+
 	double _currentBrightness = 0.;
 
 	std::string _loadedFile;
@@ -268,10 +284,14 @@ private slots:
 	void UsePatternForChangedCheckChanged(int value);
 	void PatternThresholdChanged(const NumberVariable<double> &);
 	void UseAlphaAsMaskChanged(int value);
+	void UseCoarseToFineChanged(int value);
 	void PatternMatchModeChanged(int value);
 
 	void ThrottleEnableChanged(int value);
 	void ThrottleCountChanged(int value);
+	void SkipUnchangedFramesChanged(int value);
+	void FrameChangeThresholdChanged(double value);
+	void UpdateFrameGateStats();
 	void ShowMatchClicked();
 
 	void SetWidgetVisibility();
@@ -298,6 +318,7 @@ private:
 
 	SliderSpinBox *_patternThreshold;
 	QCheckBox *_useAlphaAsMask;
+	QCheckBox *_useCoarseToFine;
 	QHBoxLayout *_patternMatchModeLayout;
 	QComboBox *_patternMatchMode;
 
@@ -314,6 +335,12 @@ private:
 	QCheckBox *_throttleEnable;
 	QSpinBox *_throttleCount;
 
+	QHBoxLayout *_frameGateLayout;
+	QCheckBox *_skipUnchangedFrames;
+	QDoubleSpinBox *_frameChangeThreshold;
+	QLabel *_frameGateStats;
+	QTimer _frameGateStatsTimer;
+
 	std::shared_ptr<MacroConditionVideo> _entryData;
 	bool _loading = true;
 };
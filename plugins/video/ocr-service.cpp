@@ -0,0 +1,180 @@
+#include "ocr-service.hpp"
+
+#include <log-helper.hpp>
+#include <plugin-state-helpers.hpp>
+
+#include <algorithm>
+
+namespace advss {
+
+// Each worker might hold an engine per language, so the number of workers is
+// kept small
+constexpr unsigned maxWorkerCount = 4;
+
+bool OCRService::_setupDone = OCRService::Setup();
+
+bool OCRService::Setup()
+{
+	AddPluginCleanupStep([]() { OCRService::Instance().Stop(); });
+	return true;
+}
+
+OCRService &OCRService::Instance()
+{
+	static OCRService service;
+	return service;
+}
+
+OCRService::~OCRService()
+{
+	Stop();
+}
+
+std::future<std::string> OCRService::Submit(const QImage &image,
+					    const OCRParameters &params)
+{
+	Job job;
+	// The image is implicitly shared, so this does not copy the pixel data
+	job.image = image;
+	job.color = params.color;
+	job.colorDiff = params.colorThreshold;
+	job.language = params.GetLanguageCode();
+	job.pageSegMode = params.GetPageMode();
+	auto result = job.result.get_future();
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (_stop) {
+		job.result.set_value("");
+		return result;
+	}
+	_jobs.emplace_back(std::move(job));
+	StartWorkers();
+	_cv.notify_one();
+	return result;
+}
+
+std::string OCRService::Run(const QImage &image, const OCRParameters &params)
+{
+	return Process(image, params.color, params.colorThreshold,
+		       params.GetLanguageCode(), params.GetPageMode());
+}
+
+void OCRService::StartWorkers()
+{
+	if (!_threads.empty()) {
+		return;
+	}
+
+	const unsigned count = std::clamp(
+		std::thread::hardware_concurrency() / 2, 1u, maxWorkerCount);
+	for (unsigned i = 0; i < count; ++i) {
+		_threads.emplace_back(&OCRService::Worker, this);
+	}
+}
+
+void OCRService::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop = true;
+	}
+	_cv.notify_all();
+	for (auto &thread : _threads) {
+		if (thread.joinable()) {
+			thread.join();
+		}
+	}
+	_threads.clear();
+
+	{
+		// Jobs which were not processed yet are completed without a
+		// result, so nobody waits for them forever
+		std::lock_guard<std::mutex> lock(_mutex);
+		for (auto &job : _jobs) {
+			job.result.set_value("");
+		}
+		_jobs.clear();
+	}
+
+	std::lock_guard<std::mutex> lock(_engineMutex);
+	_engines.clear();
+}
+
+void OCRService::Worker()
+{
+	while (true) {
+		Job job;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_cv.wait(lock,
+				 [this]() { return _stop || !_jobs.empty(); });
+			if (_stop) {
+				return;
+			}
+			job = std::move(_jobs.front());
+			_jobs.pop_front();
+		}
+
+		job.result.set_value(Process(job.image, job.color,
+					     job.colorDiff, job.language,
+					     job.pageSegMode));
+	}
+}
+
+std::string OCRService::Process(const QImage &image, const QColor &color,
+				double colorDiff, const std::string &language,
+				tesseract::PageSegMode pageSegMode)
+{
+	if (image.isNull()) {
+		return "";
+	}
+
+	auto engine = AcquireEngine(language);
+	if (!engine) {
+		return "";
+	}
+	engine->SetPageSegMode(pageSegMode);
+	auto text = RunOCR(engine.get(), image, color, colorDiff);
+	ReleaseEngine(language, std::move(engine));
+	return text;
+}
+
+OCRService::Engine OCRService::AcquireEngine(const std::string &language)
+{
+	{
+		std::lock_guard<std::mutex> lock(_engineMutex);
+		auto &engines = _engines[language];
+		if (!engines.empty()) {
+			auto engine = std::move(engines.back());
+			engines.pop_back();
+			return engine;
+		}
+	}
+
+	// No idle engine is available for this language, so a new one has to
+	// be set up, which can take a while
+	auto engine = std::make_unique<tesseract::TessBaseAPI>();
+	const std::string dataPath =
+		obs_get_module_data_path(obs_current_module()) +
+		std::string("/res/ocr");
+	if (engine->Init(dataPath.c_str(), language.c_str()) != 0) {
+		blog(LOG_WARNING,
+		     "failed to initialize OCR for language \"%s\"",
+		     language.c_str());
+		return nullptr;
+	}
+	return engine;
+}
+
+void OCRService::ReleaseEngine(const std::string &language, Engine engine)
+{
+	// Engines are not returned to the pool once it was cleared
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (_stop) {
+		return;
+	}
+	std::lock_guard<std::mutex> engineLock(_engineMutex);
+	_engines[language].emplace_back(std::move(engine));
+}
+
+} // namespace advss
@@ -0,0 +1,73 @@
+#pragma once
+#include "parameter-wrappers.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace advss {
+
+// Performs text recognition on a small pool of worker threads, so OCR does not
+// block the thread checking the macro conditions.
+//
+// Initializing a Tesseract engine is expensive and each engine uses a
+// significant amount of memory, so the engines are shared by all users and
+// kept per language once they were initialized.
+class OCRService {
+public:
+	static OCRService &Instance();
+
+	// Queues the recognition of the text in the image using the given
+	// parameters. The returned future becomes ready once the text was
+	// recognized.
+	std::future<std::string> Submit(const QImage &,
+					const OCRParameters &);
+	// Recognizes the text in the image on the calling thread
+	std::string Run(const QImage &, const OCRParameters &);
+
+private:
+	OCRService() = default;
+	~OCRService();
+
+	struct Job {
+		QImage image;
+		QColor color;
+		double colorDiff = 0.;
+		std::string language;
+		tesseract::PageSegMode pageSegMode =
+			tesseract::PSM_SINGLE_BLOCK;
+		std::promise<std::string> result;
+	};
+
+	using Engine = std::unique_ptr<tesseract::TessBaseAPI>;
+
+	void StartWorkers();
+	void Stop();
+	void Worker();
+	std::string Process(const QImage &, const QColor &, double colorDiff,
+			    const std::string &language,
+			    tesseract::PageSegMode);
+	Engine AcquireEngine(const std::string &language);
+	void ReleaseEngine(const std::string &language, Engine);
+
+	std::mutex _mutex;
+	std::condition_variable _cv;
+	std::deque<Job> _jobs;
+	std::vector<std::thread> _threads;
+	bool _stop = false;
+
+	// Always locked after _mutex if both are required
+	std::mutex _engineMutex;
+	std::unordered_map<std::string, std::vector<Engine>> _engines;
+
+	static bool _setupDone;
+	static bool Setup();
+};
+
+} // namespace advss
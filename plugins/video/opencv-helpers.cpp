@@ -2,8 +2,23 @@
 
 #include <log-helper.hpp>
 
+#include <algorithm>
+
 namespace advss {
 
+// Coarse-to-fine matching is only worth it if the downscaled pattern still
+// contains enough detail to be recognized
+constexpr int minCoarsePatternSize = 12;
+
+// Downscaling blurs the details of both the image and the pattern, so
+// positions scoring slightly below the threshold are considered as candidates
+// as well
+constexpr double coarseThresholdFactor = 0.9;
+
+// Number of rows of the match result, which are computed at once when
+// searching for the first match
+constexpr int firstMatchSearchRows = 128;
+
 PatternImageData CreatePatternData(const QImage &pattern)
 {
 	PatternImageData data{};
@@ -19,6 +34,23 @@ PatternImageData CreatePatternData(const QImage &pattern)
 	cv::merge(rgbChanlesPattern, data.rgbPattern);
 	cv::threshold(rgbaChannelsPattern[3], data.mask, 0, 255,
 		      cv::THRESH_BINARY);
+
+	for (const int scale : {4, 2}) {
+		const cv::Size size(pattern.width() / scale,
+				    pattern.height() / scale);
+		if (size.width < minCoarsePatternSize ||
+		    size.height < minCoarsePatternSize) {
+			continue;
+		}
+		data.coarseScale = scale;
+		cv::resize(data.rgbaPattern, data.coarseRgbaPattern, size, 0, 0,
+			   cv::INTER_AREA);
+		cv::resize(data.rgbPattern, data.coarseRgbPattern, size, 0, 0,
+			   cv::INTER_AREA);
+		cv::resize(data.mask, data.coarseMask, size, 0, 0,
+			   cv::INTER_NEAREST);
+		break;
+	}
 	return data;
 }
 
@@ -32,25 +64,169 @@ static void preprocessPatternMatchResult(cv::Mat &mat, bool invert)
 	// So we are clamping the values here to 0.0..1.0 and dismiss not-finite
 	// values.
 	// Invertion mode is for the TM_SQDIFF_NORMED method.
-	float value;
-	for (int r = 0; r < mat.rows; r++) {
-		for (int c = 0; c < mat.cols; c++) {
-			value = mat.at<float>(r, c);
-			if (invert) {
-				value = 1.0f - value;
-			}
-			if (!std::isfinite(value)) {
-				value = 0.0f;
-			}
-			mat.at<float>(r, c) =
-				std::fmaxf(0.0f, std::fminf(1.0f, value));
+	if (invert) {
+		cv::subtract(1.0, mat, mat);
+	}
+
+	// Comparisons involving NaN are always false, so only finite values
+	// are part of the mask
+	cv::Mat finite;
+	cv::compare(cv::abs(mat), std::numeric_limits<float>::max(), finite,
+		    cv::CMP_LE);
+	mat.setTo(0.0f, ~finite);
+	cv::min(mat, 1.0, mat);
+	cv::max(mat, 0.0, mat);
+}
+
+static void matchAndPreprocess(const cv::Mat &input, const cv::Mat &pattern,
+			       const cv::Mat &mask, bool useAlphaAsMask,
+			       cv::TemplateMatchModes matchMode,
+			       cv::Mat &result)
+{
+	if (useAlphaAsMask) {
+		cv::matchTemplate(input, pattern, result, matchMode, mask);
+	} else {
+		cv::matchTemplate(input, pattern, result, matchMode);
+	}
+
+	// A perfect match is represented as "0" for TM_SQDIFF_NORMED
+	//
+	// For TM_CCOEFF_NORMED and TM_CCORR_NORMED a perfect match is
+	// represented as "1"
+	//
+	// -> Invert TM_SQDIFF_NORMED in the preprocess step
+	preprocessPatternMatchResult(result, matchMode == cv::TM_SQDIFF_NORMED);
+}
+
+// Matches the pattern only at the positions within the given area of the
+// result and returns the best value found
+static double matchArea(const cv::Mat &input, const cv::Mat &pattern,
+			const cv::Mat &mask, bool useAlphaAsMask,
+			cv::TemplateMatchModes matchMode, const cv::Rect &area,
+			cv::Mat &result)
+{
+	const cv::Rect inputArea(area.x, area.y, area.width + pattern.cols - 1,
+				 area.height + pattern.rows - 1);
+	cv::Mat areaResult;
+	matchAndPreprocess(input(inputArea), pattern, mask, useAlphaAsMask,
+			   matchMode, areaResult);
+	areaResult.copyTo(result(area));
+
+	double bestFit = 0.;
+	cv::minMaxLoc(areaResult, nullptr, &bestFit);
+	return bestFit;
+}
+
+// Processes the image in horizontal strips to be able to stop as soon as the
+// first match is found
+static void matchUntilFirstMatch(const cv::Mat &input, const cv::Mat &pattern,
+				 const cv::Mat &mask, double threshold,
+				 bool useAlphaAsMask,
+				 cv::TemplateMatchModes matchMode,
+				 cv::Mat &result)
+{
+	result = cv::Mat::zeros(input.rows - pattern.rows + 1,
+				input.cols - pattern.cols + 1, CV_32F);
+	for (int row = 0; row < result.rows; row += firstMatchSearchRows) {
+		const cv::Rect area(0, row, result.cols,
+				    std::min(firstMatchSearchRows,
+					     result.rows - row));
+		if (matchArea(input, pattern, mask, useAlphaAsMask, matchMode,
+			      area, result) >= threshold) {
+			return;
+		}
+	}
+}
+
+// Searches for candidates in downscaled versions of the image and the pattern
+// first and only performs the full resolution matching around those.
+// Positions, which were not considered, are set to zero in the result.
+static void matchCoarseToFine(const cv::Mat &input, const cv::Mat &pattern,
+			      const PatternImageData &patternData,
+			      double threshold, bool useAlphaAsMask,
+			      cv::TemplateMatchModes matchMode,
+			      bool stopAtFirstMatch, cv::Mat &result)
+{
+	const int scale = patternData.coarseScale;
+	cv::Mat coarsePattern = patternData.coarseRgbaPattern;
+	if (useAlphaAsMask) {
+		coarsePattern = patternData.coarseRgbPattern;
+	}
+
+	cv::Mat coarseInput;
+	cv::resize(input, coarseInput,
+		   cv::Size(input.cols / scale, input.rows / scale), 0, 0,
+		   cv::INTER_AREA);
+	if (coarseInput.cols < coarsePattern.cols ||
+	    coarseInput.rows < coarsePattern.rows) {
+		matchAndPreprocess(input, pattern, patternData.mask,
+				   useAlphaAsMask, matchMode, result);
+		return;
+	}
+
+	cv::Mat coarseResult;
+	matchAndPreprocess(coarseInput, coarsePattern, patternData.coarseMask,
+			   useAlphaAsMask, matchMode, coarseResult);
+
+	cv::Mat candidates = coarseResult >= threshold * coarseThresholdFactor;
+	cv::dilate(candidates, candidates, cv::Mat());
+	cv::Mat labels, stats, centroids;
+	const int labelCount = cv::connectedComponentsWithStats(
+		candidates, labels, stats, centroids);
+
+	result = cv::Mat::zeros(input.rows - pattern.rows + 1,
+				input.cols - pattern.cols + 1, CV_32F);
+	const cv::Rect resultBounds(0, 0, result.cols, result.rows);
+
+	struct Candidate {
+		cv::Rect area;
+		double score;
+	};
+	std::vector<Candidate> regions;
+
+	// Label 0 is the background
+	for (int label = 1; label < labelCount; ++label) {
+		const cv::Rect coarseArea(
+			stats.at<int>(label, cv::CC_STAT_LEFT),
+			stats.at<int>(label, cv::CC_STAT_TOP),
+			stats.at<int>(label, cv::CC_STAT_WIDTH),
+			stats.at<int>(label, cv::CC_STAT_HEIGHT));
+		double score = 0.;
+		cv::minMaxLoc(coarseResult(coarseArea), nullptr, &score);
+
+		// Each coarse position corresponds to a block of positions in
+		// the full resolution result, which is extended by one block in
+		// each direction to account for rounding
+		const cv::Rect area((coarseArea.x - 1) * scale,
+				    (coarseArea.y - 1) * scale,
+				    (coarseArea.width + 2) * scale,
+				    (coarseArea.height + 2) * scale);
+		regions.push_back({area & resultBounds, score});
+	}
+
+	// Check the most promising regions first to find a match quickly
+	std::sort(regions.begin(), regions.end(),
+		  [](const Candidate &a, const Candidate &b) {
+			  return a.score > b.score;
+		  });
+	for (const auto &region : regions) {
+		if (region.area.empty()) {
+			continue;
+		}
+		const double bestFit =
+			matchArea(input, pattern, patternData.mask,
+				  useAlphaAsMask, matchMode, region.area,
+				  result);
+		if (stopAtFirstMatch && bestFit >= threshold) {
+			return;
 		}
 	}
 }
 
 void MatchPattern(QImage &img, const PatternImageData &patternData,
 		  double threshold, cv::Mat &result, double *pBestFitValue,
-		  bool useAlphaAsMask, cv::TemplateMatchModes matchMode)
+		  bool useAlphaAsMask, cv::TemplateMatchModes matchMode,
+		  bool useCoarseToFine, bool stopAtFirstMatch)
 {
 	result = cv::Mat(0, 0, CV_32F);
 	if (pBestFitValue) {
@@ -64,35 +240,32 @@ void MatchPattern(QImage &img, const PatternImageData &patternData,
 		return;
 	}
 
-	auto input = QImageToMat(img);
-
+	cv::Mat input = QImageToMat(img);
+	cv::Mat pattern = patternData.rgbaPattern;
 	if (useAlphaAsMask) {
 		// Remove alpha channel of input image as the alpha channel
 		// information is used as a stencil for the pattern instead and
 		// thus should not be used while matching the pattern as well
 		//
 		// Input format is Format_RGBA8888 so discard the 4th channel
-		std::vector<cv::Mat1b> inputChannels;
-		cv::split(input, inputChannels);
-		std::vector<cv::Mat1b> rgbChanlesImage(
-			inputChannels.begin(), inputChannels.begin() + 3);
-		cv::Mat3b rgbInput;
-		cv::merge(rgbChanlesImage, rgbInput);
-
-		cv::matchTemplate(rgbInput, patternData.rgbPattern, result,
-				  matchMode, patternData.mask);
-	} else {
-		cv::matchTemplate(input, patternData.rgbaPattern, result,
-				  matchMode);
+		cv::Mat rgbInput;
+		cv::cvtColor(input, rgbInput, cv::COLOR_RGBA2RGB);
+		input = rgbInput;
+		pattern = patternData.rgbPattern;
 	}
 
-	// A perfect match is represented as "0" for TM_SQDIFF_NORMED
-	//
-	// For TM_CCOEFF_NORMED and TM_CCORR_NORMED a perfect match is
-	// represented as "1"
-	//
-	// -> Invert TM_SQDIFF_NORMED in the preprocess step
-	preprocessPatternMatchResult(result, matchMode == cv::TM_SQDIFF_NORMED);
+	if (useCoarseToFine && patternData.coarseScale > 1) {
+		matchCoarseToFine(input, pattern, patternData, threshold,
+				  useAlphaAsMask, matchMode, stopAtFirstMatch,
+				  result);
+	} else if (stopAtFirstMatch) {
+		matchUntilFirstMatch(input, pattern, patternData.mask,
+				     threshold, useAlphaAsMask, matchMode,
+				     result);
+	} else {
+		matchAndPreprocess(input, pattern, patternData.mask,
+				   useAlphaAsMask, matchMode, result);
+	}
 
 	if (pBestFitValue) {
 		cv::minMaxLoc(result, nullptr, pBestFitValue);
@@ -166,39 +339,42 @@ static bool colorIsSimilar(const QColor &color1, const QColor &color2,
 cv::Mat PreprocessForOCR(const QImage &image, const QColor &textColor,
 			 double colorDiff)
 {
-	auto mat = QImageToMat(image);
+	const auto mat = QImageToMat(image);
+	if (mat.empty()) {
+		return cv::Mat();
+	}
 
 	// Tesseract works best when matching black text on a white background,
 	// so everything that matches the text color will be displayed black
 	// while the rest of the image should be white.
+	//
+	// The result is written to a separate single channel image, so the
+	// pixel data of the input image, which might be shared, is left
+	// untouched.
 	const int diff = colorDiff * 255;
-	for (int y = 0; y < image.height(); y++) {
-		for (int x = 0; x < image.width(); x++) {
-			if (colorIsSimilar(image.pixelColor(x, y), textColor,
-					   diff)) {
-				mat.at<cv::Vec4b>(y, x) = {0, 0, 0, 255};
-			} else {
-				mat.at<cv::Vec4b>(y, x) = {255, 255, 255, 255};
-			}
-		}
-	}
+	const cv::Scalar lower(textColor.red() - diff,
+			       textColor.green() - diff,
+			       textColor.blue() - diff, 0);
+	const cv::Scalar upper(textColor.red() + diff,
+			       textColor.green() + diff,
+			       textColor.blue() + diff, 255);
+	cv::Mat result;
+	cv::inRange(mat, lower, upper, result);
+	cv::bitwise_not(result, result);
 
 	// Scale image up if selected area is very small.
 	// Results will probably still be unsatisfying.
-	if (mat.rows <= 300 || mat.cols <= 300) {
+	if (result.rows <= 300 || result.cols <= 300) {
 		double scale = 0.;
-		if (mat.rows < mat.cols) {
-			scale = 300. / mat.rows;
+		if (result.rows < result.cols) {
+			scale = 300. / result.rows;
 		} else {
-			scale = 300. / mat.cols;
+			scale = 300. / result.cols;
 		}
-		cv::resize(mat, mat,
-			   cv::Size(mat.cols * scale, mat.rows * scale),
-			   cv::INTER_CUBIC);
+		cv::resize(result, result,
+			   cv::Size(result.cols * scale, result.rows * scale),
+			   0, 0, cv::INTER_CUBIC);
 	}
-
-	cv::Mat result;
-	mat.copyTo(result);
 	return result;
 }
 
@@ -213,9 +389,7 @@ std::string RunOCR(tesseract::TessBaseAPI *ocr, const QImage &image,
 	}
 
 #ifdef OCR_SUPPORT
-	auto mat = PreprocessForOCR(image, color, colorDiff);
-	cv::Mat gray;
-	cv::cvtColor(mat, gray, cv::COLOR_RGBA2GRAY);
+	const auto gray = PreprocessForOCR(image, color, colorDiff);
 	ocr->SetImage(gray.data, gray.cols, gray.rows, 1, gray.step);
 	ocr->Recognize(0);
 	std::unique_ptr<char[]> detectedText(ocr->GetUTF8Text());
@@ -307,6 +481,46 @@ QColor GetDominantColor(const QImage &img, int k)
 	return QColor();
 }
 
+bool FrameChangeDetector::Changed(const QImage &img, double threshold)
+{
+	if (img.isNull()) {
+		Reset();
+		return true;
+	}
+
+	constexpr int maxGridSize = 64;
+	const auto input = QImageToMat(img);
+	const cv::Size gridSize(std::min(input.cols, maxGridSize),
+				std::min(input.rows, maxGridSize));
+	cv::Mat blocks;
+	cv::resize(input, blocks, gridSize, 0, 0, cv::INTER_AREA);
+
+	if (img.size() != _referenceSize ||
+	    blocks.size() != _reference.size() ||
+	    blocks.type() != _reference.type()) {
+		_reference = blocks;
+		_referenceSize = img.size();
+		return true;
+	}
+
+	cv::Mat diff;
+	cv::absdiff(blocks, _reference, diff);
+	double maxDiff = 0.;
+	cv::minMaxLoc(diff.reshape(1), nullptr, &maxDiff);
+	if (maxDiff <= threshold * 255.) {
+		return false;
+	}
+
+	_reference = blocks;
+	return true;
+}
+
+void FrameChangeDetector::Reset()
+{
+	_reference.release();
+	_referenceSize = QSize();
+}
+
 // Assumption is that QImage uses Format_RGBA8888.
 // Conversion from: https://github.com/dbzhang800/QtOpenCV
 cv::Mat QImageToMat(const QImage &img)
@@ -46,12 +46,43 @@ struct PatternImageData {
 	cv::Mat4b rgbaPattern;
 	cv::Mat3b rgbPattern;
 	cv::Mat1b mask;
+
+	// Downscaled versions of the pattern used for coarse-to-fine matching.
+	// Only set if the pattern is large enough to be downscaled.
+	int coarseScale = 1;
+	cv::Mat4b coarseRgbaPattern;
+	cv::Mat3b coarseRgbPattern;
+	cv::Mat1b coarseMask;
+};
+
+// Detects changes of the video by comparing the average color of the blocks
+// of a coarse grid laid over the frames.
+// This is cheap compared to pattern matching, object detection or OCR, so it
+// can be used to decide whether those have to be performed again.
+class FrameChangeDetector {
+public:
+	// Returns true if any block differs from the reference frame by more
+	// than the threshold, which is given as a fraction of the value range.
+	// The reference frame is only replaced if a change was detected, so
+	// gradual changes are not missed.
+	bool Changed(const QImage &img, double threshold);
+	void Reset();
+
+private:
+	cv::Mat _reference;
+	QSize _referenceSize;
 };
 
 PatternImageData CreatePatternData(const QImage &pattern);
+// If useCoarseToFine is set, the pattern is first searched for in a
+// downscaled version of the image and only the most promising regions are
+// matched in full resolution.
+// If stopAtFirstMatch is set, matching stops as soon as any match was found,
+// so the result is only suitable to check if the pattern was found at all.
 void MatchPattern(QImage &img, const PatternImageData &patternData,
 		  double threshold, cv::Mat &result, double *pBestFitValue,
-		  bool useAlphaAsMask, cv::TemplateMatchModes matchMode);
+		  bool useAlphaAsMask, cv::TemplateMatchModes matchMode,
+		  bool useCoarseToFine = false, bool stopAtFirstMatch = false);
 void MatchPattern(QImage &img, QImage &pattern, double threshold,
 		  cv::Mat &result, double *pBestFitValue, bool useAlphaAsMask,
 		  cv::TemplateMatchModes matchMode);
@@ -60,6 +91,7 @@ std::vector<cv::Rect> MatchObject(QImage &img, cv::CascadeClassifier &cascade,
 				  const cv::Size &minSize,
 				  const cv::Size &maxSize);
 uchar GetAvgBrightness(QImage &img);
+// Returns a single channel image showing the text in black on white
 cv::Mat PreprocessForOCR(const QImage &image, const QColor &color,
 			 double colorDiff);
 std::string RunOCR(tesseract::TessBaseAPI *, const QImage &, const QColor &,
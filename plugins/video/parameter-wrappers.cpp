@@ -11,6 +11,7 @@ bool PatternMatchParameters::Save(obs_data_t *obj) const
 	obs_data_set_bool(data, "useForChangedCheck", useForChangedCheck);
 	threshold.Save(data, "threshold");
 	obs_data_set_bool(data, "useAlphaAsMask", useAlphaAsMask);
+	obs_data_set_bool(data, "useCoarseToFine", useCoarseToFine);
 	obs_data_set_int(data, "matchMode", matchMode);
 	obs_data_set_int(data, "version", 1);
 	obs_data_set_obj(obj, "patternMatchData", data);
@@ -36,6 +37,7 @@ bool PatternMatchParameters::Load(obs_data_t *obj)
 		threshold = obs_data_get_double(data, "threshold");
 	}
 	useAlphaAsMask = obs_data_get_bool(data, "useAlphaAsMask");
+	useCoarseToFine = obs_data_get_bool(data, "useCoarseToFine");
 	// TODO: Remove this fallback in a future version
 	if (!obs_data_has_user_value(data, "matchMode")) {
 		matchMode = cv::TM_CCORR_NORMED;
@@ -233,48 +235,18 @@ static QColor LoadColor(obs_data_t *obj, const char *name)
 	return color;
 }
 
-OCRParameters::OCRParameters()
-{
-	Setup();
-}
-
-OCRParameters::~OCRParameters()
+static bool languageDataExists(const std::string &language)
 {
-	if (!initDone) {
-		return;
-	}
-	ocr->End();
-}
-
-OCRParameters::OCRParameters(const OCRParameters &other)
-	: text(other.text),
-	  regex(other.regex),
-	  color(other.color),
-	  colorThreshold(other.colorThreshold),
-	  pageSegMode(other.pageSegMode)
-{
-	if (!initDone) {
-		Setup();
-	}
-	if (initDone) {
-		ocr->SetPageSegMode(pageSegMode);
-	}
+	const auto dataPath =
+		QString(obs_get_module_data_path(obs_current_module())) +
+		QString("/res/ocr") + "/" + QString::fromStdString(language) +
+		".traineddata";
+	return QFileInfo::exists(dataPath);
 }
 
-OCRParameters &OCRParameters::operator=(const OCRParameters &other)
+OCRParameters::OCRParameters()
 {
-	text = other.text;
-	regex = other.regex;
-	color = other.color;
-	colorThreshold = other.colorThreshold;
-	pageSegMode = other.pageSegMode;
-	if (!initDone) {
-		Setup();
-	}
-	if (initDone) {
-		ocr->SetPageSegMode(pageSegMode);
-	}
-	return *this;
+	languageAvailable = languageDataExists(languageCode);
 }
 
 bool OCRParameters::Save(obs_data_t *obj) const
@@ -307,30 +279,22 @@ bool OCRParameters::Load(obs_data_t *obj)
 		obs_data_get_int(data, "pageSegMode"));
 	obs_data_release(data);
 
-	if (initDone) {
-		ocr->SetPageSegMode(pageSegMode);
-	}
+	languageAvailable = languageDataExists(languageCode);
 	return true;
 }
 
 void OCRParameters::SetPageMode(tesseract::PageSegMode mode)
 {
 	pageSegMode = mode;
-	ocr->SetPageSegMode(mode);
 }
 
 bool OCRParameters::SetLanguageCode(const std::string &value)
 {
-	const auto dataPath =
-		QString(obs_get_module_data_path(obs_current_module())) +
-		QString("/res/ocr") + "/" + QString::fromStdString(value) +
-		".traineddata";
-	QFileInfo fileInfo(dataPath);
-	if (!fileInfo.exists(dataPath)) {
+	if (!languageDataExists(value)) {
 		return false;
 	}
-	Setup();
-	ocr->SetPageSegMode(pageSegMode);
+	languageCode = value;
+	languageAvailable = true;
 	return true;
 }
 
@@ -339,22 +303,6 @@ std::string OCRParameters::GetLanguageCode() const
 	return languageCode;
 }
 
-void OCRParameters::Setup()
-{
-	ocr = std::make_unique<tesseract::TessBaseAPI>();
-	if (!ocr) {
-		initDone = false;
-		return;
-	}
-	std::string dataPath = obs_get_module_data_path(obs_current_module()) +
-			       std::string("/res/ocr");
-	if (ocr->Init(dataPath.c_str(), languageCode.c_str()) != 0) {
-		initDone = false;
-		return;
-	}
-	initDone = true;
-}
-
 bool ColorParameters::Save(obs_data_t *obj) const
 {
 	auto data = obs_data_create();
@@ -59,6 +59,7 @@ public:
 	QImage image;
 	bool useForChangedCheck = false;
 	bool useAlphaAsMask = false;
+	bool useCoarseToFine = false;
 	cv::TemplateMatchModes matchMode = cv::TM_CCORR_NORMED;
 	NumberVariable<double> threshold = 0.999;
 };
@@ -79,22 +80,19 @@ public:
 	Size maxSize{0, 0};
 };
 
+// The OCR engines themselves are managed by the OCRService
 class OCRParameters {
 public:
 	OCRParameters();
-	~OCRParameters();
-	OCRParameters(const OCRParameters &other);
-	OCRParameters &operator=(const OCRParameters &);
 
 	bool Save(obs_data_t *obj) const;
 	bool Load(obs_data_t *obj);
 
-	bool Initialized() const { return initDone; }
+	bool Initialized() const { return languageAvailable; }
 	void SetPageMode(tesseract::PageSegMode);
 	bool SetLanguageCode(const std::string &);
 	std::string GetLanguageCode() const;
 	tesseract::PageSegMode GetPageMode() const { return pageSegMode; }
-	tesseract::TessBaseAPI *GetOCR() const { return ocr.get(); }
 
 	StringVariable text = obs_module_text("AdvSceneSwitcher.enterText");
 	RegexConfig regex = RegexConfig::PartialMatchRegexConfig();
@@ -103,11 +101,8 @@ public:
 	StringVariable languageCode = "eng";
 
 private:
-	void Setup();
-
 	tesseract::PageSegMode pageSegMode = tesseract::PSM_SINGLE_BLOCK;
-	std::unique_ptr<tesseract::TessBaseAPI> ocr;
-	bool initDone = false;
+	bool languageAvailable = false;
 };
 
 class ColorParameters {
@@ -1,4 +1,5 @@
 #include "preview-dialog.hpp"
+#include "ocr-service.hpp"
 #include "opencv-helpers.hpp"
 #include "ui-helpers.hpp"
 
@@ -322,7 +323,8 @@ void PreviewImage::MarkMatch(QImage &screenshot,
 		MatchPattern(screenshot, patternImageData,
 			     patternMatchParams.threshold, result, &matchValue,
 			     patternMatchParams.useAlphaAsMask,
-			     patternMatchParams.matchMode);
+			     patternMatchParams.matchMode,
+			     patternMatchParams.useCoarseToFine);
 		emit ValueUpdate(matchValue);
 		if (result.total() == 0 || countNonZero(result) == 0) {
 			emit StatusUpdate(obs_module_text(
@@ -351,8 +353,7 @@ void PreviewImage::MarkMatch(QImage &screenshot,
 			markObjects(screenshot, objects);
 		}
 	} else if (condition == VideoCondition::OCR) {
-		auto text = RunOCR(ocrParams.GetOCR(), screenshot,
-				   ocrParams.color, ocrParams.colorThreshold);
+		auto text = OCRService::Instance().Run(screenshot, ocrParams);
 		QString status(obs_module_text(
 			"AdvSceneSwitcher.condition.video.ocrMatchSuccess"));
 		emit StatusUpdate(status.arg(QString::fromStdString(text)));
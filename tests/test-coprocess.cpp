@@ -0,0 +1,96 @@
+#include "catch.hpp"
+
+#include <coprocess-requests.hpp>
+
+using namespace std::chrono_literals;
+
+static bool isReady(const std::future<advss::CoprocessResponse> &future)
+{
+	return future.wait_for(0s) == std::future_status::ready;
+}
+
+TEST_CASE("CoprocessRequest", "[coprocess]")
+{
+	advss::CoprocessRequest request("a\nb\r\nc", 100ms);
+	REQUIRE(request.line == "a b  c\n");
+	REQUIRE(request.deadline);
+
+	advss::CoprocessRequest unawaited("", {});
+	REQUIRE(unawaited.line == "\n");
+	REQUIRE_FALSE(unawaited.deadline);
+}
+
+TEST_CASE("CoprocessRequests", "[coprocess]")
+{
+	advss::CoprocessRequests requests;
+	requests.SetProcessId("42");
+	REQUIRE(requests.Empty());
+	REQUIRE_FALSE(requests.NextDeadline());
+
+	advss::CoprocessRequest first("first", {});
+	auto firstResponse = first.response.get_future();
+	requests.Add(std::move(first));
+	advss::CoprocessRequest second("second", 1h);
+	auto secondResponse = second.response.get_future();
+	const auto deadline = second.deadline;
+	requests.Add(std::move(second));
+	advss::CoprocessRequest third("third", 2h);
+	auto thirdResponse = third.response.get_future();
+	requests.Add(std::move(third));
+
+	// Requests nobody waits for do not time out
+	REQUIRE(requests.NextDeadline() == deadline);
+
+	requests.AppendErrorOutput("warning");
+	requests.AppendOutput("one\r\ntw");
+	REQUIRE(isReady(firstResponse));
+	REQUIRE_FALSE(isReady(secondResponse));
+	auto response = firstResponse.get();
+	REQUIRE(response.error == advss::CoprocessError::NONE);
+	REQUIRE(response.output == "one");
+	REQUIRE(response.errorOutput == "warning");
+	REQUIRE(response.processId == "42");
+
+	requests.AppendOutput("o\n");
+	response = secondResponse.get();
+	REQUIRE(response.output == "two");
+	REQUIRE(response.errorOutput.empty());
+	REQUIRE(requests.NextDeadline() > deadline);
+
+	requests.AppendOutput("incomplete");
+	requests.Fail(advss::CoprocessError::TIMEOUT);
+	REQUIRE(requests.Empty());
+	response = thirdResponse.get();
+	REQUIRE(response.error == advss::CoprocessError::TIMEOUT);
+	REQUIRE(response.output.empty());
+
+	// Output received before the failure must not answer later requests
+	advss::CoprocessRequest fourth("fourth", 1h);
+	auto fourthResponse = fourth.response.get_future();
+	requests.Add(std::move(fourth));
+	requests.AppendOutput("\n");
+	REQUIRE(fourthResponse.get().output.empty());
+
+	// Output without any open requests is kept for the next request
+	requests.AppendOutput("early\n");
+	advss::CoprocessRequest fifth("fifth", 1h);
+	auto fifthResponse = fifth.response.get_future();
+	requests.Add(std::move(fifth));
+	requests.AppendOutput("");
+	REQUIRE(fifthResponse.get().output == "early");
+}
+
+TEST_CASE("RespondToCoprocessRequests", "[coprocess]")
+{
+	std::deque<advss::CoprocessRequest> requests;
+	requests.emplace_back("a", 1s);
+	requests.emplace_back("b", std::nullopt);
+	auto first = requests[0].response.get_future();
+	auto second = requests[1].response.get_future();
+
+	advss::RespondToCoprocessRequests(
+		requests, advss::CoprocessError::FAILED_TO_START, "");
+	REQUIRE(requests.empty());
+	REQUIRE(first.get().error == advss::CoprocessError::FAILED_TO_START);
+	REQUIRE(second.get().error == advss::CoprocessError::FAILED_TO_START);
+}
@@ -0,0 +1,29 @@
+#include "catch.hpp"
+
+#include <easing.hpp>
+
+TEST_CASE("ApplyEasing", "[easing]")
+{
+	for (const auto easing :
+	     {advss::Easing::LINEAR, advss::Easing::EASE_IN,
+	      advss::Easing::EASE_OUT, advss::Easing::EASE_IN_OUT}) {
+		REQUIRE(advss::ApplyEasing(easing, 0.0) == Approx(0.0));
+		REQUIRE(advss::ApplyEasing(easing, 1.0) == Approx(1.0));
+	}
+
+	REQUIRE(advss::ApplyEasing(advss::Easing::LINEAR, 0.5) == Approx(0.5));
+	REQUIRE(advss::ApplyEasing(advss::Easing::EASE_IN, 0.5) ==
+		Approx(0.125));
+	REQUIRE(advss::ApplyEasing(advss::Easing::EASE_OUT, 0.5) ==
+		Approx(0.875));
+	REQUIRE(advss::ApplyEasing(advss::Easing::EASE_IN_OUT, 0.5) ==
+		Approx(0.5));
+	REQUIRE(advss::ApplyEasing(advss::Easing::EASE_IN_OUT, 0.25) ==
+		Approx(0.0625));
+	REQUIRE(advss::ApplyEasing(advss::Easing::EASE_IN_OUT, 0.75) ==
+		Approx(0.9375));
+
+	// Invalid values do not modify the progress
+	REQUIRE(advss::ApplyEasing(static_cast<advss::Easing>(42), 0.3) ==
+		Approx(0.3));
+}
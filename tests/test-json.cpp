@@ -51,3 +51,45 @@ TEST_CASE("MatchJson", "[json-helpers]")
 	result = advss::MatchJson("{\n    \"test\": true\n}\n", "(", regex);
 	REQUIRE(result == false);
 }
+
+TEST_CASE("JsonMatcher", "[json-helpers]")
+{
+	advss::RegexConfig regex;
+	advss::JsonMatcher matcher;
+
+	REQUIRE(matcher.Matches("{\"test\":true}", "{\n    \"test\": true\n}\n",
+				regex));
+	REQUIRE_FALSE(matcher.Matches("{\"test\":false}",
+				      "{\n    \"test\": true\n}\n", regex));
+
+	matcher.SetMode(advss::JsonMatcher::Mode::EQUAL);
+	REQUIRE(matcher.Matches("{\"a\":1,\"b\":[1,2]}",
+				"{ \"b\": [1, 2], \"a\": 1 }", regex));
+	REQUIRE_FALSE(matcher.Matches("{\"a\":1,\"b\":[2,1]}",
+				      "{ \"b\": [1, 2], \"a\": 1 }", regex));
+	REQUIRE_FALSE(matcher.Matches("abc", "{}", regex));
+	REQUIRE_FALSE(matcher.Matches("{}", "abc", regex));
+
+	matcher.SetMode(advss::JsonMatcher::Mode::SUBSET);
+	const std::string json =
+		"{\"text\":\"abc\",\"font\":{\"size\":12,\"face\":\"Arial\"},"
+		"\"items\":[{\"id\":1},{\"id\":2}]}";
+	REQUIRE(matcher.Matches(json, "{}", regex));
+	REQUIRE(matcher.Matches(json, "{\"text\":\"abc\"}", regex));
+	REQUIRE(matcher.Matches(json, "{\"font\":{\"size\":12}}", regex));
+	REQUIRE_FALSE(matcher.Matches(json, "{\"font\":{\"size\":13}}", regex));
+	REQUIRE_FALSE(matcher.Matches(json, "{\"missing\":1}", regex));
+	REQUIRE(matcher.Matches(json, "{\"/font/size\":12}", regex));
+	REQUIRE(matcher.Matches(json, "{\"$.font.face\":\"Arial\"}", regex));
+	REQUIRE(matcher.Matches(json, "{\"$.items[1].id\":2}", regex));
+	REQUIRE_FALSE(matcher.Matches(json, "{\"$.items[2].id\":2}", regex));
+
+	regex.SetEnabled(true);
+	REQUIRE(matcher.Matches(json, "{\"text\":\"a.*\"}", regex));
+	REQUIRE(matcher.Matches(json, "{\"/font/size\":\"1\\\\d\"}", regex));
+	REQUIRE_FALSE(matcher.Matches(json, "{\"text\":\"b.*\"}", regex));
+
+	// Cached results must be invalidated when the mode changes
+	matcher.SetMode(advss::JsonMatcher::Mode::EQUAL);
+	REQUIRE_FALSE(matcher.Matches(json, "{\"text\":\"b.*\"}", regex));
+}
@@ -1,6 +1,8 @@
 #include "catch.hpp"
 
 #include <math-helpers.hpp>
+#include <algorithm>
+#include <thread>
 
 TEST_CASE("Expressions are evaluated successfully", "[math-helpers]")
 {
@@ -142,3 +144,60 @@ TEST_CASE("DoubleEquals", "[math-helpers]")
 	REQUIRE_FALSE(advss::DoubleEquals(1.0, 2.0, 0.5));
 	REQUIRE_FALSE(advss::DoubleEquals(1.0, 1.0, 0.0));
 }
+
+TEST_CASE("MathExpression", "[math-helpers]")
+{
+	advss::MathExpression expression;
+	REQUIRE(expression.Compile("1 + 2"));
+	REQUIRE(expression.GetVariableNames().empty());
+	REQUIRE(*expression.Evaluate({}) == 3.0);
+
+	REQUIRE(expression.Compile("${a} * 2 + ${b} - ${a}"));
+	REQUIRE(expression.GetVariableNames() ==
+		std::vector<std::string>{"a", "b"});
+	REQUIRE(*expression.Evaluate({3.0, 1.0}) == 4.0);
+	REQUIRE(*expression.Evaluate({-1.0, 0.5}) == -0.5);
+	REQUIRE_FALSE(expression.Evaluate({1.0}));
+
+	REQUIRE_FALSE(expression.Compile("1${a}"));
+	REQUIRE_FALSE(expression.Compile("${a}${b}"));
+	REQUIRE_FALSE(expression.Compile("1 +"));
+	REQUIRE_FALSE(expression.Evaluate({}));
+
+	advss::MathExpression copy = expression;
+	REQUIRE(copy.Compile("${x} / 2"));
+	REQUIRE(*copy.Evaluate({5.0}) == 2.5);
+
+	auto getValue = [](const std::string &name) -> std::optional<double> {
+		if (name == "missing") {
+			return {};
+		}
+		return name.size();
+	};
+	REQUIRE(*expression.Evaluate("${abc} + ${d}", getValue) == 4.0);
+	REQUIRE_FALSE(expression.Evaluate("${missing} + 1", getValue));
+	REQUIRE_FALSE(expression.Evaluate("1 +", getValue));
+
+	// Each thread has to get the result of its own values
+	std::vector<std::thread> threads;
+	std::vector<int> results(8, 0);
+	for (size_t i = 0; i < results.size(); i++) {
+		threads.emplace_back([&expression, &results, i]() {
+			bool success = true;
+			for (int j = 0; j < 1000; j++) {
+				auto getIndex = [i](const std::string &) {
+					return std::optional<double>(i);
+				};
+				auto value = expression.Evaluate("${x} * 2",
+								 getIndex);
+				success = success && value && *value == i * 2.0;
+			}
+			results[i] = success;
+		});
+	}
+	for (auto &thread : threads) {
+		thread.join();
+	}
+	REQUIRE(std::all_of(results.begin(), results.end(),
+			    [](int result) { return result; }));
+}
@@ -0,0 +1,207 @@
+#include "catch.hpp"
+
+#include <osc-parser.hpp>
+#include <variable-dependencies.hpp>
+
+static std::string packet(std::initializer_list<const char *> parts)
+{
+	// Each part is padded with null bytes to a multiple of four bytes
+	std::string result;
+	for (const auto part : parts) {
+		result += part;
+		do {
+			result += '\0';
+		} while (result.size() % 4 != 0);
+	}
+	return result;
+}
+
+static std::string int32(uint32_t value)
+{
+	std::string result(4, '\0');
+	result[0] = char(value >> 24);
+	result[1] = char(value >> 16);
+	result[2] = char(value >> 8);
+	result[3] = char(value);
+	return result;
+}
+
+TEST_CASE("ParseOSCPacket", "[osc]")
+{
+	std::vector<std::string> addresses;
+	std::vector<std::vector<std::string>> arguments;
+	auto collect = [&](const advss::OSCMessageView &message) {
+		addresses.emplace_back(message.Address());
+		auto args = message.GetArguments();
+		arguments.emplace_back(args ? *args
+					    : std::vector<std::string>{"-"});
+	};
+
+	REQUIRE_FALSE(advss::ParseOSCPacket("", collect));
+	REQUIRE_FALSE(advss::ParseOSCPacket("abc", collect));
+	REQUIRE_FALSE(advss::ParseOSCPacket("/no/terminator", collect));
+
+	auto message = packet({"/cue/go", ",isTF", "text"});
+	message.insert(message.size() - 8, int32(uint32_t(-5)));
+	REQUIRE(advss::ParseOSCPacket(message, collect));
+	REQUIRE(addresses.size() == 1);
+	REQUIRE(addresses[0] == "/cue/go");
+	REQUIRE(arguments[0] ==
+		std::vector<std::string>{"-5", "text", "true", "false"});
+
+	addresses.clear();
+	arguments.clear();
+	auto first = packet({"/a", ",f"}) + int32(0x3fc00000);
+	auto second = packet({"/b/c"});
+	auto bundle = packet({"#bundle"}) + std::string(8, '\0') +
+		      int32(first.size()) + first + int32(second.size()) +
+		      second;
+	REQUIRE(advss::ParseOSCPacket(bundle, collect));
+	REQUIRE(addresses == std::vector<std::string>{"/a", "/b/c"});
+	REQUIRE(arguments[0] == std::vector<std::string>{"1.5"});
+	REQUIRE(arguments[1].empty());
+
+	auto truncated = bundle.substr(0, bundle.size() - 2);
+	REQUIRE_FALSE(advss::ParseOSCPacket(truncated, collect));
+
+	addresses.clear();
+	arguments.clear();
+	auto unsupported = packet({"/x", ",?"});
+	REQUIRE(advss::ParseOSCPacket(unsupported, collect));
+	REQUIRE(arguments[0] == std::vector<std::string>{"-"});
+}
+
+TEST_CASE("CreateOSCBundle", "[osc]")
+{
+	const std::string header = packet({"#bundle"}) +
+				   std::string(7, '\0') + std::string(1, 1);
+
+	auto empty = advss::CreateOSCBundle({});
+	REQUIRE(std::string(empty.begin(), empty.end()) == header);
+
+	// Large enough for the size prefix to use more than one byte
+	auto first = packet({"/a", ",s", std::string(300, 'x').c_str()});
+	auto second = packet({"/b/c"});
+	auto bundle = advss::CreateOSCBundle(
+		{std::vector<char>(first.begin(), first.end()),
+		 std::vector<char>(second.begin(), second.end())});
+	REQUIRE(std::string(bundle.begin(), bundle.end()) ==
+		header + int32(first.size()) + first + int32(second.size()) +
+			second);
+
+	std::vector<std::string> addresses;
+	auto collect = [&](const advss::OSCMessageView &message) {
+		addresses.emplace_back(message.Address());
+	};
+	REQUIRE(advss::ParseOSCPacket(std::string(bundle.begin(), bundle.end()),
+				      collect));
+	REQUIRE(addresses == std::vector<std::string>{"/a", "/b/c"});
+}
+
+TEST_CASE("OSCAddressPartMatches", "[osc]")
+{
+	REQUIRE(advss::OSCAddressPartMatches("fader", "fader"));
+	REQUIRE_FALSE(advss::OSCAddressPartMatches("fader", "fader1"));
+	REQUIRE(advss::OSCAddressPartMatches("fader*", "fader12"));
+	REQUIRE(advss::OSCAddressPartMatches("*", ""));
+	REQUIRE(advss::OSCAddressPartMatches("fader?", "fader1"));
+	REQUIRE_FALSE(advss::OSCAddressPartMatches("fader?", "fader"));
+	REQUIRE(advss::OSCAddressPartMatches("ch[1-4]", "ch3"));
+	REQUIRE_FALSE(advss::OSCAddressPartMatches("ch[1-4]", "ch5"));
+	REQUIRE(advss::OSCAddressPartMatches("ch[!1-4]", "ch5"));
+	REQUIRE(advss::OSCAddressPartMatches("{mute,solo}", "solo"));
+	REQUIRE_FALSE(advss::OSCAddressPartMatches("{mute,solo}", "gain"));
+	REQUIRE(advss::OSCAddressPartMatches("{a,ab}c", "abc"));
+}
+
+TEST_CASE("OSCAddressTrie", "[osc]")
+{
+	advss::OSCAddressTrie<int> trie;
+	REQUIRE(trie.Empty());
+	trie.Insert("/mixer/ch1/fader", 1);
+	trie.Insert("/mixer/*/fader", 2);
+	trie.Insert("/mixer/ch1/mute", 3);
+	trie.Insert("/mixer/ch1/fader", 4);
+
+	std::vector<int> matches;
+	auto collect = [&matches](const int &value) {
+		matches.emplace_back(value);
+	};
+
+	trie.ForEachMatch("/mixer/ch1/fader", collect);
+	std::sort(matches.begin(), matches.end());
+	REQUIRE(matches == std::vector<int>{1, 2, 4});
+
+	matches.clear();
+	trie.ForEachMatch("/mixer/ch2/fader", collect);
+	REQUIRE(matches == std::vector<int>{2});
+
+	matches.clear();
+	trie.ForEachMatch("/mixer/ch2", collect);
+	REQUIRE(matches.empty());
+
+	trie.RemoveIf([](const int &value) { return value != 3; });
+	trie.ForEachMatch("/mixer/ch1/fader", collect);
+	REQUIRE(matches.empty());
+	trie.ForEachMatch("/mixer/ch1/mute", collect);
+	REQUIRE(matches == std::vector<int>{3});
+
+	trie.RemoveIf([](const int &) { return true; });
+	REQUIRE(trie.Empty());
+}
+
+namespace {
+
+struct NamedVariable : advss::Variable {
+	NamedVariable(const std::string &name) { _name = name; }
+};
+
+} // namespace
+
+TEST_CASE("VariableDependencies", "[osc]")
+{
+	auto &variables = advss::GetVariables();
+	variables.clear();
+	auto a = std::make_shared<NamedVariable>("a");
+	auto b = std::make_shared<NamedVariable>("b");
+	variables.emplace_back(a);
+	variables.emplace_back(b);
+
+	advss::VariableDependencies dependencies;
+	dependencies.Reset();
+	dependencies.Add("/address/${a}/${missing}");
+	REQUIRE_FALSE(dependencies.Changed());
+
+	// Changes of other variables are ignored
+	b->SetValue("value");
+	REQUIRE_FALSE(dependencies.Changed());
+
+	a->SetValue("value");
+	REQUIRE(dependencies.Changed());
+
+	dependencies.Reset();
+	dependencies.Add("/address/${a}/${missing}");
+	REQUIRE_FALSE(dependencies.Changed());
+
+	// A variable with a referenced name was added
+	auto missing = std::make_shared<NamedVariable>("missing");
+	variables.emplace_back(missing);
+	REQUIRE(dependencies.Changed());
+
+	dependencies.Reset();
+	dependencies.Add("${a}");
+	dependencies.Add(std::weak_ptr<advss::Variable>(b));
+	REQUIRE_FALSE(dependencies.Changed());
+
+	// Variables which are not referenced by name are tracked as well
+	b->SetValue("other value");
+	REQUIRE(dependencies.Changed());
+
+	dependencies.Reset();
+	dependencies.Add("${a}");
+	variables.erase(variables.begin());
+	a.reset();
+	REQUIRE(dependencies.Changed());
+
+	variables.clear();
+}
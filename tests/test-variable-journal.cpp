@@ -0,0 +1,96 @@
+#include "catch.hpp"
+
+#include <variable-journal-format.hpp>
+
+TEST_CASE("ParseJournal", "[variable-journal]")
+{
+	auto journal = advss::CreateJournalHeader("id") +
+		       advss::CreateJournalRecord("a", 1, "first") +
+		       advss::CreateJournalRecord("b", 2, "second") +
+		       advss::CreateJournalRecord("a", 3, "third");
+
+	auto contents = advss::ParseJournal(journal);
+	REQUIRE(contents.id == "id");
+	REQUIRE(contents.sequence == 3);
+	REQUIRE(contents.recordCount == 3);
+	REQUIRE_FALSE(contents.truncated);
+	REQUIRE(contents.entries.size() == 2);
+	REQUIRE(contents.entries["a"].sequence == 3);
+	REQUIRE(contents.entries["a"].value == "third");
+	REQUIRE(contents.entries["b"].value == "second");
+
+	// Records which were appended out of order do not replace newer values
+	contents = advss::ParseJournal(journal +
+				       advss::CreateJournalRecord("a", 2, "x"));
+	REQUIRE(contents.entries["a"].value == "third");
+
+	auto record = advss::CreateJournalRecord("b", 4, "torn");
+	auto torn = journal + record.substr(0, record.size() / 2);
+	contents = advss::ParseJournal(torn);
+	REQUIRE(contents.truncated);
+	REQUIRE(contents.sequence == 3);
+	REQUIRE(contents.recordCount == 3);
+	REQUIRE(contents.entries["b"].value == "second");
+
+	contents = advss::ParseJournal(journal.substr(0, 4));
+	REQUIRE(contents.id.empty());
+	REQUIRE(contents.entries.empty());
+
+	contents = advss::ParseJournal("");
+	REQUIRE(contents.id.empty());
+	REQUIRE_FALSE(contents.truncated);
+}
+
+TEST_CASE("GetJournalEntriesAfter", "[variable-journal]")
+{
+	advss::JournalEntries entries = {{"a", {1, "one"}},
+					 {"b", {5, "five"}},
+					 {"c", {7, "seven"}}};
+
+	auto result = advss::GetJournalEntriesAfter(entries, 5);
+	REQUIRE(result.size() == 1);
+	REQUIRE(result["c"].value == "seven");
+
+	result = advss::GetJournalEntriesAfter(entries, 0);
+	REQUIRE(result.size() == 3);
+
+	result = advss::GetJournalEntriesAfter(entries, 7);
+	REQUIRE(result.empty());
+}
+
+TEST_CASE("CreateCompactJournal", "[variable-journal]")
+{
+	REQUIRE_FALSE(advss::JournalShouldBeCompacted(1000, 10));
+	REQUIRE(advss::JournalShouldBeCompacted(1011, 10));
+
+	std::string journal = advss::CreateJournalHeader("id");
+	for (uint64_t i = 1; i <= 100; ++i) {
+		journal += advss::CreateJournalRecord(
+			"var" + std::to_string(i % 3), i, std::to_string(i));
+	}
+	auto contents = advss::ParseJournal(journal);
+	REQUIRE(contents.recordCount == 100);
+
+	auto compacted = advss::ParseJournal(
+		advss::CreateCompactJournal(contents.id, contents.entries));
+	REQUIRE(compacted.id == "id");
+	REQUIRE(compacted.sequence == 100);
+	REQUIRE(compacted.recordCount == 3);
+	REQUIRE(compacted.entries.size() == 3);
+	REQUIRE(compacted.entries["var1"].sequence == 100);
+	REQUIRE(compacted.entries["var1"].value == "100");
+	REQUIRE(compacted.entries["var0"].value == "99");
+	REQUIRE(compacted.entries["var2"].value == "98");
+
+	// Compaction must not change which values are replayed
+	for (const uint64_t sequence : {0, 97, 98, 99, 100}) {
+		const auto expected = advss::GetJournalEntriesAfter(
+			contents.entries, sequence);
+		const auto actual = advss::GetJournalEntriesAfter(
+			compacted.entries, sequence);
+		REQUIRE(expected.size() == actual.size());
+		for (const auto &[name, entry] : expected) {
+			REQUIRE(actual.at(name).value == entry.value);
+		}
+	}
+}
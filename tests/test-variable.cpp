@@ -29,6 +29,40 @@ TEST_CASE("Variable", "[variable]")
 
 	variable.SetValue(123.123);
 	REQUIRE(variable.Value() == "123.123");
+	REQUIRE(*variable.DoubleValue() == 123.123);
+	REQUIRE_FALSE(variable.IntValue());
+
+	// The string value is lossless, so it always matches the numeric values
+	// including after parsing it again, as done when loading the variable
+	for (const double value :
+	     {1.23456789, 2.0000001, 0.1 + 0.2, -5.0, 1000000.0, 1e20}) {
+		variable.SetValue(value);
+		REQUIRE(*variable.DoubleValue() == value);
+
+		advss::Variable loaded;
+		loaded.SetValue(variable.Value());
+		REQUIRE(loaded.Value() == variable.Value());
+		REQUIRE(loaded.DoubleValue() == variable.DoubleValue());
+		REQUIRE(loaded.IntValue() == variable.IntValue());
+	}
+	variable.SetValue(1.23456789);
+	REQUIRE(variable.Value() == "1.23456789");
+	variable.SetValue(2.0000001);
+	REQUIRE(variable.Value() == "2.0000001");
+	REQUIRE_FALSE(variable.IntValue());
+	variable.SetValue(-5.0);
+	REQUIRE(variable.Value() == "-5");
+	REQUIRE(*variable.IntValue() == -5);
+
+	variable.SetValue("42");
+	REQUIRE(*variable.DoubleValue() == 42.0);
+	REQUIRE(*variable.IntValue() == 42);
+
+	variable.SetValue("not a number");
+	REQUIRE_FALSE(variable.DoubleValue());
+	REQUIRE_FALSE(variable.IntValue());
+
+	variable.SetValue(123.123);
 
 	REQUIRE(*variable.GetSecondsSinceLastUse() == 0);
 	REQUIRE(*variable.GetSecondsSinceLastChange() == 0);